@@ -138,6 +138,10 @@ namespace ChessEngine::BitboardUtil {
     constexpr Bitboard r7_Mask = r1_Mask << (8 * 6);
     constexpr Bitboard r8_Mask = r1_Mask << (8 * 7);
 
+    // Square colors , a1 is dark.
+    constexpr Bitboard darkSquares_Mask = 0xAA55AA55AA55AA55ULL;
+    constexpr Bitboard lightSquares_Mask = ~darkSquares_Mask;
+
     // Used in castling.
     constexpr Bitboard kingSideCastling_Mask = GetCastlingMask(File::F, File::G);
     constexpr Bitboard queenSideCastling_Mask = GetCastlingMask(File::B, File::D);
@@ -169,6 +173,36 @@ namespace ChessEngine::BitboardUtil {
         return GetLSBIndex(pieceBoard & kingRankMask);
     }
 
+    /*******************************************************/
+    /* Fills                                               */
+    /*******************************************************/
+
+    /* Every square up from the set squares , the squares themselves included. */
+    constexpr Bitboard FillUp(Bitboard board) {
+        board |= board << 8;
+        board |= board << 16;
+        board |= board << 32;
+        return board;
+    }
+
+    /* Every square down from the set squares , the squares themselves included. */
+    constexpr Bitboard FillDown(Bitboard board) {
+        board |= board >> 8;
+        board |= board >> 16;
+        board |= board >> 32;
+        return board;
+    }
+
+    /* The whole files of the set squares. */
+    constexpr Bitboard FillFiles(Bitboard board) {
+        return FillUp(board) | FillDown(board);
+    }
+
+    /* The squares left and right of the set squares , without wrapping around the board. */
+    constexpr Bitboard ShiftSides(Bitboard board) {
+        return ((board << 1) & not_FileA_Mask) | ((board >> 1) & not_FileH_Mask);
+    }
+
 
 }
 
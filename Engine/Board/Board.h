@@ -20,10 +20,18 @@ namespace ChessEngine {
             return state;
         }
 
+        const BoardState& GetState() const{
+            return state;
+        }
+
         BoardOccupancies& GetOccupancies(){
             return boardOccupancies;
         }
 
+        const BoardOccupancies& GetOccupancies() const{
+            return boardOccupancies;
+        }
+
     private:
 
         BoardState state;
@@ -2,6 +2,7 @@
 #define BOARD_STATE_H
 
 #include "Bitboard.h"
+#include "../Evaluation/NnueAccumulator.h"
 
 namespace ChessEngine{
 
@@ -29,6 +30,22 @@ namespace ChessEngine{
 
         GameState gameState = GameState::Playing;
 
+        // Zobrist hash of the position , kept up to date by MakeMove.
+        uint64_t hashKey = 0;
+        // Zobrist hash of the pawns only , keys the pawn hash table.
+        uint64_t pawnKey = 0;
+        // Piece counts per color and type , see Evaluation::GetMaterialDelta. Kept by MakeMove.
+        uint64_t materialKey = 0;
+
+        // Material and piece square sums from White's point of view and the game phase ,
+        // see Evaluation::AddPieceScore. Kept by MakeMove.
+        int midgameScore = 0;
+        int endgameScore = 0;
+        int phase = 0;
+
+        // Inputs of the evaluation network , only computed while one is loaded.
+        Evaluation::Nnue::Accumulator accumulator;
+
         std::tuple<PieceType, Color> GetPosType(uint8_t index) const{
             for (uint8_t i = 0; i < 12; i++) {
                 uint8_t pieceIndex = i % 6;
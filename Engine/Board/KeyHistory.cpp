@@ -0,0 +1,40 @@
+#include "KeyHistory.h"
+
+#include <algorithm>
+
+namespace ChessEngine {
+
+    void KeyHistory::Push(uint64_t key) {
+        keys.push_back(key);
+    }
+
+    void KeyHistory::Pop() {
+        keys.pop_back();
+    }
+
+    void KeyHistory::Clear() {
+        keys.clear();
+    }
+
+    void KeyHistory::Reserve(size_t count) {
+        keys.reserve(count);
+    }
+
+    size_t KeyHistory::Size() const {
+        return keys.size();
+    }
+
+    int KeyHistory::CountRepetitions(uint64_t key, int halfMoves, int count) const {
+        int size = (int) keys.size();
+        int end = std::min(halfMoves, size);
+
+        int found = 0;
+        for (int distance = 4; distance <= end && found < count; distance += 2) {
+            if (keys[size - distance] == key)
+                found++;
+        }
+
+        return found;
+    }
+
+}
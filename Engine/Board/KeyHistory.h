@@ -0,0 +1,34 @@
+#ifndef KEY_HISTORY_H
+#define KEY_HISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ChessEngine {
+
+    /* Zobrist keys of the positions before the current one , oldest first. Games push the key
+     * of every position they leave , searches do the same along the searched line. */
+    class KeyHistory {
+    public:
+        void Push(uint64_t key);
+        void Pop();
+        void Clear();
+        /* Room for count keys , searches reserve their deepest line up front so pushing never allocates. */
+        void Reserve(size_t count);
+
+        size_t Size() const;
+
+        /* Times the position appeared before. Only the last halfMoves positions can match , an
+         * irreversible move (capture , pawn move) happened before them. Positions with the other
+         * side to move and the one 2 plies back can't match either , so the scan starts 4 plies
+         * back and steps 2 plies. Stops early once count is reached. */
+        int CountRepetitions(uint64_t key, int halfMoves, int count) const;
+
+    private:
+        std::vector<uint64_t> keys;
+    };
+
+}
+
+#endif
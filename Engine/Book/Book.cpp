@@ -0,0 +1,147 @@
+#include "Book.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include "../MoveGeneration/MoveGeneration.h"
+#include "../MoveGeneration/RandomMove.h"
+#include "../Utilities/Memory.h"
+
+namespace ChessEngine::Book {
+
+    constexpr char fileMagic[8] = {'C', 'E', 'B', 'O', 'O', 'K', '\0', '\0'};
+    constexpr uint32_t fileVersion = 1;
+    constexpr size_t headerSize = 24; // Keeps the entries 8 byte aligned in the mapping.
+
+    static_assert(sizeof(BookEntry) == 24, "Book entries are stored as they are in memory");
+
+    static Memory::Mapping bookMapping;
+    static const BookEntry* bookEntries = nullptr;
+    static uint64_t bookEntryCount = 0;
+
+    /*******************************************************/
+    /* Files                                               */
+    /*******************************************************/
+
+    bool LoadBook(const std::string& path) {
+        Memory::Mapping mapping;
+        if (!Memory::MapReadOnly(path, mapping))
+            return false;
+
+        auto header = (const char*) mapping.address;
+        uint32_t version = 0;
+        uint64_t entryCount = 0;
+        if (mapping.size >= headerSize) {
+            std::memcpy(&version, header + 8, sizeof(version));
+            std::memcpy(&entryCount, header + 16, sizeof(entryCount));
+        }
+
+        if (mapping.size < headerSize || std::memcmp(header, fileMagic, sizeof(fileMagic)) != 0 ||
+            version != fileVersion || mapping.size != headerSize + entryCount * sizeof(BookEntry)) {
+            Memory::Unmap(mapping);
+            return false;
+        }
+
+        UnloadBook();
+        bookMapping = mapping;
+        bookEntries = (const BookEntry*) (header + headerSize);
+        bookEntryCount = entryCount;
+        return true;
+    }
+
+    void UnloadBook() {
+        Memory::Unmap(bookMapping);
+        bookEntries = nullptr;
+        bookEntryCount = 0;
+    }
+
+    bool IsBookLoaded() {
+        return bookEntries != nullptr;
+    }
+
+    bool SaveBook(const std::string& path, const std::vector<BookEntry>& entries) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        char header[headerSize] = {};
+        uint64_t entryCount = entries.size();
+        std::memcpy(header, fileMagic, sizeof(fileMagic));
+        std::memcpy(header + 8, &fileVersion, sizeof(fileVersion));
+        std::memcpy(header + 16, &entryCount, sizeof(entryCount));
+
+        file.write(header, headerSize);
+        file.write((const char*) entries.data(), (std::streamsize) (entries.size() * sizeof(BookEntry)));
+        return (bool) file;
+    }
+
+    /*******************************************************/
+    /* Probing                                             */
+    /*******************************************************/
+
+    std::vector<BookEntry> GetBookEntries(uint64_t key) {
+        if (!bookEntries)
+            return {};
+
+        const BookEntry* end = bookEntries + bookEntryCount;
+        const BookEntry* first = std::lower_bound(bookEntries, end, key, [](const BookEntry& entry, uint64_t value) {
+            return entry.key < value;
+        });
+
+        const BookEntry* last = first;
+        while (last != end && last->key == key)
+            last++;
+        return {first, last};
+    }
+
+    bool GetBookMove(const Board& board, const BookOptions& options, uint64_t& seed, MoveGeneration::Move& move) {
+        using namespace MoveGeneration;
+
+        const BoardState& state = board.GetState();
+        int ply = (state.fullMoves - 1) * 2 + state.turnOf;
+        if (!bookEntries || ply >= options.maxPly)
+            return false;
+
+        auto entries = GetBookEntries(state.hashKey);
+        if (entries.empty())
+            return false;
+
+        // Only moves that are valid here , another position can share the key.
+        auto validMoves = GetValidMoves(state, state.turnOf, board.GetOccupancies());
+        std::vector<std::pair<Move, double>> candidates;
+        for (auto& entry : entries) {
+            if (entry.weight == 0 || entry.wins + entry.draws + entry.losses < options.minimumGames)
+                continue;
+
+            auto found = std::find_if(validMoves.begin(), validMoves.end(), [&](const Move& valid) {
+                return PackMove(valid) == entry.move;
+            });
+            if (found != validMoves.end())
+                candidates.emplace_back(*found, std::pow((double) entry.weight, options.exponent));
+        }
+
+        if (candidates.empty())
+            return false;
+
+        if (!options.random) {
+            move = std::max_element(candidates.begin(), candidates.end(), [](auto& a, auto& b) { return a.second < b.second; })->first;
+            return true;
+        }
+
+        double total = 0.0;
+        for (auto& [candidate, weight] : candidates)
+            total += weight;
+
+        double pick = (double) (NextRandom(seed) >> 11) * 0x1.0p-53 * total;
+        for (auto& [candidate, weight] : candidates) {
+            move = candidate;
+            pick -= weight;
+            if (pick < 0.0)
+                break;
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,55 @@
+#ifndef BOOK_H
+#define BOOK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Board/Board.h"
+#include "../MoveGeneration/Move.h"
+
+namespace ChessEngine::Book {
+
+    /* An opening book , the moves played from each position of a collection of games (built by
+     * Tools/Book). The file is a 24 byte header (the magic "CEBOOK" , a version and the entry
+     * count) followed by the entries sorted by key and move. It is memory mapped and the
+     * moves of a position are found with a binary search. */
+
+    struct BookEntry {
+        uint64_t key; // BoardState::hashKey.
+        uint16_t move; // MoveGeneration::PackMove.
+        uint16_t weight; // How often the move should be picked , relative to the others of the position.
+
+        // Games the move was played in , from the point of view of the side playing it.
+        uint32_t wins;
+        uint32_t draws;
+        uint32_t losses;
+    };
+
+    struct BookOptions {
+        // Pick a move at random with a chance of weight ^ exponent , otherwise always the heaviest.
+        // Exponents above 1 favor the heavy moves even more , 0 picks uniformly.
+        bool random = true;
+        double exponent = 1.0;
+
+        uint32_t minimumGames = 1; // Moves played in fewer games are ignored.
+        int maxPly = 30; // Out of the book after this many plies of the game.
+    };
+
+    /* Replaces the loaded book , false when the file isn't a valid book. */
+    bool LoadBook(const std::string& path);
+    void UnloadBook();
+    bool IsBookLoaded();
+
+    /* entries must be sorted by key and move. */
+    bool SaveBook(const std::string& path, const std::vector<BookEntry>& entries);
+
+    /* The entries of a position , sorted by move. */
+    std::vector<BookEntry> GetBookEntries(uint64_t key);
+
+    /* A valid move of the book for the position , false when it has none. */
+    bool GetBookMove(const Board& board, const BookOptions& options, uint64_t& seed, MoveGeneration::Move& move);
+
+}
+
+#endif
@@ -0,0 +1,162 @@
+#include "Bitbase.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "../MoveGeneration/MoveTables.h"
+
+namespace ChessEngine::Evaluation {
+
+    using namespace BitboardUtil;
+    using namespace MoveGeneration::MoveTables;
+
+    // The strong side is always White here , the pawn on files A to D and ranks 2 to 7.
+    constexpr int kpkEntries = 2 * 24 * 64 * 64;
+
+    static uint64_t kpkBits[kpkEntries / 64];
+
+    static int GetIndex(Color turnOf, uint8_t blackKing, uint8_t whiteKing, uint8_t pawn) {
+        auto [file, rank] = GetCoordinates(pawn);
+        return whiteKing | (blackKing << 6) | (turnOf << 12) | (file << 13) | ((Rank::R7 - rank) << 15);
+    }
+
+    /*******************************************************/
+    /* Generation                                          */
+    /*******************************************************/
+
+    // Flags so the results of the successors can be combined with an or.
+    enum KPKResult : uint8_t {
+        Invalid = 0, Unknown = 1, Draw = 2, Win = 4
+    };
+
+    struct KPKPosition {
+        Color turnOf;
+        uint8_t kings[2]; // Use Color for indexing.
+        uint8_t pawn;
+        uint8_t result;
+    };
+
+    static int Distance(uint8_t a, uint8_t b) {
+        auto [aFile, aRank] = GetCoordinates(a);
+        auto [bFile, bRank] = GetCoordinates(b);
+        return std::max(std::abs(aFile - bFile), std::abs(aRank - bRank));
+    }
+
+    /* The results known without looking at the moves. */
+    static KPKPosition MakePosition(int index) {
+        KPKPosition position;
+        position.kings[Color::White] = index & 63;
+        position.kings[Color::Black] = (index >> 6) & 63;
+        position.turnOf = (Color) ((index >> 12) & 1);
+        position.pawn = GetSquareIndex((index >> 13) & 3, Rank::R7 - ((index >> 15) & 7));
+
+        uint8_t whiteKing = position.kings[Color::White];
+        uint8_t blackKing = position.kings[Color::Black];
+        uint8_t pawn = position.pawn;
+        Bitboard pawnAttacks = GetPawnAttacks(Color::White, pawn);
+
+        if (Distance(whiteKing, blackKing) <= 1 || whiteKing == pawn || blackKing == pawn ||
+            (position.turnOf == Color::White && GetBit(pawnAttacks, blackKing))) {
+            position.result = Invalid; // Touching kings , overlapping pieces or Black in check with White to move.
+        } else if (position.turnOf == Color::White && pawn / 8 == Rank::R7 && whiteKing != pawn + 8 && blackKing != pawn + 8 &&
+                   (Distance(blackKing, pawn + 8) > 1 || Distance(whiteKing, pawn + 8) == 1)) {
+            position.result = Win; // Promotes and the queen can't be taken.
+        } else if (position.turnOf == Color::Black &&
+                   ((GetKingMoves(blackKing) & ~(GetKingMoves(whiteKing) | pawnAttacks)) == 0 ||
+                    (GetBit(GetKingMoves(blackKing), pawn) && !GetBit(GetKingMoves(whiteKing), pawn)))) {
+            position.result = Draw; // Stalemate or the pawn is taken.
+        } else {
+            position.result = Unknown;
+        }
+        return position;
+    }
+
+    /* A white position is won when a move reaches a win , a black one is drawn when a move reaches a draw.
+     * Moves that are illegal land on invalid positions and don't count. */
+    static uint8_t Classify(const KPKPosition& position, const std::vector<KPKPosition>& positions) {
+        Color us = position.turnOf;
+        uint8_t good = (us == Color::White) ? Win : Draw;
+        uint8_t bad = (us == Color::White) ? Draw : Win;
+
+        uint8_t whiteKing = position.kings[Color::White];
+        uint8_t blackKing = position.kings[Color::Black];
+        uint8_t pawn = position.pawn;
+
+        uint8_t results = Invalid;
+        for (Bitboard moves = GetKingMoves(position.kings[us]); moves != 0; moves &= moves - 1) {
+            uint8_t target = GetLSBIndex(moves);
+            results |= (us == Color::White) ? positions[GetIndex(Color::Black, blackKing, target, pawn)].result
+                                            : positions[GetIndex(Color::White, target, whiteKing, pawn)].result;
+        }
+
+        if (us == Color::White) {
+            if (pawn / 8 < Rank::R7)
+                results |= positions[GetIndex(Color::Black, blackKing, whiteKing, pawn + 8)].result;
+            if (pawn / 8 == Rank::R2 && pawn + 8 != whiteKing && pawn + 8 != blackKing)
+                results |= positions[GetIndex(Color::Black, blackKing, whiteKing, pawn + 16)].result;
+        }
+
+        if (results & good)
+            return good;
+        return (results & Unknown) ? (uint8_t) Unknown : bad;
+    }
+
+    void InitKPKBitbase() {
+        std::vector<KPKPosition> positions(kpkEntries);
+        for (int index = 0; index < kpkEntries; index++)
+            positions[index] = MakePosition(index);
+
+        // Every pass settles the positions one move further from a known result.
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (auto& position : positions) {
+                if (position.result != Unknown)
+                    continue;
+
+                position.result = Classify(position, positions);
+                changed |= position.result != Unknown;
+            }
+        }
+
+        // What never resolved can't be forced , a draw.
+        for (int index = 0; index < kpkEntries; index++) {
+            if (positions[index].result == Win)
+                kpkBits[index / 64] |= 1ULL << (index % 64);
+            else
+                kpkBits[index / 64] &= ~(1ULL << (index % 64));
+        }
+    }
+
+    /*******************************************************/
+    /* Probing                                             */
+    /*******************************************************/
+
+    bool ProbeKPK(Color strongSide, uint8_t strongKing, uint8_t pawn, uint8_t weakKing, Color turnOf) {
+        // Seen from the strong side as White , with the pawn on the queen side.
+        if (strongSide == Color::Black) {
+            strongKing ^= 56;
+            weakKing ^= 56;
+            pawn ^= 56;
+            turnOf = InvertColor(turnOf);
+        }
+        if (pawn % 8 > File::D) {
+            strongKing ^= 7;
+            weakKing ^= 7;
+            pawn ^= 7;
+        }
+
+        int index = GetIndex(turnOf, weakKing, strongKing, pawn);
+        return (kpkBits[index / 64] >> (index % 64)) & 1;
+    }
+
+    bool ProbeKPK(const BoardState& state) {
+        Color strongSide = (state.pieceBoards[Color::White][PieceType::Pawn] != 0) ? Color::White : Color::Black;
+        Color weakSide = InvertColor(strongSide);
+        return ProbeKPK(strongSide, GetLSBIndex(state.pieceBoards[strongSide][PieceType::King]),
+                        GetLSBIndex(state.pieceBoards[strongSide][PieceType::Pawn]),
+                        GetLSBIndex(state.pieceBoards[weakSide][PieceType::King]), state.turnOf);
+    }
+
+}
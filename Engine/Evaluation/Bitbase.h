@@ -0,0 +1,23 @@
+#ifndef BITBASE_H
+#define BITBASE_H
+
+#include <cstdint>
+
+#include "../Board/BoardState.h"
+
+namespace ChessEngine::Evaluation {
+
+    /* Win or draw of every king and pawn against king position , 1 bit for each of the 24 pawn
+     * squares (files A to D , the rest are mirrored) x 64 x 64 king squares x side to move , 24 KB.
+     * Built by iterating over all the positions until their results stop changing. */
+    void InitKPKBitbase(); // Need to call at startup , after the move tables.
+
+    /* True when the side with the pawn wins , with exact play. */
+    bool ProbeKPK(Color strongSide, uint8_t strongKing, uint8_t pawn, uint8_t weakKing, Color turnOf);
+
+    /* The position must have only the kings and one pawn. */
+    bool ProbeKPK(const BoardState& state);
+
+}
+
+#endif
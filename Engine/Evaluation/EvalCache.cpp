@@ -0,0 +1,49 @@
+#include "EvalCache.h"
+
+namespace ChessEngine::Evaluation {
+
+    // The lower bits of the key select the entry , the upper 48 bits are kept to verify it.
+    constexpr uint64_t keyMask = ~(uint64_t) 0xFFFF;
+
+    EvalCache::EvalCache(size_t kilobytes) {
+        Resize(kilobytes);
+    }
+
+    void EvalCache::Resize(size_t kilobytes) {
+        // Round down to a power of 2 number of entries.
+        size_t maxEntries = kilobytes * 1024 / sizeof(uint64_t);
+        entryCount = 0;
+        if (maxEntries != 0) {
+            entryCount = 1;
+            while (entryCount * 2 <= maxEntries)
+                entryCount *= 2;
+        }
+
+        entries = std::vector<std::atomic<uint64_t>>(entryCount);
+        Clear();
+    }
+
+    void EvalCache::Clear() {
+        for (auto& entry : entries)
+            entry.store(0, std::memory_order_relaxed);
+    }
+
+    bool EvalCache::IsEnabled() const {
+        return entryCount != 0;
+    }
+
+    bool EvalCache::Probe(uint64_t key, int& score) const {
+        uint64_t entry = entries[key & (entryCount - 1)].load(std::memory_order_relaxed);
+        if ((entry & keyMask) != (key & keyMask) || entry == 0)
+            return false;
+
+        score = (int16_t) (entry & 0xFFFF);
+        return true;
+    }
+
+    void EvalCache::Store(uint64_t key, int score) {
+        uint64_t entry = (key & keyMask) | (uint16_t) (int16_t) score;
+        entries[key & (entryCount - 1)].store(entry, std::memory_order_relaxed);
+    }
+
+}
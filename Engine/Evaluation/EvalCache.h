@@ -0,0 +1,38 @@
+#ifndef EVAL_CACHE_H
+#define EVAL_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ChessEngine::Evaluation {
+
+    /* Direct mapped cache of static evaluations , separate from the transposition table
+     * so evaluations of quiescence leaves don't replace search results. An entry is a
+     * single word (the upper 48 bits of the key and a 16 bit score) , threads can share
+     * the cache without locks and never read a torn entry. */
+    class EvalCache {
+    public:
+        explicit EvalCache(size_t kilobytes);
+
+        EvalCache(const EvalCache&) = delete;
+        EvalCache& operator=(const EvalCache&) = delete;
+
+        /* Reallocate the cache , previous entries are lost. 0 disables it. */
+        void Resize(size_t kilobytes);
+        void Clear();
+
+        bool IsEnabled() const;
+
+        bool Probe(uint64_t key, int& score) const;
+        void Store(uint64_t key, int score);
+
+    private:
+        std::vector<std::atomic<uint64_t>> entries;
+        size_t entryCount = 0; // Always a power of 2 so the key can be masked.
+    };
+
+}
+
+#endif
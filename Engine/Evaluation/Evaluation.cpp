@@ -0,0 +1,43 @@
+#include "Evaluation.h"
+
+#include "PawnStructure.h"
+#include "Material.h"
+#include "PieceSquare.h"
+#include "Nnue.h"
+
+namespace ChessEngine::Evaluation {
+
+    using namespace BitboardUtil;
+
+    constexpr size_t pawnTableKilobytes = 256;
+
+    int Evaluate(const BoardState& state) {
+        MaterialEntry material = ProbeMaterial(state);
+        if (material.insufficient)
+            return 0;
+
+        // Known endgames skip the general evaluation.
+        if (material.evaluator) {
+            int score = material.evaluator(state, material.strongSide);
+            return (state.turnOf == material.strongSide) ? score : -score;
+        }
+
+        if (Nnue::IsLoaded())
+            return Nnue::Evaluate(state);
+
+        int score = GetTaperedScore(state) + material.imbalance;
+
+        // Each thread keeps its own pawn table , no locking and no need to pass it around.
+        static thread_local PawnTable pawnTable(pawnTableKilobytes);
+        score += pawnTable.Probe(state).score;
+
+        // The shield only matters while there is a queen to attack the king.
+        if (state.pieceBoards[Color::Black][PieceType::Queen] != 0)
+            score += EvaluatePawnShield(state, Color::White);
+        if (state.pieceBoards[Color::White][PieceType::Queen] != 0)
+            score -= EvaluatePawnShield(state, Color::Black);
+
+        return (state.turnOf == Color::White) ? score : -score;
+    }
+
+}
@@ -0,0 +1,17 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "../Board/BoardState.h"
+
+namespace ChessEngine::Evaluation {
+
+    // Piece values in centipawns. Use PieceType for indexing.
+    // The king is never traded so its value is irrelevant for material counting.
+    constexpr int pieceValues[7] = {0, 900, 330, 320, 500, 100, 0};
+
+    /* Static evaluation of the position from the side to move's point of view. */
+    int Evaluate(const BoardState& state);
+
+}
+
+#endif
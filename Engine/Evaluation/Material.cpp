@@ -0,0 +1,232 @@
+#include "Material.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "Evaluation.h"
+#include "Bitbase.h"
+
+namespace ChessEngine::Evaluation {
+
+    using namespace BitboardUtil;
+
+    /*******************************************************/
+    /* Material signature                                  */
+    /*******************************************************/
+
+    uint64_t GetMaterialKey(const BoardState& state) {
+        uint64_t key = 0;
+        for (int color = Color::White; color <= Color::Black; color++)
+            for (int type = PieceType::Queen; type <= PieceType::Pawn; type++)
+                key += GetBitCount(state.pieceBoards[color][type]) * GetMaterialDelta((Color) color, (PieceType) type);
+        return key;
+    }
+
+    /*******************************************************/
+    /* Endgame evaluators                                  */
+    /*******************************************************/
+
+    // Above any material difference , below the mate scores.
+    constexpr int knownWin = 2000;
+
+    static uint8_t GetKingSquare(const BoardState& state, Color color) {
+        return GetLSBIndex(state.pieceBoards[color][PieceType::King]);
+    }
+
+    static int Distance(uint8_t a, uint8_t b) {
+        auto [aFile, aRank] = GetCoordinates(a);
+        auto [bFile, bRank] = GetCoordinates(b);
+        return std::max(std::abs(aFile - bFile), std::abs(aRank - bRank));
+    }
+
+    /* 0 on the edge , 3 in the center. */
+    static int EdgeDistance(uint8_t square) {
+        auto [file, rank] = GetCoordinates(square);
+        return std::min({(int) file, 7 - file, (int) rank, 7 - rank});
+    }
+
+    /* Drive the weak king to the edge and bring the strong king next to it. */
+    static int EvaluateMating(const BoardState& state, Color strongSide, int material) {
+        uint8_t strongKing = GetKingSquare(state, strongSide);
+        uint8_t weakKing = GetKingSquare(state, InvertColor(strongSide));
+        return knownWin + material + 30 * (3 - EdgeDistance(weakKing)) + 10 * (7 - Distance(strongKing, weakKing));
+    }
+
+    static int EvaluateKQK(const BoardState& state, Color strongSide) {
+        return EvaluateMating(state, strongSide, pieceValues[PieceType::Queen]);
+    }
+
+    static int EvaluateKRK(const BoardState& state, Color strongSide) {
+        return EvaluateMating(state, strongSide, pieceValues[PieceType::Rook]);
+    }
+
+    /* The mate can only be forced in a corner of the bishop's color. */
+    static int EvaluateKBNK(const BoardState& state, Color strongSide) {
+        uint8_t strongKing = GetKingSquare(state, strongSide);
+        uint8_t weakKing = GetKingSquare(state, InvertColor(strongSide));
+
+        bool darkBishop = state.pieceBoards[strongSide][PieceType::Bishop] & darkSquares_Mask;
+        uint8_t firstCorner = darkBishop ? GetSquareIndex(File::A, Rank::R1) : GetSquareIndex(File::H, Rank::R1);
+        uint8_t secondCorner = darkBishop ? GetSquareIndex(File::H, Rank::R8) : GetSquareIndex(File::A, Rank::R8);
+        int cornerDistance = std::min(Distance(weakKing, firstCorner), Distance(weakKing, secondCorner));
+
+        int material = pieceValues[PieceType::Bishop] + pieceValues[PieceType::Knight];
+        return knownWin + material + 20 * (7 - cornerDistance) + 10 * (7 - Distance(strongKing, weakKing));
+    }
+
+    /* Exact from the bitbase , a win is scored by how far the pawn got so the search pushes it. */
+    static int EvaluateKPK(const BoardState& state, Color strongSide) {
+        if (!ProbeKPK(state))
+            return 0;
+
+        uint8_t pawn = GetLSBIndex(state.pieceBoards[strongSide][PieceType::Pawn]);
+        auto [file, rank] = GetCoordinates(pawn);
+        int relativeRank = (strongSide == Color::White) ? rank : Rank::R8 - rank;
+        return knownWin + pieceValues[PieceType::Pawn] + 20 * relativeRank;
+    }
+
+    /*******************************************************/
+    /* Material table                                      */
+    /*******************************************************/
+
+    // Counts covered by the table , per color. Indexed by PieceType (the king is always 1).
+    constexpr int maxCounts[6] = {1, 1, 2, 2, 2, 8};
+    constexpr int sideEntries = 2 * 3 * 3 * 3 * 9;
+
+    static std::vector<MaterialEntry> materialTable;
+
+    using PieceCounts = int[2][6];
+
+    static bool IsBareKing(const PieceCounts& counts, Color color) {
+        for (int type = PieceType::Queen; type <= PieceType::Pawn; type++)
+            if (counts[color][type] != 0)
+                return false;
+        return true;
+    }
+
+    /* The strong side has exactly these pieces besides its king. */
+    static bool HasExactly(const PieceCounts& counts, Color color, std::initializer_list<PieceType> pieces) {
+        int expected[6] = {};
+        for (auto type : pieces)
+            expected[type]++;
+
+        for (int type = PieceType::Queen; type <= PieceType::Pawn; type++)
+            if (counts[color][type] != expected[type])
+                return false;
+        return true;
+    }
+
+    static EndgameEvaluator FindEndgame(const PieceCounts& counts, Color strongSide) {
+        if (!IsBareKing(counts, InvertColor(strongSide)))
+            return nullptr;
+
+        if (HasExactly(counts, strongSide, {PieceType::Queen}))
+            return EvaluateKQK;
+        if (HasExactly(counts, strongSide, {PieceType::Rook}))
+            return EvaluateKRK;
+        if (HasExactly(counts, strongSide, {PieceType::Bishop, PieceType::Knight}))
+            return EvaluateKBNK;
+        if (HasExactly(counts, strongSide, {PieceType::Pawn}))
+            return EvaluateKPK;
+        return nullptr;
+    }
+
+    static MaterialEntry ComputeEntry(const PieceCounts& counts) {
+        MaterialEntry entry;
+
+        int imbalance = 0;
+        for (int color = Color::White; color <= Color::Black; color++) {
+            const int* own = counts[color];
+            int colorScore = 0;
+            int extraPawns = own[PieceType::Pawn] - 5;
+            colorScore += own[PieceType::Knight] * knightPawnBonus * extraPawns;
+            colorScore -= own[PieceType::Rook] * rookPawnPenalty * extraPawns;
+            if (own[PieceType::Bishop] >= 2)
+                colorScore += bishopPairBonus;
+
+            imbalance += (color == Color::White) ? colorScore : -colorScore;
+        }
+
+        entry.imbalance = (int16_t) imbalance;
+
+        int majors = 0, knights = 0, bishops = 0;
+        for (int color = Color::White; color <= Color::Black; color++) {
+            majors += counts[color][PieceType::Queen] + counts[color][PieceType::Rook] + counts[color][PieceType::Pawn];
+            knights += counts[color][PieceType::Knight];
+            bishops += counts[color][PieceType::Bishop];
+        }
+
+        // A lone minor can't mate , neither can any number of bishops on one color.
+        entry.insufficient = majors == 0 && knights + bishops <= 1;
+        entry.bishopsOnly = majors == 0 && knights == 0 && bishops >= 2;
+
+        for (int color = Color::White; color <= Color::Black && !entry.evaluator; color++) {
+            entry.evaluator = FindEndgame(counts, (Color) color);
+            entry.strongSide = entry.evaluator ? (Color) color : Color::Both;
+        }
+
+        return entry;
+    }
+
+    /* Mixed radix index of the counts of one color , -1 when the table doesn't cover them. */
+    static int GetSideIndex(uint64_t materialKey, Color color) {
+        int index = 0;
+        for (int type = PieceType::Pawn; type >= PieceType::Queen; type--) {
+            int count = GetPieceCount(materialKey, color, (PieceType) type);
+            if (count > maxCounts[type])
+                return -1;
+            index = index * (maxCounts[type] + 1) + count;
+        }
+        return index;
+    }
+
+    void InitMaterialTable() {
+        materialTable.resize(sideEntries * sideEntries);
+
+        // Walk every combination of counts , the key is built the way MakeMove would build it.
+        int limits[2][6] = {};
+        for (int color = Color::White; color <= Color::Black; color++)
+            for (int type = PieceType::Queen; type <= PieceType::Pawn; type++)
+                limits[color][type] = maxCounts[type] + 1;
+
+        PieceCounts counts = {};
+        while (true) {
+            uint64_t key = 0;
+            for (int color = Color::White; color <= Color::Black; color++)
+                for (int type = PieceType::Queen; type <= PieceType::Pawn; type++)
+                    key += counts[color][type] * GetMaterialDelta((Color) color, (PieceType) type);
+
+            int index = GetSideIndex(key, Color::White) * sideEntries + GetSideIndex(key, Color::Black);
+            materialTable[index] = ComputeEntry(counts);
+
+            // Next combination , like incrementing a number digit by digit.
+            int color = Color::White, type = PieceType::Queen;
+            while (color <= Color::Black) {
+                if (++counts[color][type] < limits[color][type])
+                    break;
+                counts[color][type] = 0;
+                if (++type > PieceType::Pawn) {
+                    type = PieceType::Queen;
+                    color++;
+                }
+            }
+            if (color > Color::Black)
+                break;
+        }
+    }
+
+    MaterialEntry ProbeMaterial(const BoardState& state) {
+        int whiteIndex = GetSideIndex(state.materialKey, Color::White);
+        int blackIndex = GetSideIndex(state.materialKey, Color::Black);
+        if (whiteIndex >= 0 && blackIndex >= 0)
+            return materialTable[whiteIndex * sideEntries + blackIndex];
+
+        PieceCounts counts = {};
+        for (int color = Color::White; color <= Color::Black; color++)
+            for (int type = PieceType::Queen; type <= PieceType::Pawn; type++)
+                counts[color][type] = GetPieceCount(state.materialKey, (Color) color, (PieceType) type);
+        return ComputeEntry(counts);
+    }
+
+}
@@ -0,0 +1,55 @@
+#ifndef MATERIAL_H
+#define MATERIAL_H
+
+#include <cstdint>
+
+#include "../Board/BoardState.h"
+
+namespace ChessEngine::Evaluation {
+
+    /* The material signature (BoardState::materialKey) packs the piece count of every
+     * color and type except the king in 4 bits , so MakeMove keeps it up to date by adding
+     * or subtracting the delta of the piece that was captured or promoted. */
+
+    constexpr uint64_t GetMaterialDelta(Color color, PieceType type) {
+        return 1ULL << (4 * (color * 6 + type));
+    }
+
+    constexpr int GetPieceCount(uint64_t materialKey, Color color, PieceType type) {
+        return (int) (materialKey >> (4 * (color * 6 + type))) & 0xF;
+    }
+
+    /* Count the pieces from scratch.
+     * NOTE: Should only be used on initialization , MakeMove keeps the key updated. */
+    uint64_t GetMaterialKey(const BoardState& state);
+
+    constexpr int bishopPairBonus = 30;
+    // Knights gain and rooks lose value with every pawn above 5 (and the opposite below).
+    constexpr int knightPawnBonus = 6;
+    constexpr int rookPawnPenalty = 12;
+
+    /* Specialized evaluator for an endgame against a bare king (KBNK , KRK , KQK , KPK).
+     * Returns the score of the strong side , from its point of view. */
+    using EndgameEvaluator = int (*)(const BoardState& state, Color strongSide);
+
+    struct MaterialEntry {
+        // Bishop pair , knights and rooks by pawn count , from White's point of view.
+        // The material itself is part of the piece square sums.
+        int16_t imbalance = 0;
+
+        bool insufficient = false; // Neither side can mate.
+        bool bishopsOnly = false; // Only bishops left , insufficient when they are all on squares of one color.
+
+        EndgameEvaluator evaluator = nullptr; // Replaces the general evaluation when set.
+        Color strongSide = Color::Both;
+    };
+
+    void InitMaterialTable(); // Need to call at startup.
+
+    /* The precomputed entry of the position's material. Positions with more pieces than the
+     * table covers (a second queen , a third rook ...) get an entry computed on the spot. */
+    MaterialEntry ProbeMaterial(const BoardState& state);
+
+}
+
+#endif
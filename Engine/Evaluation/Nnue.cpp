@@ -0,0 +1,326 @@
+#include "Nnue.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <new>
+
+#include "../Utilities/Memory.h"
+
+#if defined(__AVX2__)
+#define NNUE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#define NNUE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace ChessEngine::Evaluation::Nnue {
+
+    using namespace BitboardUtil;
+
+    constexpr char fileMagic[8] = "CENNUE";
+    constexpr uint32_t fileVersion = 1;
+
+    // The network in use. The feature weights are the large part (10 MB) and get huge pages when they can.
+    static Memory::Mapping weightsMapping;
+    static int16_t* featureWeights = nullptr;
+    alignas(32) static int16_t featureBiases[hiddenSize];
+    alignas(32) static int8_t outputWeights[2 * hiddenSize];
+    alignas(32) static int16_t wideOutputWeights[2 * hiddenSize]; // For the kernels without 8 bit multiplies.
+    static int32_t outputBias = 0;
+
+    static uint32_t networkId = 0; // 0 without a network.
+    static uint32_t lastNetworkId = 0;
+
+    /*******************************************************/
+    /* Kernels                                             */
+    /*******************************************************/
+
+    /* accumulator += added rows - removed rows , the accumulator is loaded and stored once. */
+    static void ApplyRows(int16_t* accumulator, const int* added, int addedCount, const int* removed, int removedCount) {
+#if defined(NNUE_AVX2)
+        for (int i = 0; i < hiddenSize; i += 16) {
+            __m256i values = _mm256_load_si256((const __m256i*) (accumulator + i));
+            for (int j = 0; j < addedCount; j++)
+                values = _mm256_add_epi16(values, _mm256_load_si256((const __m256i*) (featureWeights + added[j] * hiddenSize + i)));
+            for (int j = 0; j < removedCount; j++)
+                values = _mm256_sub_epi16(values, _mm256_load_si256((const __m256i*) (featureWeights + removed[j] * hiddenSize + i)));
+            _mm256_store_si256((__m256i*) (accumulator + i), values);
+        }
+#elif defined(NNUE_SSE2)
+        for (int i = 0; i < hiddenSize; i += 8) {
+            __m128i values = _mm_load_si128((const __m128i*) (accumulator + i));
+            for (int j = 0; j < addedCount; j++)
+                values = _mm_add_epi16(values, _mm_load_si128((const __m128i*) (featureWeights + added[j] * hiddenSize + i)));
+            for (int j = 0; j < removedCount; j++)
+                values = _mm_sub_epi16(values, _mm_load_si128((const __m128i*) (featureWeights + removed[j] * hiddenSize + i)));
+            _mm_store_si128((__m128i*) (accumulator + i), values);
+        }
+#else
+        for (int j = 0; j < addedCount; j++) {
+            const int16_t* row = featureWeights + added[j] * hiddenSize;
+            for (int i = 0; i < hiddenSize; i++)
+                accumulator[i] = (int16_t) (accumulator[i] + row[i]);
+        }
+        for (int j = 0; j < removedCount; j++) {
+            const int16_t* row = featureWeights + removed[j] * hiddenSize;
+            for (int i = 0; i < hiddenSize; i++)
+                accumulator[i] = (int16_t) (accumulator[i] - row[i]);
+        }
+#endif
+    }
+
+    /* Dot product of the clipped accumulator ([0 , activationScale]) with half of the output weights. */
+    static int32_t OutputDot(const int16_t* accumulator, int weightOffset) {
+#if defined(NNUE_AVX2)
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i maxActivation = _mm256_set1_epi16(activationScale);
+        const __m256i ones = _mm256_set1_epi16(1);
+
+        __m256i sum = _mm256_setzero_si256();
+        for (int i = 0; i < hiddenSize; i += 32) {
+            __m256i low = _mm256_load_si256((const __m256i*) (accumulator + i));
+            __m256i high = _mm256_load_si256((const __m256i*) (accumulator + i + 16));
+            low = _mm256_min_epi16(_mm256_max_epi16(low, zero), maxActivation);
+            high = _mm256_min_epi16(_mm256_max_epi16(high, zero), maxActivation);
+
+            // Packing works per 128 bit lane , put the 64 bit blocks back in order.
+            __m256i activations = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+            __m256i weights = _mm256_load_si256((const __m256i*) (outputWeights + weightOffset + i));
+            __m256i products = _mm256_maddubs_epi16(activations, weights); // At most 2 * 127 * 127 , no saturation.
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+        }
+
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+        return _mm_cvtsi128_si32(half);
+#elif defined(NNUE_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i maxActivation = _mm_set1_epi16(activationScale);
+
+        __m128i sum = _mm_setzero_si128();
+        for (int i = 0; i < hiddenSize; i += 8) {
+            __m128i activations = _mm_load_si128((const __m128i*) (accumulator + i));
+            activations = _mm_min_epi16(_mm_max_epi16(activations, zero), maxActivation);
+            __m128i weights = _mm_load_si128((const __m128i*) (wideOutputWeights + weightOffset + i));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(activations, weights));
+        }
+
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+        return _mm_cvtsi128_si32(sum);
+#else
+        int32_t sum = 0;
+        for (int i = 0; i < hiddenSize; i++) {
+            int activation = std::clamp<int>(accumulator[i], 0, activationScale);
+            sum += activation * wideOutputWeights[weightOffset + i];
+        }
+        return sum;
+#endif
+    }
+
+    std::string GetKernelName() {
+#if defined(NNUE_AVX2)
+        return "avx2";
+#elif defined(NNUE_SSE2)
+        return "sse2";
+#else
+        return "scalar";
+#endif
+    }
+
+    /*******************************************************/
+    /* Network                                             */
+    /*******************************************************/
+
+    void SetNetwork(const Network& network) {
+        if (!weightsMapping.address) {
+            size_t size = (size_t) featureCount * hiddenSize * sizeof(int16_t);
+            if (!Memory::Allocate(size, Memory::GetOptions().hugePages, weightsMapping))
+                throw std::bad_alloc();
+            featureWeights = (int16_t*) weightsMapping.address;
+        }
+
+        std::memcpy(featureWeights, network.featureWeights.data(), (size_t) featureCount * hiddenSize * sizeof(int16_t));
+        std::memcpy(featureBiases, network.featureBiases.data(), sizeof(featureBiases));
+        std::memcpy(outputWeights, network.outputWeights.data(), sizeof(outputWeights));
+        for (int i = 0; i < 2 * hiddenSize; i++)
+            wideOutputWeights[i] = outputWeights[i];
+        outputBias = network.outputBias;
+
+        // Accumulators of the previous network are recomputed the next time they are used.
+        networkId = ++lastNetworkId;
+    }
+
+    void ClearNetwork() {
+        Memory::Unmap(weightsMapping);
+        featureWeights = nullptr;
+        networkId = 0;
+    }
+
+    bool IsLoaded() {
+        return networkId != 0;
+    }
+
+    bool LoadNetwork(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+
+        char magic[8] = {};
+        uint32_t header[3] = {};
+        file.read(magic, sizeof(magic));
+        file.read((char*) header, sizeof(header));
+        if (!file || std::memcmp(magic, fileMagic, sizeof(magic)) != 0 ||
+            header[0] != fileVersion || header[1] != featureCount || header[2] != hiddenSize)
+            return false;
+
+        Network network;
+        network.featureBiases.resize(hiddenSize);
+        network.featureWeights.resize((size_t) featureCount * hiddenSize);
+        network.outputWeights.resize(2 * hiddenSize);
+
+        file.read((char*) network.featureBiases.data(), hiddenSize * sizeof(int16_t));
+        file.read((char*) network.featureWeights.data(), (std::streamsize) network.featureWeights.size() * sizeof(int16_t));
+        file.read((char*) network.outputWeights.data(), 2 * hiddenSize);
+        file.read((char*) &network.outputBias, sizeof(network.outputBias));
+        if (!file)
+            return false;
+
+        SetNetwork(network);
+        return true;
+    }
+
+    bool SaveNetwork(const std::string& path, const Network& network) {
+        if (network.featureBiases.size() != hiddenSize ||
+            network.featureWeights.size() != (size_t) featureCount * hiddenSize ||
+            network.outputWeights.size() != 2 * hiddenSize)
+            return false;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        const uint32_t header[3] = {fileVersion, featureCount, hiddenSize};
+        file.write(fileMagic, sizeof(fileMagic));
+        file.write((const char*) header, sizeof(header));
+        file.write((const char*) network.featureBiases.data(), hiddenSize * sizeof(int16_t));
+        file.write((const char*) network.featureWeights.data(), (std::streamsize) network.featureWeights.size() * sizeof(int16_t));
+        file.write((const char*) network.outputWeights.data(), 2 * hiddenSize);
+        file.write((const char*) &network.outputBias, sizeof(network.outputBias));
+        return (bool) file;
+    }
+
+    /*******************************************************/
+    /* Features                                            */
+    /*******************************************************/
+
+    int GetFeatureIndex(Color perspective, uint8_t kingSquare, Color color, PieceType type, uint8_t squareIndex) {
+        // Black sees the board flipped , its pieces are the "own" ones.
+        uint8_t flip = (perspective == Color::White) ? 0 : 56;
+        int piece = (type - PieceType::Queen) + (color == perspective ? 0 : 5);
+        return (kingSquare ^ flip) * 640 + piece * 64 + (squareIndex ^ flip);
+    }
+
+    int GetActiveFeatures(const BoardState& state, Color perspective, int* features) {
+        uint8_t kingSquare = GetLSBIndex(state.pieceBoards[perspective][PieceType::King]);
+
+        int count = 0;
+        for (int color = Color::White; color <= Color::Black; color++) {
+            for (int type = PieceType::Queen; type <= PieceType::Pawn; type++) {
+                Bitboard pieces = state.pieceBoards[color][type];
+                while (pieces != 0 && count < maxActiveFeatures) {
+                    uint8_t squareIndex = GetLSBIndex(pieces);
+                    features[count++] = GetFeatureIndex(perspective, kingSquare, (Color) color, (PieceType) type, squareIndex);
+                    pieces = PopBit(pieces, squareIndex);
+                }
+            }
+        }
+
+        return count;
+    }
+
+    /*******************************************************/
+    /* Accumulators                                        */
+    /*******************************************************/
+
+    static void RefreshPerspective(const BoardState& state, Accumulator& accumulator, Color perspective) {
+        int features[maxActiveFeatures];
+        int count = GetActiveFeatures(state, perspective, features);
+
+        std::memcpy(accumulator.values[perspective], featureBiases, sizeof(featureBiases));
+        ApplyRows(accumulator.values[perspective], features, count, nullptr, 0);
+    }
+
+    void RefreshAccumulator(BoardState& state) {
+        if (!IsLoaded())
+            return;
+
+        RefreshPerspective(state, state.accumulator, Color::White);
+        RefreshPerspective(state, state.accumulator, Color::Black);
+        state.accumulator.network = networkId;
+    }
+
+    void UpdateAccumulator(BoardState& state, const Bitboard (&previous)[2][6]) {
+        if (!IsLoaded())
+            return;
+
+        // The position before the move wasn't computed (or with another network).
+        if (state.accumulator.network != networkId) {
+            RefreshAccumulator(state);
+            return;
+        }
+
+        for (int perspective = Color::White; perspective <= Color::Black; perspective++) {
+            Bitboard king = state.pieceBoards[perspective][PieceType::King];
+            if (king != previous[perspective][PieceType::King]) {
+                RefreshPerspective(state, state.accumulator, (Color) perspective);
+                continue;
+            }
+
+            // At most 2 pieces leave and 2 land (castling , promotion with a capture).
+            int added[4], removed[4];
+            int addedCount = 0, removedCount = 0;
+            uint8_t kingSquare = GetLSBIndex(king);
+            for (int color = Color::White; color <= Color::Black; color++) {
+                for (int type = PieceType::Queen; type <= PieceType::Pawn; type++) {
+                    Bitboard before = previous[color][type];
+                    Bitboard after = state.pieceBoards[color][type];
+                    if (before == after)
+                        continue;
+
+                    for (Bitboard gone = before & ~after; gone != 0; gone &= gone - 1)
+                        removed[removedCount++] = GetFeatureIndex((Color) perspective, kingSquare, (Color) color, (PieceType) type, GetLSBIndex(gone));
+                    for (Bitboard landed = after & ~before; landed != 0; landed &= landed - 1)
+                        added[addedCount++] = GetFeatureIndex((Color) perspective, kingSquare, (Color) color, (PieceType) type, GetLSBIndex(landed));
+                }
+            }
+
+            ApplyRows(state.accumulator.values[perspective], added, addedCount, removed, removedCount);
+        }
+    }
+
+    static int GetOutput(const Accumulator& accumulator, Color us) {
+        int32_t output = OutputDot(accumulator.values[us], 0) +
+                         OutputDot(accumulator.values[InvertColor(us)], hiddenSize) + outputBias;
+
+        // Kept well inside the 16 bit scores of the caches and below the mate scores.
+        int score = (int) ((int64_t) output * evalScale / (activationScale * weightScale));
+        return std::clamp(score, -10000, 10000);
+    }
+
+    int Evaluate(const BoardState& state) {
+        // A position set up before the network was loaded is computed on the spot.
+        if (state.accumulator.network != networkId) {
+            Accumulator fresh;
+            RefreshPerspective(state, fresh, Color::White);
+            RefreshPerspective(state, fresh, Color::Black);
+            return GetOutput(fresh, state.turnOf);
+        }
+
+        return GetOutput(state.accumulator, state.turnOf);
+    }
+
+}
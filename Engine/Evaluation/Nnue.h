@@ -0,0 +1,65 @@
+#ifndef NNUE_H
+#define NNUE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Board/BoardState.h"
+#include "NnueAccumulator.h"
+
+namespace ChessEngine::Evaluation::Nnue {
+
+    /* A small efficiently updatable network : HalfKP inputs -> 2 x hiddenSize int16
+     * accumulators (side to move first) -> clipped relu -> one int8 quantized output.
+     *
+     * Quantization , with a the first layer output as a float and w an output weight :
+     * the accumulators hold a * activationScale , the output weights w * weightScale and
+     * the output bias b * activationScale * weightScale. The output 1.0 is evalScale centipawns. */
+    constexpr int activationScale = 127;
+    constexpr int weightScale = 64;
+    constexpr int evalScale = 400;
+
+    constexpr int maxActiveFeatures = 30; // Every piece but the kings.
+
+    /* The weights as stored in a network file. The file starts with the magic "CENNUE" ,
+     * a version , featureCount and hiddenSize (uint32 each) followed by the fields below in
+     * order , little endian. */
+    struct Network {
+        std::vector<int16_t> featureBiases; // hiddenSize.
+        std::vector<int16_t> featureWeights; // featureCount rows of hiddenSize.
+        std::vector<int8_t> outputWeights; // 2 x hiddenSize , side to move first.
+        int32_t outputBias = 0;
+    };
+
+    /* Load a network file , the evaluation uses it from then on. Not while a search runs. Changing the
+     * network leaves stale evaluations in the searches' caches , see Search::ClearEvalCache. */
+    bool LoadNetwork(const std::string& path);
+    bool SaveNetwork(const std::string& path, const Network& network);
+
+    void SetNetwork(const Network& network);
+    void ClearNetwork(); // Back to the hand written evaluation.
+    bool IsLoaded();
+
+    /* The kernels this build uses : avx2 , sse2 or scalar. */
+    std::string GetKernelName();
+
+    int GetFeatureIndex(Color perspective, uint8_t kingSquare, Color color, PieceType type, uint8_t squareIndex);
+
+    /* Indices of the active features from one side , returns how many. */
+    int GetActiveFeatures(const BoardState& state, Color perspective, int* features);
+
+    /* Compute the accumulators from scratch , does nothing without a network. */
+    void RefreshAccumulator(BoardState& state);
+
+    /* Update the accumulators after a move , previous holds the piece boards before it.
+     * Added and removed pieces add and subtract their weight rows , a side whose king
+     * moved is refreshed since every one of its features changes. */
+    void UpdateAccumulator(BoardState& state, const BitboardUtil::Bitboard (&previous)[2][6]);
+
+    /* From the side to move's point of view , in centipawns. */
+    int Evaluate(const BoardState& state);
+
+}
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef NNUE_ACCUMULATOR_H
+#define NNUE_ACCUMULATOR_H
+
+#include <cstdint>
+
+namespace ChessEngine::Evaluation::Nnue {
+
+    // HalfKP inputs , every (own king square , piece , square) of the 10 non king pieces ,
+    // seen from each side with the board flipped for Black.
+    constexpr int featureCount = 64 * 10 * 64;
+    constexpr int hiddenSize = 128; // First layer outputs per side.
+
+    /* First layer outputs of both sides (use Color for indexing) , kept in the position
+     * and updated by MakeMove from the pieces that moved. */
+    struct Accumulator {
+        alignas(32) int16_t values[2][hiddenSize]{};
+        uint32_t network = 0; // Id of the network the values were computed with , 0 when they weren't.
+    };
+
+}
+
+#endif
@@ -0,0 +1,129 @@
+#include "PawnStructure.h"
+
+#include <algorithm>
+
+namespace ChessEngine::Evaluation {
+
+    using namespace BitboardUtil;
+
+    /*******************************************************/
+    /* Set-wise pawn helpers                               */
+    /*******************************************************/
+
+    static Bitboard Push(Color color, Bitboard board) {
+        return (color == Color::White) ? board << 8 : board >> 8;
+    }
+
+    /* Squares in front of the pawns , the pawns excluded. */
+    static Bitboard FrontSpan(Color color, Bitboard pawns) {
+        return (color == Color::White) ? FillUp(pawns << 8) : FillDown(pawns >> 8);
+    }
+
+    /* Squares behind the pawns , the pawns excluded. */
+    static Bitboard RearSpan(Color color, Bitboard pawns) {
+        return FrontSpan(InvertColor(color), pawns);
+    }
+
+    static Bitboard PawnAttacks(Color color, Bitboard pawns) {
+        return ShiftSides(Push(color, pawns));
+    }
+
+    /*******************************************************/
+    /* Evaluation                                          */
+    /*******************************************************/
+
+    static PawnTerms GetColorTerms(Color color, const Bitboard (&pawns)[2], const Bitboard (&frontSpans)[2]) {
+        Color opponent = InvertColor(color);
+        Bitboard own = pawns[color];
+        Bitboard opponentAttackSpan = ShiftSides(frontSpans[opponent]);
+
+        PawnTerms terms;
+        terms.attackSpan = ShiftSides(frontSpans[color]);
+
+        // A pawn behind an own pawn is doubled , the front one may still be passed.
+        terms.doubled = own & RearSpan(color, own);
+        terms.isolated = own & ~ShiftSides(FillFiles(own));
+        // The stop square is attacked by an enemy pawn and no own pawn can ever defend it.
+        terms.backward = Push(opponent, Push(color, own) & PawnAttacks(opponent, pawns[opponent]) & ~terms.attackSpan);
+        terms.backward &= ~terms.isolated;
+
+        terms.passed = own & ~terms.doubled & ~(frontSpans[opponent] | opponentAttackSpan);
+        return terms;
+    }
+
+    void GetPawnTerms(const BoardState& state, PawnTerms (&terms)[2]) {
+        const Bitboard pawns[2] = {state.pieceBoards[Color::White][PieceType::Pawn],
+                                   state.pieceBoards[Color::Black][PieceType::Pawn]};
+        const Bitboard frontSpans[2] = {FrontSpan(Color::White, pawns[Color::White]),
+                                        FrontSpan(Color::Black, pawns[Color::Black])};
+
+        terms[Color::White] = GetColorTerms(Color::White, pawns, frontSpans);
+        terms[Color::Black] = GetColorTerms(Color::Black, pawns, frontSpans);
+    }
+
+    static int EvaluateColor(Color color, const PawnTerms& terms) {
+        int score = 0;
+        score -= GetBitCount(terms.isolated) * isolatedPenalty;
+        score -= GetBitCount(terms.doubled) * doubledPenalty;
+        score -= GetBitCount(terms.backward) * backwardPenalty;
+
+        for (int rank = Rank::R2; rank <= Rank::R7; rank++) {
+            int relativeRank = (color == Color::White) ? rank : Rank::R8 - rank;
+            score += GetBitCount(terms.passed & (r1_Mask << (8 * rank))) * passedBonus[relativeRank];
+        }
+
+        return score;
+    }
+
+    void EvaluatePawns(const BoardState& state, PawnEntry& entry) {
+        PawnTerms terms[2];
+        GetPawnTerms(state, terms);
+
+        for (int color = Color::White; color <= Color::Black; color++) {
+            entry.passed[color] = terms[color].passed;
+            entry.attackSpans[color] = terms[color].attackSpan;
+        }
+
+        entry.score = EvaluateColor(Color::White, terms[Color::White]) - EvaluateColor(Color::Black, terms[Color::Black]);
+        entry.key = state.pawnKey;
+        entry.valid = true;
+    }
+
+    void GetShieldPawns(const BoardState& state, Color color, Bitboard (&shield)[2]) {
+        Bitboard king = state.pieceBoards[color][PieceType::King];
+        Bitboard pawns = state.pieceBoards[color][PieceType::Pawn];
+
+        Bitboard firstRank = Push(color, king | ShiftSides(king));
+        Bitboard secondRank = Push(color, firstRank);
+        shield[0] = pawns & firstRank;
+        shield[1] = pawns & secondRank;
+    }
+
+    int EvaluatePawnShield(const BoardState& state, Color color) {
+        Bitboard shield[2];
+        GetShieldPawns(state, color, shield);
+        return GetBitCount(shield[0]) * shieldBonus[0] + GetBitCount(shield[1]) * shieldBonus[1];
+    }
+
+    /*******************************************************/
+    /* Pawn table                                          */
+    /*******************************************************/
+
+    PawnTable::PawnTable(size_t kilobytes) {
+        // Round down to a power of 2 number of entries.
+        size_t maxEntries = std::max<size_t>(kilobytes * 1024 / sizeof(PawnEntry), 1);
+        entryCount = 1;
+        while (entryCount * 2 <= maxEntries)
+            entryCount *= 2;
+
+        entries.resize(entryCount);
+    }
+
+    const PawnEntry& PawnTable::Probe(const BoardState& state) {
+        PawnEntry& entry = entries[state.pawnKey & (entryCount - 1)];
+        if (!entry.valid || entry.key != state.pawnKey)
+            EvaluatePawns(state, entry);
+        return entry;
+    }
+
+}
@@ -0,0 +1,69 @@
+#ifndef PAWN_STRUCTURE_H
+#define PAWN_STRUCTURE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../Board/BoardState.h"
+
+namespace ChessEngine::Evaluation {
+
+    constexpr int isolatedPenalty = 15;
+    constexpr int doubledPenalty = 12;
+    constexpr int backwardPenalty = 10;
+    // Indexed by the rank relative to the pawn's color.
+    constexpr int passedBonus[8] = {0, 5, 10, 20, 35, 60, 100, 0};
+
+    constexpr int shieldBonus[2] = {12, 6}; // 1 and 2 ranks in front of the king.
+
+    /* The pawns of one color that get a bonus or a penalty. */
+    struct PawnTerms {
+        BitboardUtil::Bitboard isolated = 0;
+        BitboardUtil::Bitboard doubled = 0; // The ones behind an own pawn.
+        BitboardUtil::Bitboard backward = 0;
+        BitboardUtil::Bitboard passed = 0;
+        BitboardUtil::Bitboard attackSpan = 0; // Squares the pawns attack now or after advancing.
+    };
+
+    /* Terms that only depend on the pawns , they are cached by BoardState::pawnKey. */
+    struct PawnEntry {
+        uint64_t key = 0;
+        bool valid = false;
+
+        int score = 0; // From White's point of view.
+
+        // Use Color for indexing.
+        BitboardUtil::Bitboard passed[2]{};
+        BitboardUtil::Bitboard attackSpans[2]{}; // Squares the pawns attack now or after advancing.
+    };
+
+    /* Passed , isolated , doubled and backward pawns , found for all the pawns of a
+     * color at once with fills instead of looping over them. Use Color for indexing. */
+    void GetPawnTerms(const BoardState& state, PawnTerms (&terms)[2]);
+
+    void EvaluatePawns(const BoardState& state, PawnEntry& entry);
+
+    /* Own pawns on the 3 files around the king , 1 and 2 ranks in front of it. */
+    void GetShieldPawns(const BoardState& state, Color color, BitboardUtil::Bitboard (&shield)[2]);
+
+    /* Depends on the king square so it isn't cached. From color's point of view. */
+    int EvaluatePawnShield(const BoardState& state, Color color);
+
+    /* Direct mapped pawn hash table , pawn structures repeat across most of a search so
+     * almost every probe hits. Not thread safe , each thread should have its own. */
+    class PawnTable {
+    public:
+        explicit PawnTable(size_t kilobytes);
+
+        /* The entry of the position's pawns , evaluated and stored on a miss. */
+        const PawnEntry& Probe(const BoardState& state);
+
+    private:
+        std::vector<PawnEntry> entries;
+        size_t entryCount = 0; // Always a power of 2 so the key can be masked.
+    };
+
+}
+
+#endif
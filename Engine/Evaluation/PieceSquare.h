@@ -0,0 +1,41 @@
+#ifndef PIECE_SQUARE_H
+#define PIECE_SQUARE_H
+
+#include <cstdint>
+
+#include "../Board/BoardState.h"
+
+namespace ChessEngine::Evaluation {
+
+    /* Material and piece square values for the midgame and the endgame. The position keeps
+     * their sums (BoardState::midgameScore / endgameScore) and the game phase , MakeMove
+     * updates them with the value of every piece that leaves or lands on a square. The
+     * evaluation blends the two sums by the phase. */
+
+    constexpr int maxPhase = 24; // The starting material , a knight or bishop is 1 , a rook 2 and a queen 4.
+
+    // Use PieceType for indexing.
+    constexpr int phaseWeights[6] = {0, 4, 1, 1, 2, 0};
+    constexpr int midgameValues[6] = {0, 1025, 365, 337, 477, 82};
+    constexpr int endgameValues[6] = {0, 936, 297, 281, 512, 94};
+
+    // Written from White's side with rank 8 on top , so a square index (a1 = 0) is
+    // flipped for White and used as is for Black. Use PieceType for indexing.
+    extern const int midgameTables[6][64];
+    extern const int endgameTables[6][64];
+
+    void InitPieceSquareTables(); // Need to call at startup.
+
+    /* Set the sums and the phase from scratch.
+     * NOTE: Should only be used on initialization , MakeMove keeps them updated. */
+    void ComputePieceSquareScores(BoardState& state);
+
+    void AddPieceScore(BoardState& state, Color color, PieceType type, uint8_t squareIndex);
+    void RemovePieceScore(BoardState& state, Color color, PieceType type, uint8_t squareIndex);
+
+    /* The sums blended by the phase , from White's point of view. */
+    int GetTaperedScore(const BoardState& state);
+
+}
+
+#endif
@@ -0,0 +1,120 @@
+#include "Tuning.h"
+
+#include <algorithm>
+
+#include "Material.h"
+#include "PawnStructure.h"
+#include "PieceSquare.h"
+
+namespace ChessEngine::Evaluation::Tuning {
+
+    using namespace BitboardUtil;
+
+    // Where each group starts in the parameter list.
+    constexpr int valuesStart = 0;
+    constexpr int tablesStart = valuesStart + 6;
+    constexpr int isolatedIndex = tablesStart + 6 * 64;
+    constexpr int doubledIndex = isolatedIndex + 1;
+    constexpr int backwardIndex = doubledIndex + 1;
+    constexpr int passedStart = backwardIndex + 1;
+    constexpr int shieldStart = passedStart + 8;
+    constexpr int bishopPairIndex = shieldStart + 2;
+    constexpr int knightPawnIndex = bishopPairIndex + 1;
+    constexpr int rookPawnIndex = knightPawnIndex + 1;
+    constexpr int parameterCount = rookPawnIndex + 1;
+
+    static void AddGroup(std::vector<Parameter>& parameters, const std::string& group,
+                         const int* midgame, const int* endgame, int size) {
+        for (int i = 0; i < size; i++) {
+            Parameter parameter;
+            parameter.group = group;
+            parameter.index = i;
+            parameter.tapered = endgame != nullptr;
+            parameter.midgame = midgame[i];
+            parameter.endgame = endgame ? endgame[i] : midgame[i];
+            parameters.push_back(parameter);
+        }
+    }
+
+    std::vector<Parameter> GetParameters() {
+        const std::string pieceNames[6] = {"King", "Queen", "Bishop", "Knight", "Rook", "Pawn"};
+
+        std::vector<Parameter> parameters;
+        AddGroup(parameters, "pieceValues", midgameValues, endgameValues, 6);
+        for (int type = PieceType::King; type <= PieceType::Pawn; type++)
+            AddGroup(parameters, pieceNames[type] + " table", midgameTables[type], endgameTables[type], 64);
+        AddGroup(parameters, "isolatedPenalty", &isolatedPenalty, nullptr, 1);
+        AddGroup(parameters, "doubledPenalty", &doubledPenalty, nullptr, 1);
+        AddGroup(parameters, "backwardPenalty", &backwardPenalty, nullptr, 1);
+        AddGroup(parameters, "passedBonus", passedBonus, nullptr, 8);
+        AddGroup(parameters, "shieldBonus", shieldBonus, nullptr, 2);
+        AddGroup(parameters, "bishopPairBonus", &bishopPairBonus, nullptr, 1);
+        AddGroup(parameters, "knightPawnBonus", &knightPawnBonus, nullptr, 1);
+        AddGroup(parameters, "rookPawnPenalty", &rookPawnPenalty, nullptr, 1);
+        return parameters;
+    }
+
+    bool GetCoefficients(const BoardState& state, std::vector<Coefficient>& coefficients) {
+        MaterialEntry material = ProbeMaterial(state);
+        if (material.insufficient || material.evaluator)
+            return false;
+
+        int counts[parameterCount] = {};
+
+        PawnTerms pawnTerms[2];
+        GetPawnTerms(state, pawnTerms);
+
+        for (int color = Color::White; color <= Color::Black; color++) {
+            int sign = (color == Color::White) ? 1 : -1;
+
+            // Material and piece squares , the tables are written from White's side.
+            for (int type = PieceType::King; type <= PieceType::Pawn; type++) {
+                Bitboard pieces = state.pieceBoards[color][type];
+                counts[valuesStart + type] += sign * GetBitCount(pieces);
+                while (pieces != 0) {
+                    uint8_t squareIndex = GetLSBIndex(pieces);
+                    uint8_t tableIndex = (color == Color::White) ? squareIndex ^ 56 : squareIndex;
+                    counts[tablesStart + type * 64 + tableIndex] += sign;
+                    pieces = PopBit(pieces, squareIndex);
+                }
+            }
+
+            // Pawn structure , penalties count negatively.
+            const PawnTerms& terms = pawnTerms[color];
+            counts[isolatedIndex] -= sign * GetBitCount(terms.isolated);
+            counts[doubledIndex] -= sign * GetBitCount(terms.doubled);
+            counts[backwardIndex] -= sign * GetBitCount(terms.backward);
+            for (Bitboard passed = terms.passed; passed != 0; passed &= passed - 1) {
+                auto [file, rank] = GetCoordinates(GetLSBIndex(passed));
+                int relativeRank = (color == Color::White) ? rank : Rank::R8 - rank;
+                counts[passedStart + relativeRank] += sign;
+            }
+
+            if (state.pieceBoards[InvertColor((Color) color)][PieceType::Queen] != 0) {
+                Bitboard shield[2];
+                GetShieldPawns(state, (Color) color, shield);
+                counts[shieldStart] += sign * GetBitCount(shield[0]);
+                counts[shieldStart + 1] += sign * GetBitCount(shield[1]);
+            }
+
+            // Imbalance , as in the material table.
+            auto count = [&](PieceType type) { return GetPieceCount(state.materialKey, (Color) color, type); };
+            int extraPawns = count(PieceType::Pawn) - 5;
+            counts[knightPawnIndex] += sign * count(PieceType::Knight) * extraPawns;
+            counts[rookPawnIndex] -= sign * count(PieceType::Rook) * extraPawns;
+            if (count(PieceType::Bishop) >= 2)
+                counts[bishopPairIndex] += sign;
+        }
+
+        for (int i = 0; i < parameterCount; i++)
+            if (counts[i] != 0)
+                coefficients.push_back({(uint16_t) i, (int8_t) counts[i]});
+        return true;
+    }
+
+    int GetPhase(const BoardState& state) {
+        // Promotions can push the phase past the starting material.
+        return std::min(state.phase, maxPhase);
+    }
+
+}
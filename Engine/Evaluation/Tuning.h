@@ -0,0 +1,44 @@
+#ifndef TUNING_H
+#define TUNING_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Board/BoardState.h"
+
+namespace ChessEngine::Evaluation::Tuning {
+
+    /* Outside of known endgames the hand written evaluation is linear in its parameters , it is the sum
+     * of every parameter times how often it applies in the position. Tapered parameters blend their
+     * midgame and endgame values by the phase. A tuner can get the exact gradient from these counts
+     * without evaluating positions again. */
+
+    struct Parameter {
+        std::string group; // The constant in the source.
+        int index = 0; // Within the group.
+
+        bool tapered = false;
+        int midgame = 0;
+        int endgame = 0; // Same as midgame when not tapered.
+    };
+
+    /* How often a parameter applies , White's count minus Black's. */
+    struct Coefficient {
+        uint16_t index;
+        int8_t count;
+    };
+
+    /* Every parameter with the value the evaluation uses , indexed by Coefficient::index. */
+    std::vector<Parameter> GetParameters();
+
+    /* Appends the nonzero coefficients of the position. False when its evaluation isn't
+     * linear (insufficient material or a known endgame). */
+    bool GetCoefficients(const BoardState& state, std::vector<Coefficient>& coefficients);
+
+    /* The weight of the midgame values , from 0 to maxPhase. */
+    int GetPhase(const BoardState& state);
+
+}
+
+#endif
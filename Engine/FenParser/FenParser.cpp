@@ -2,6 +2,11 @@
 
 #include <sstream>
 
+#include "../Hashing/Zobrist.h"
+#include "../Evaluation/Material.h"
+#include "../Evaluation/PieceSquare.h"
+#include "../Evaluation/Nnue.h"
+
 using namespace ChessEngine;
 
 /*******************************************************/
@@ -191,6 +196,11 @@ bool ChessEngine::ParseFenString(const std::string& fenString, BoardState& state
     }
 
     if(count == 6) { // We got all 6 parts of the fen format.
+        tempState.hashKey = Zobrist::GetHash(tempState);
+        tempState.pawnKey = Zobrist::GetPawnHash(tempState);
+        tempState.materialKey = Evaluation::GetMaterialKey(tempState);
+        Evaluation::ComputePieceSquareScores(tempState);
+        Evaluation::Nnue::RefreshAccumulator(tempState);
         state = tempState; // Only alter the state if the string was successfully parsed.
         return true;
     }else{
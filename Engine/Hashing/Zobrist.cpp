@@ -0,0 +1,120 @@
+#include "Zobrist.h"
+
+namespace ChessEngine::Zobrist {
+
+    using namespace BitboardUtil;
+
+    // [color][piece type][square index].
+    static uint64_t pieceKeys[2][6][64];
+    // Indexed by the 4 castling rights packed as bits.
+    static uint64_t castlingKeys[16];
+    // Indexed by the file of the en passant square.
+    static uint64_t enPassantKeys[8];
+    static uint64_t sideKey;
+
+    /* xorshift64* , a fixed seed keeps the keys identical between runs. */
+    static uint64_t NextRandom(uint64_t& seed) {
+        seed ^= seed >> 12;
+        seed ^= seed << 25;
+        seed ^= seed >> 27;
+        return seed * 0x2545F4914F6CDD1DULL;
+    }
+
+    void InitZobristKeys() {
+        uint64_t seed = 0x9E3779B97F4A7C15ULL;
+
+        for (auto& colorKeys : pieceKeys)
+            for (auto& typeKeys : colorKeys)
+                for (auto& key : typeKeys)
+                    key = NextRandom(seed);
+
+        for (auto& key : castlingKeys)
+            key = NextRandom(seed);
+
+        for (auto& key : enPassantKeys)
+            key = NextRandom(seed);
+
+        sideKey = NextRandom(seed);
+    }
+
+    uint64_t GetPieceKey(Color color, PieceType type, uint8_t squareIndex) {
+        return pieceKeys[color][type][squareIndex];
+    }
+
+    uint64_t GetCastlingKey(const BoardState& state) {
+        int rights = state.kingSideCastling[Color::White] |
+                     state.queenSideCastling[Color::White] << 1 |
+                     state.kingSideCastling[Color::Black] << 2 |
+                     state.queenSideCastling[Color::Black] << 3;
+        return castlingKeys[rights];
+    }
+
+    uint64_t GetEnPassantKey(Bitboard enPassantBoard) {
+        if (enPassantBoard == BITBOARD_EMPTY)
+            return 0;
+
+        auto [file, rank] = GetCoordinates(GetLSBIndex(enPassantBoard));
+        return enPassantKeys[file];
+    }
+
+    uint64_t GetSideKey() {
+        return sideKey;
+    }
+
+    uint64_t GetSchemeKey() {
+        uint64_t scheme = 0;
+        auto add = [&scheme](uint64_t key) { scheme = (scheme << 7 | scheme >> 57) ^ key; };
+
+        for (auto& colorKeys : pieceKeys)
+            for (auto& typeKeys : colorKeys)
+                for (auto key : typeKeys)
+                    add(key);
+
+        for (auto key : castlingKeys)
+            add(key);
+
+        for (auto key : enPassantKeys)
+            add(key);
+
+        add(sideKey);
+        return scheme;
+    }
+
+    uint64_t GetHash(const BoardState& state) {
+        uint64_t hash = 0;
+
+        for (int color = Color::White; color <= Color::Black; color++) {
+            for (int type = PieceType::King; type <= PieceType::Pawn; type++) {
+                Bitboard pieces = state.pieceBoards[color][type];
+                while (pieces != 0) {
+                    uint8_t squareIndex = GetLSBIndex(pieces);
+                    hash ^= pieceKeys[color][type][squareIndex];
+                    pieces = PopBit(pieces, squareIndex);
+                }
+            }
+        }
+
+        hash ^= GetCastlingKey(state);
+        hash ^= GetEnPassantKey(state.enPassantBoard);
+        if (state.turnOf == Color::Black)
+            hash ^= sideKey;
+
+        return hash;
+    }
+
+    uint64_t GetPawnHash(const BoardState& state) {
+        uint64_t hash = 0;
+
+        for (int color = Color::White; color <= Color::Black; color++) {
+            Bitboard pawns = state.pieceBoards[color][PieceType::Pawn];
+            while (pawns != 0) {
+                uint8_t squareIndex = GetLSBIndex(pawns);
+                hash ^= pieceKeys[color][PieceType::Pawn][squareIndex];
+                pawns = PopBit(pawns, squareIndex);
+            }
+        }
+
+        return hash;
+    }
+
+}
@@ -0,0 +1,31 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+#include "../Board/BoardState.h"
+
+namespace ChessEngine::Zobrist {
+
+    // A position is hashed by xoring together a random key for each
+    // (piece, square) pair , the side to move , the castling rights and the en passant file.
+    // Since xor is its own inverse the hash can be updated incrementally when a move is made.
+
+    void InitZobristKeys(); // Need to call at startup.
+
+    uint64_t GetPieceKey(Color color, PieceType type, uint8_t squareIndex);
+    uint64_t GetCastlingKey(const BoardState& state);
+    uint64_t GetEnPassantKey(BitboardUtil::Bitboard enPassantBoard);
+    uint64_t GetSideKey();
+
+    /* A checksum of every key , hashes saved with different keys (eg: in a table file) can't be reused. */
+    uint64_t GetSchemeKey();
+
+    /* Hash the whole position from scratch.
+     * NOTE: Should only be used on initialization , MakeMove keeps the key updated. */
+    uint64_t GetHash(const BoardState& state);
+    uint64_t GetPawnHash(const BoardState& state);
+
+}
+
+#endif
@@ -1,39 +1,29 @@
 #include "Draw.h"
 
+#include "../Evaluation/Material.h"
+#include "../Tablebase/Tablebase.h"
+
 namespace ChessEngine::MoveGeneration::Draw {
 
     bool InsufficientMaterial(const BoardState& boardState) {
         using namespace ChessEngine::BitboardUtil;
 
-        auto boards = boardState.pieceBoards;
-
-        if (boards[Color::White][PieceType::Rook] || boards[Color::Black][PieceType::Rook])
-            return false;
-        if (boards[Color::White][PieceType::Queen] || boards[Color::Black][PieceType::Queen])
-            return false;
-        if (boards[Color::White][PieceType::Pawn] || boards[Color::Black][PieceType::Pawn])
+        // The verdict for the piece counts comes from the material table , only
+        // positions with nothing but bishops depend on where the pieces stand.
+        Evaluation::MaterialEntry material = Evaluation::ProbeMaterial(boardState);
+        if (material.insufficient)
+            return true;
+        if (!material.bishopsOnly)
             return false;
 
-        int whiteBishop = GetBitCount(boards[Color::White][PieceType::Bishop]);
-        int blackBishop = GetBitCount(boards[Color::Black][PieceType::Bishop]);
-
-        int whiteKnight = GetBitCount(boards[Color::White][PieceType::Knight]);
-        int blackKnight = GetBitCount(boards[Color::Black][PieceType::Knight]);
-
-        int total = whiteBishop + blackBishop + whiteKnight + blackKnight;
+        Bitboard bishops = boardState.pieceBoards[Color::White][PieceType::Bishop] |
+                           boardState.pieceBoards[Color::Black][PieceType::Bishop];
+        return (bishops & darkSquares_Mask) == 0 || (bishops & lightSquares_Mask) == 0;
+    }
 
-        // king versus king , 1 bishop, 1 knight
-        if (total <= 1) {
-            return true;
-        } else if (total == 2 && whiteBishop == blackBishop == 1) {
-            // king and bishop versus king and bishop with the bishops on the same color.
-            // Check if same color.
-            auto[wX, wY] = GetCoordinates(GetLSBIndex(boards[Color::White][PieceType::Bishop]));
-            auto[bX, bY] = GetCoordinates(GetLSBIndex(boards[Color::Black][PieceType::Bishop]));
-            return wX % 2 == wY % 2 == bX % 2 == bY % 2;
-        } else {
-            return false;
-        }
+    bool TablebaseDraw(const BoardState& boardState) {
+        Tablebase::ProbeResult result;
+        return Tablebase::Probe(boardState, result) && result.outcome == Tablebase::Outcome::Draw;
     }
 
     bool Stalemate(Board& board, const std::list<Move>& moves){ // TODO : maybe too slow.
@@ -42,9 +32,20 @@ namespace ChessEngine::MoveGeneration::Draw {
         return moves.empty() && NumberOfChecks(state.turnOf, state, occupancies) == 0;
     }
 
-    bool IsDraw(Board& board, const std::list<Move>& moves){
+    bool Repetition(const BoardState& boardState, const KeyHistory& history, int repetitions) {
+        return history.CountRepetitions(boardState.hashKey, boardState.halfMoves, repetitions) >= repetitions;
+    }
+
+    bool MaxMoves(const BoardState& boardState) {
+        return boardState.halfMoves >= 100;
+    }
+
+    bool IsDraw(Board& board, const std::list<Move>& moves, const KeyHistory& history){
+        // Checkmate on the last move of the fifty wins , callers check IsCheckmate first.
         return Draw::InsufficientMaterial(board.GetState()) ||
-               Draw::Stalemate(board, moves);
+               Draw::Stalemate(board, moves) ||
+               Draw::MaxMoves(board.GetState()) ||
+               Draw::Repetition(board.GetState(), history);
     }
 
     bool IsCheckmate(Board& board, const std::list<Move>& moves){ // TODO: move.
@@ -2,16 +2,25 @@
 #define DRAW_H
 
 #include <Engine/Board/Board.h>
+#include "../Board/KeyHistory.h"
 #include "MoveGeneration.h"
 
 namespace ChessEngine::MoveGeneration::Draw {
 
     bool InsufficientMaterial(const BoardState& boardState);
+
+    /* Drawn with best play according to the loaded tablebases (see Tablebase::LoadTables). */
+    bool TablebaseDraw(const BoardState& boardState);
     bool Stalemate(Board& board, const std::list<Move>& moves);
-    bool Repetition();
-    bool MaxMoves();
 
-    bool IsDraw(Board& board, const std::list<Move>& moves);
+    /* The position was already played repetitions times (2 for the threefold rule).
+     * history holds the positions before this one , see KeyHistory. */
+    bool Repetition(const BoardState& boardState, const KeyHistory& history, int repetitions = 2);
+
+    /* Fifty moves by each side without a capture or a pawn move. */
+    bool MaxMoves(const BoardState& boardState);
+
+    bool IsDraw(Board& board, const std::list<Move>& moves, const KeyHistory& history);
     bool IsCheckmate(Board& board, const std::list<Move>& moves);
 
 
@@ -13,6 +13,24 @@ namespace ChessEngine::MoveGeneration {
         return flags & type;
     }
 
+    uint16_t PackMove(const Move& move) {
+        // King is never a promotion type so 0 means no promotion.
+        uint16_t promotion = IsMoveType(move.flags, MoveType::Promotion) ? move.promotionType : 0;
+        return move.fromSquareIndex | move.toSquareIndex << 6 | promotion << 12;
+    }
+
+    std::string MoveToString(const Move& move) {
+        auto[xf, yf] = GetCoordinates(move.fromSquareIndex);
+        auto[xt, yt] = GetCoordinates(move.toSquareIndex);
+
+        std::string str = FileToString((File) xf) + RankToString((Rank) yf) +
+                          FileToString((File) xt) + RankToString((Rank) yt);
+        if (IsMoveType(move.flags, MoveType::Promotion))
+            str += PieceTypeToChar(move.promotionType, Color::Black); // Lower case.
+
+        return str;
+    }
+
     std::string MoveTypeToString(MoveType type) {
         switch (type) {
             case MoveType::None:
@@ -30,6 +30,13 @@ namespace ChessEngine::MoveGeneration {
     };
 
     bool IsMoveType(MoveType flags, MoveType type);
+
+    /* Pack the squares and the promotion of a move into 16 bits.
+     * Enough to identify a move among the valid moves of a position , used when storing moves in tables. */
+    uint16_t PackMove(const Move& move);
+
+    /* Long algebraic notation , eg: e2e4 or e7e8q. */
+    std::string MoveToString(const Move& move);
     std::string MoveTypeToString(MoveType type); /* Should contain a single flag */
 
     std::ostream& operator<<(std::ostream& out, MoveType value);
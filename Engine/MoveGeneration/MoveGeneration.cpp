@@ -3,9 +3,14 @@
 #include "Engine/MoveGeneration/MoveTables.h"
 #include "Engine/MoveGeneration/PseudoMoves.h"
 #include "Engine/MoveGeneration/Draw.h"
+#include "Engine/Hashing/Zobrist.h"
+#include "Engine/Evaluation/Material.h"
+#include "Engine/Evaluation/PieceSquare.h"
+#include "Engine/Evaluation/Nnue.h"
 
 #include <iostream>
 #include <cassert>
+#include <cstring>
 
 namespace ChessEngine::MoveGeneration {
 
@@ -34,6 +39,10 @@ namespace ChessEngine::MoveGeneration {
 
             Bitboard &enemyPawnBoard = state.pieceBoards[opponentColor][PieceType::Pawn];
             enemyPawnBoard = PopBit(enemyPawnBoard, pawnIndex);
+            state.hashKey ^= Zobrist::GetPieceKey(opponentColor, PieceType::Pawn, pawnIndex);
+            state.pawnKey ^= Zobrist::GetPieceKey(opponentColor, PieceType::Pawn, pawnIndex);
+            state.materialKey -= Evaluation::GetMaterialDelta(opponentColor, PieceType::Pawn);
+            Evaluation::RemovePieceScore(state, opponentColor, PieceType::Pawn, pawnIndex);
 
             // Update square boardOccupancies for said pawn
             boardOccupancies.squaresOccupants[pawnIndex] = {PieceType::None, Color::Both};
@@ -69,6 +78,10 @@ namespace ChessEngine::MoveGeneration {
         Bitboard& rookBoard = state.pieceBoards[color][PieceType::Rook];
         rookBoard = PopBit(rookBoard, rookOldIndex);
         rookBoard = SetBit(rookBoard, rookNewIndex);
+        state.hashKey ^= Zobrist::GetPieceKey(color, PieceType::Rook, rookOldIndex) ^
+                         Zobrist::GetPieceKey(color, PieceType::Rook, rookNewIndex);
+        Evaluation::RemovePieceScore(state, color, PieceType::Rook, rookOldIndex);
+        Evaluation::AddPieceScore(state, color, PieceType::Rook, rookNewIndex);
 
         // Update square boardOccupancies
         boardOccupancies.squaresOccupants[rookOldIndex] = {PieceType::None, Color::Both};
@@ -111,9 +124,17 @@ namespace ChessEngine::MoveGeneration {
         }
     }
 
-    void MakeMove(const Move& move, Color color, BoardState& state, BoardOccupancies& boardOccupancies){
+    static void MakeMove(const Move& move, Color color, BoardState& state, BoardOccupancies& boardOccupancies, bool updateNetwork){
         Color opponentColor = InvertColor(color);
 
+        // The network's inputs are updated from the difference of the piece boards.
+        Bitboard previousBoards[2][6];
+        if (updateNetwork)
+            std::memcpy(previousBoards, state.pieceBoards, sizeof(previousBoards));
+
+        // Remove the old castling / en passant keys , the new ones are added once the move is done.
+        state.hashKey ^= Zobrist::GetCastlingKey(state) ^ Zobrist::GetEnPassantKey(state.enPassantBoard);
+
         // Update self piece bitboard.
         Bitboard& selfTypeBoard = state.pieceBoards[color][move.selfType];
         selfTypeBoard = PopBit(selfTypeBoard, move.fromSquareIndex);
@@ -121,11 +142,29 @@ namespace ChessEngine::MoveGeneration {
         PieceType promotionType = (IsMoveType(move.flags, MoveType::Promotion)) ? move.promotionType : move.selfType;
         Bitboard& selfTypePromotionBoard = state.pieceBoards[color][promotionType];
         selfTypePromotionBoard = SetBit(selfTypePromotionBoard, move.toSquareIndex);
+        state.hashKey ^= Zobrist::GetPieceKey(color, move.selfType, move.fromSquareIndex) ^
+                         Zobrist::GetPieceKey(color, promotionType, move.toSquareIndex);
+        Evaluation::RemovePieceScore(state, color, move.selfType, move.fromSquareIndex);
+        Evaluation::AddPieceScore(state, color, promotionType, move.toSquareIndex);
+        if (move.selfType == PieceType::Pawn) {
+            state.pawnKey ^= Zobrist::GetPieceKey(color, PieceType::Pawn, move.fromSquareIndex);
+            if (promotionType == PieceType::Pawn)
+                state.pawnKey ^= Zobrist::GetPieceKey(color, PieceType::Pawn, move.toSquareIndex);
+            else
+                state.materialKey += Evaluation::GetMaterialDelta(color, promotionType) -
+                                     Evaluation::GetMaterialDelta(color, PieceType::Pawn);
+        }
 
         // Update enemy piece board.
-        if (IsMoveType(move.flags, MoveType::Capture)) {
+        // En passant captures are handled separately since the captured pawn isn't on the target square.
+        if (IsMoveType(move.flags, MoveType::Capture) && !IsMoveType(move.flags, MoveType::EnPassant)) {
             Bitboard &enemyTypeBoard = state.pieceBoards[opponentColor][move.enemyType];
             enemyTypeBoard = PopBit(enemyTypeBoard, move.toSquareIndex);
+            state.hashKey ^= Zobrist::GetPieceKey(opponentColor, move.enemyType, move.toSquareIndex);
+            if (move.enemyType == PieceType::Pawn)
+                state.pawnKey ^= Zobrist::GetPieceKey(opponentColor, PieceType::Pawn, move.toSquareIndex);
+            state.materialKey -= Evaluation::GetMaterialDelta(opponentColor, move.enemyType);
+            Evaluation::RemovePieceScore(state, opponentColor, move.enemyType, move.toSquareIndex);
         }
 
         // EnPassant can mean either a capture or a double pawn move.
@@ -163,11 +202,39 @@ namespace ChessEngine::MoveGeneration {
         // Update global boardOccupancies.
         boardOccupancies.occupancies[Color::Both] = selfOccupancies | enemyOccupancies;
 
+        // Captures and pawn moves can't be undone , they reset the fifty move counter.
+        bool irreversible = move.selfType == PieceType::Pawn;
+        irreversible |= IsMoveType(move.flags, MoveType::Capture);
+        state.halfMoves = irreversible ? 0 : state.halfMoves + 1;
+        if (color == Color::Black)
+            state.fullMoves++;
+
         // Update turn
         state.turnOf = opponentColor;
+
+        state.hashKey ^= Zobrist::GetCastlingKey(state) ^
+                         Zobrist::GetEnPassantKey(state.enPassantBoard) ^
+                         Zobrist::GetSideKey();
+
+        if (updateNetwork)
+            Evaluation::Nnue::UpdateAccumulator(state, previousBoards);
+    }
+
+    void MakeMove(const Move& move, Color color, BoardState& state, BoardOccupancies& boardOccupancies){
+        MakeMove(move, color, state, boardOccupancies, Evaluation::Nnue::IsLoaded());
     }
 
-    int NumberOfChecks(Color color, const BoardState& state, BoardOccupancies& boardOccupancies, uint8_t kingIndex){
+    void MakeNullMove(Color color, BoardState& state){
+        // Passing the turn only changes the side to move and clears any en passant square.
+        state.hashKey ^= Zobrist::GetEnPassantKey(state.enPassantBoard) ^ Zobrist::GetSideKey();
+        state.enPassantBoard = BITBOARD_EMPTY;
+        state.turnOf = InvertColor(color);
+
+        // Positions before the pass can't count as repetitions after it.
+        state.halfMoves = 0;
+    }
+
+    int NumberOfChecks(Color color, const BoardState& state, const BoardOccupancies& boardOccupancies, uint8_t kingIndex){
         using namespace ChessEngine::MoveGeneration::MoveTables;
         using namespace ChessEngine::BitboardUtil;
 
@@ -204,7 +271,7 @@ namespace ChessEngine::MoveGeneration {
         return GetBitCount(attackSources); // TODO: why not bool?
     }
 
-    int NumberOfChecks(Color color, const BoardState& state, BoardOccupancies& boardOccupancies){
+    int NumberOfChecks(Color color, const BoardState& state, const BoardOccupancies& boardOccupancies){
         auto kingBoard = state.pieceBoards[color][PieceType::King];
         if(kingBoard) { // If not checked , an empty board will still give an index of 0.
             uint8_t kingIndex = GetLSBIndex(state.pieceBoards[color][PieceType::King]);
@@ -237,23 +304,23 @@ namespace ChessEngine::MoveGeneration {
                 return false;
         }
 
-        // Play the move and check if the king is still in check.
-        MakeMove(move, color, state, boardOccupancies);
+        // Play the move and check if the king is still in check , the position is never evaluated.
+        MakeMove(move, color, state, boardOccupancies, false);
         return NumberOfChecks(color, state, boardOccupancies) == 0;
     }
 
-    std::list<Move> GetValidMoves(const BoardState& state, Color color, const BoardOccupancies& boardOccupancies){
-        // TODO: possibly very slow to copy the board each time.
-        auto pseudoMoves = ChessEngine::MoveGeneration::Pseudo::GetPseudoMoves(state, color, boardOccupancies);
+    void GetValidMoves(const BoardState& state, Color color, const BoardOccupancies& boardOccupancies, MoveList& moves){
+        moves.Clear();
+        ChessEngine::MoveGeneration::Pseudo::GetPseudoMoves(state, color, boardOccupancies, moves);
 
-        std::list<Move> validMoves;
-        for(auto move : pseudoMoves){
-            if(IsValid(move, state, color, boardOccupancies)){
-                validMoves.push_back(move);
-            }
-        }
+        // TODO: possibly very slow to copy the board each time.
+        moves.Filter([&](const Move& move) { return IsValid(move, state, color, boardOccupancies); });
+    }
 
-        return validMoves;
+    std::list<Move> GetValidMoves(const BoardState& state, Color color, const BoardOccupancies& boardOccupancies){
+        MoveList moves;
+        GetValidMoves(state, color, boardOccupancies, moves);
+        return {moves.begin(), moves.end()};
     }
 
     void PrintMoves(const std::list<Move>& moveList){
@@ -4,6 +4,7 @@
 #include <list>
 
 #include "Move.h"
+#include "MoveList.h"
 #include "../Board/BoardState.h"
 #include "../Board/BoardOccupancies.h"
 
@@ -11,8 +12,16 @@ namespace ChessEngine::MoveGeneration {
 
     void MakeMove(const Move& move, Color color, BoardState& state, BoardOccupancies& boardOccupancies);
 
-    int NumberOfChecks(Color color, const BoardState& state, BoardOccupancies& boardOccupancies);
+    /* Pass the turn without moving , used by null move pruning. */
+    void MakeNullMove(Color color, BoardState& state);
 
+    int NumberOfChecks(Color color, const BoardState& state, const BoardOccupancies& boardOccupancies);
+
+    /* Checks a pseudo move , the king can't be left in check or castle through a check. */
+    bool IsValid(const Move& move, BoardState state, Color color, BoardOccupancies boardOccupancies);
+
+    /* Writes the valid moves into moves (cleared first) , the searches use this one so nothing is allocated. */
+    void GetValidMoves(const BoardState& state, Color color, const BoardOccupancies& boardOccupancies, MoveList& moves);
     std::list<Move> GetValidMoves(const BoardState& state, Color color, const BoardOccupancies& boardOccupancies);
 
     void PrintMoves(const std::list<Move>& moveList);
@@ -0,0 +1,47 @@
+#ifndef MOVE_LIST_H
+#define MOVE_LIST_H
+
+#include "Move.h"
+
+namespace ChessEngine::MoveGeneration {
+
+    // More than the pseudo moves of any legal position.
+    constexpr int maxPseudoMoves = 256;
+
+    /* Fixed capacity list the move generation writes into , nothing is allocated. The owner keeps it
+     * around (eg: the searches keep one per ply) and it is cleared on every generation. */
+    class MoveList {
+    public:
+        void Add(const Move& move) { moves[count++] = move; }
+        void Clear() { count = 0; }
+
+        int Size() const { return count; }
+        bool Empty() const { return count == 0; }
+
+        Move& operator[](int index) { return moves[index]; }
+        const Move& operator[](int index) const { return moves[index]; }
+
+        /* Keeps the moves keep returns true for , in their order. */
+        template<typename Predicate>
+        void Filter(Predicate keep) {
+            int kept = 0;
+            for (int i = 0; i < count; i++) {
+                if (keep(moves[i]))
+                    moves[kept++] = moves[i];
+            }
+            count = kept;
+        }
+
+        Move* begin() { return moves; }
+        Move* end() { return moves + count; }
+        const Move* begin() const { return moves; }
+        const Move* end() const { return moves + count; }
+
+    private:
+        Move moves[maxPseudoMoves];
+        int count = 0;
+    };
+
+}
+
+#endif
@@ -1,5 +1,7 @@
 #include "MoveTables.h"
 
+#include <new>
+
 #include "LeaperPieces.h"
 #include "SlidingPieces.h"
 
@@ -33,9 +35,7 @@ namespace ChessEngine::MoveGeneration::MoveTables {
     }
 
     /* Generate a single move table for rooks and bishops */
-    static std::array<Bitboard, permutations> CreateSlidingMoves() {
-        std::array<Bitboard, permutations> moves = {};
-
+    static void CreateSlidingMoves(Bitboard* moves) {
         for (int rank = 0; rank < 8; rank++) {
             for (int file = 0; file < 8; file++) {
                 uint8_t squareIndex = GetSquareIndex(file, rank);
@@ -44,10 +44,10 @@ namespace ChessEngine::MoveGeneration::MoveTables {
                 SlidingPieces::InitSlidingMoves(moves, squareIndex, false);
             }
         }
-
-        return moves;
     }
 
+    static Memory::Mapping slidingMovesMapping;
+
     void InitMoveTables(){
         auto whiteLeaper = [](auto board) { return LeaperPieces::GetPawnAttacks(board, Color::White); };
         auto blackLeaper = [](auto board) { return LeaperPieces::GetPawnAttacks(board, Color::Black); };
@@ -55,11 +55,22 @@ namespace ChessEngine::MoveGeneration::MoveTables {
         pawnAttacks = {CreateLeaperMoves(whiteLeaper), CreateLeaperMoves(blackLeaper)};
         kingMoves = CreateLeaperMoves(LeaperPieces::GetKingMoves);
         knightMoves = CreateLeaperMoves(LeaperPieces::GetKnightMoves);
-        slidingMoves = CreateSlidingMoves();
+
+        // Probed at random , huge pages keep the whole table under a single TLB entry.
+        if (!slidingMoves) {
+            if (!Memory::Allocate(permutations * sizeof(Bitboard), Memory::GetOptions().hugePages, slidingMovesMapping))
+                throw std::bad_alloc();
+            slidingMoves = (Bitboard*) slidingMovesMapping.address;
+        }
+        CreateSlidingMoves(slidingMoves);
     }
 
     // Main sliding piece table , contains both rook and bishop attacks.
-    std::array<Bitboard, permutations> slidingMoves{};
+    Bitboard* slidingMoves = nullptr;
+
+    const Memory::Mapping& GetSlidingMovesMapping() {
+        return slidingMovesMapping;
+    }
 
     /*******************************************************/
     /* Rook                                                */
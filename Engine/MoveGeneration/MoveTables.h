@@ -3,6 +3,7 @@
 
 #include "../Board/Bitboard.h"
 #include "MagicNumbers.h"
+#include "../Utilities/Memory.h"
 
 namespace ChessEngine::MoveGeneration::MoveTables {
 
@@ -18,11 +19,14 @@ namespace ChessEngine::MoveGeneration::MoveTables {
     BitboardUtil::Bitboard GetBishopMoves(uint8_t index, BitboardUtil::Bitboard occupancies);
     BitboardUtil::Bitboard GetQueenMoves(uint8_t index, BitboardUtil::Bitboard occupancies);
 
+    /* The memory holding the sliding moves , to report the pages it got (see Memory::MemoryOptions). */
+    const Memory::Mapping& GetSlidingMovesMapping();
+
     // TODO: change globals to static
     extern std::array<BitboardUtil::Bitboard, 64> kingMoves;
     extern std::array<BitboardUtil::Bitboard, 64> knightMoves;
     extern std::array<std::array<BitboardUtil::Bitboard, 64>, 2> pawnAttacks;
-    extern std::array<BitboardUtil::Bitboard, MagicNumbers::permutations> slidingMoves;
+    extern BitboardUtil::Bitboard* slidingMoves; // MagicNumbers::permutations entries.
 
 }
 
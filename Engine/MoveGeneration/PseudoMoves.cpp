@@ -10,35 +10,29 @@ namespace ChessEngine::MoveGeneration::Pseudo {
 
     using namespace ChessEngine::BitboardUtil;
 
-    static std::list<Move> GetPromotions(Move move){
-        std::list<Move> moveList;
-
+    static void GetPromotions(Move move, MoveList& moveList){
         // We get the initial move but change the promotion type
         // This isn't done in a for loop to avoid a connection between the
         // enum declaration order.
 
         Move queenPromo = move;
         queenPromo.promotionType = PieceType::Queen;
-        moveList.push_back(queenPromo);
+        moveList.Add(queenPromo);
 
         Move knightPromo = move;
         knightPromo.promotionType = PieceType::Knight;
-        moveList.push_back(knightPromo);
+        moveList.Add(knightPromo);
 
         Move rookPromo = move;
         rookPromo.promotionType = PieceType::Rook;
-        moveList.push_back(rookPromo);
+        moveList.Add(rookPromo);
 
         Move bishopPromo = move;
         bishopPromo.promotionType = PieceType::Bishop;
-        moveList.push_back(bishopPromo);
-
-        return moveList;
+        moveList.Add(bishopPromo);
     }
 
-    static std::list<Move> ExtractMoves(Bitboard moves, uint8_t fromSquareIndex, MoveType flags, const BoardOccupancies& utilities) {
-        std::list<Move> moveList;
-
+    static void ExtractMoves(Bitboard moves, uint8_t fromSquareIndex, MoveType flags, const BoardOccupancies& utilities, MoveList& moveList) {
         // iterate over the bitboard , for each isolated bit find the corresponding moves.
         while (moves != 0) {
             uint8_t toSquareIndex = GetLSBIndex(moves);
@@ -56,20 +50,16 @@ namespace ChessEngine::MoveGeneration::Pseudo {
             };
 
             if(IsMoveType(flags, MoveType::Promotion)) { // TODO: maybe not put this here?
-                auto promotions = GetPromotions(move);
-                moveList.splice(moveList.end(), promotions);
+                GetPromotions(move, moveList);
             }else{
-                moveList.emplace_back(move);
+                moveList.Add(move);
             }
 
             moves = PopBit(moves, toSquareIndex);
         }
-
-        return moveList;
     }
 
-    std::list<Move> GetPawnMoves(const BoardState &state, Color color, const BoardOccupancies& utilities) {
-        std::list<Move> moveList;
+    void GetPawnMoves(const BoardState &state, Color color, const BoardOccupancies& utilities, MoveList& moveList) {
         Color enemyColor = InvertColor(color);
         Bitboard enemyOccupancies = utilities.occupancies[enemyColor];
         Bitboard globalOccupancies = utilities.occupancies[Color::Both];
@@ -94,29 +84,23 @@ namespace ChessEngine::MoveGeneration::Pseudo {
             // Single pushes
             auto singlePushFlags = (MoveType) (MoveType::Quiet | promotionFlag);
             Bitboard singlePushes = LeaperPieces::GetPawnPushes(tempPieceBoard, color);
-            auto singlePushMoves = ExtractMoves(singlePushes & ~globalOccupancies, fromSquareIndex, singlePushFlags, utilities);
-            moveList.splice(moveList.end(), singlePushMoves);
+            ExtractMoves(singlePushes & ~globalOccupancies, fromSquareIndex, singlePushFlags, utilities, moveList);
 
             // Double pushes
             auto doublePushFlags = (MoveType) (MoveType::Quiet | MoveType::EnPassant);
             Bitboard doublePushes = LeaperPieces::GetDoublePawnPushes(tempPieceBoard, globalOccupancies, color);
-            auto doublePushMoves = ExtractMoves(doublePushes & ~globalOccupancies, fromSquareIndex, doublePushFlags, utilities);
-            moveList.splice(moveList.end(), doublePushMoves);
+            ExtractMoves(doublePushes & ~globalOccupancies, fromSquareIndex, doublePushFlags, utilities, moveList);
 
             // Captures
             auto attackMoveFlags = (MoveType) (MoveType::Capture | promotionFlag);
             Bitboard attacks = MoveTables::GetPawnAttacks(color, fromSquareIndex);
-            auto captures = ExtractMoves(attacks & enemyOccupancies, fromSquareIndex, attackMoveFlags, utilities);
-            moveList.splice(moveList.end(), captures);
+            ExtractMoves(attacks & enemyOccupancies, fromSquareIndex, attackMoveFlags, utilities, moveList);
 
             pawnsBoard = PopBit(pawnsBoard, fromSquareIndex);
         }
-
-        return moveList;
     }
 
-    std::list<Move> GetEnPassantMoves(const BoardState &state, Color color, const BoardOccupancies& utilities) {
-        std::list<Move> moveList;
+    void GetEnPassantMoves(const BoardState &state, Color color, const BoardOccupancies& utilities, MoveList& moveList) {
         Color enemyColor = InvertColor(color);
 
         uint8_t enPassantIndex = GetLSBIndex(state.enPassantBoard);
@@ -139,17 +123,14 @@ namespace ChessEngine::MoveGeneration::Pseudo {
                              .selfType = PieceType::Pawn,
                              .enemyType = PieceType::Pawn};
 
-                moveList.push_back(move);
+                moveList.Add(move);
 
                 enPassantPieces = PopBit(enPassantPieces, fromSquareIndex);
             }
         }
-
-        return moveList;
     }
 
-    std::list<Move> GetCastlingMoves(const BoardState &state, Color color, const BoardOccupancies& utilities) {
-        std::list<Move> moveList;
+    void GetCastlingMoves(const BoardState &state, Color color, const BoardOccupancies& utilities, MoveList& moveList) {
         // Check whether or not there are pieces between the king and the rook.
         Bitboard globalOccupancies = utilities.occupancies[Color::Both];
         Bitboard colorMask = (color == Color::White) ? r1_Mask : r8_Mask;
@@ -161,7 +142,7 @@ namespace ChessEngine::MoveGeneration::Pseudo {
                         .toSquareIndex = GetLSBIndex(kingsCastlePosBoard & colorMask),
                         .flags = MoveType::KingSideCastling};
 
-                moveList.push_back(move);
+                moveList.Add(move);
             }
         }
         if (state.queenSideCastling[color]) {
@@ -171,15 +152,12 @@ namespace ChessEngine::MoveGeneration::Pseudo {
                         .toSquareIndex = GetLSBIndex(queenCastlePosBoard & colorMask),
                         .flags = MoveType::QueenSideCastling};
 
-                moveList.push_back(move);
+                moveList.Add(move);
             }
         }
-
-        return moveList;
     }
 
-    std::list<Move> GetKnightMoves(const BoardState &state, Color color, const BoardOccupancies& utilities) {
-        std::list<Move> moveList;
+    void GetKnightMoves(const BoardState &state, Color color, const BoardOccupancies& utilities, MoveList& moveList) {
         Color enemyColor = InvertColor(color);
         Bitboard enemyOccupancies = utilities.occupancies[enemyColor];
         Bitboard globalOccupancies = utilities.occupancies[Color::Both];
@@ -192,22 +170,17 @@ namespace ChessEngine::MoveGeneration::Pseudo {
             Bitboard moves = MoveTables::GetKnightMoves(fromSquareIndex);
 
             // Quiet moves
-            auto quietMoves = ExtractMoves(moves & ~globalOccupancies, fromSquareIndex, MoveType::Quiet, utilities);
-            moveList.splice(moveList.end(), quietMoves);
+            ExtractMoves(moves & ~globalOccupancies, fromSquareIndex, MoveType::Quiet, utilities, moveList);
 
             // Captures
-            auto captures = ExtractMoves(moves & enemyOccupancies, fromSquareIndex, MoveType::Capture, utilities);
-            moveList.splice(moveList.end(), captures);
+            ExtractMoves(moves & enemyOccupancies, fromSquareIndex, MoveType::Capture, utilities, moveList);
 
 
             knightsBoard = PopBit(knightsBoard, fromSquareIndex);
         }
-
-        return moveList;
     }
 
-    std::list<Move> GetKingMoves(const BoardState &state, Color color, const BoardOccupancies& utilities) {
-        std::list<Move> moveList;
+    void GetKingMoves(const BoardState &state, Color color, const BoardOccupancies& utilities, MoveList& moveList) {
         Color enemyColor = InvertColor(color);
         Bitboard enemyOccupancies = utilities.occupancies[enemyColor];
         Bitboard globalOccupancies = utilities.occupancies[Color::Both];
@@ -219,20 +192,15 @@ namespace ChessEngine::MoveGeneration::Pseudo {
             Bitboard moves = MoveTables::GetKingMoves(fromSquareIndex);
 
             // Quiet moves
-            auto quietMoves = ExtractMoves(moves & ~globalOccupancies, fromSquareIndex, MoveType::Quiet, utilities);
-            moveList.splice(moveList.end(), quietMoves);
+            ExtractMoves(moves & ~globalOccupancies, fromSquareIndex, MoveType::Quiet, utilities, moveList);
 
             // Captures
-            auto captures = ExtractMoves(moves & enemyOccupancies, fromSquareIndex, MoveType::Capture, utilities);
-            moveList.splice(moveList.end(), captures);
+            ExtractMoves(moves & enemyOccupancies, fromSquareIndex, MoveType::Capture, utilities, moveList);
 
         }
-
-        return moveList;
     }
 
-    std::list<Move> GetSlidingMoves(const BoardState &state, Color color, PieceType type, const BoardOccupancies& utilities) {
-        std::list<Move> moveList;
+    void GetSlidingMoves(const BoardState &state, Color color, PieceType type, const BoardOccupancies& utilities, MoveList& moveList) {
         Color enemyColor = InvertColor(color);
         Bitboard enemyOccupancies = utilities.occupancies[enemyColor];
         Bitboard globalOccupancies = utilities.occupancies[Color::Both];
@@ -253,55 +221,40 @@ namespace ChessEngine::MoveGeneration::Pseudo {
             Bitboard moves = getMoves(fromSquareIndex, globalOccupancies);
 
             // Quiet moves
-            auto quietMoves = ExtractMoves(moves & ~globalOccupancies, fromSquareIndex, MoveType::Quiet, utilities);
-            moveList.splice(moveList.end(), quietMoves);
+            ExtractMoves(moves & ~globalOccupancies, fromSquareIndex, MoveType::Quiet, utilities, moveList);
 
             // Captures
-            auto captures = ExtractMoves(moves & enemyOccupancies, fromSquareIndex, MoveType::Capture, utilities);
-            moveList.splice(moveList.end(), captures);
+            ExtractMoves(moves & enemyOccupancies, fromSquareIndex, MoveType::Capture, utilities, moveList);
 
             slidingPieceBoard = PopBit(slidingPieceBoard, fromSquareIndex);
         }
-
-        return moveList;
     }
 
-    std::list<Move> GetPseudoMoves(const BoardState &state, Color color, const BoardOccupancies& utilities) {
-        std::list<Move> moveList;
+    void GetPseudoMoves(const BoardState &state, Color color, const BoardOccupancies& utilities, MoveList& moveList) {
 
         // Pawns.
-        auto pawnMoves = GetPawnMoves(state, color, utilities);
-        moveList.splice(moveList.end(), pawnMoves);
+        GetPawnMoves(state, color, utilities, moveList);
 
         // King.
-        auto kingMoves = GetKingMoves(state, color, utilities);
-        moveList.splice(moveList.end(), kingMoves);
+        GetKingMoves(state, color, utilities, moveList);
 
         // Knight.
-        auto knightMoves = GetKnightMoves(state, color, utilities);
-        moveList.splice(moveList.end(), knightMoves);
+        GetKnightMoves(state, color, utilities, moveList);
 
         // Castling.
-        auto castlingMoves = GetCastlingMoves(state, color, utilities);
-        moveList.splice(moveList.end(), castlingMoves);
+        GetCastlingMoves(state, color, utilities, moveList);
 
         // En passant.
-        auto enPassantMoves = GetEnPassantMoves(state, color, utilities);
-        moveList.splice(moveList.end(), enPassantMoves);
+        GetEnPassantMoves(state, color, utilities, moveList);
 
         // rook.
-        auto rookMoves = GetSlidingMoves(state, color, PieceType::Rook, utilities);
-        moveList.splice(moveList.end(), rookMoves);
+        GetSlidingMoves(state, color, PieceType::Rook, utilities, moveList);
 
         // Bishop.
-        auto bishopMoves = GetSlidingMoves(state, color, PieceType::Bishop, utilities);
-        moveList.splice(moveList.end(), bishopMoves);
+        GetSlidingMoves(state, color, PieceType::Bishop, utilities, moveList);
 
         // Queen.
-        auto queenMoves = GetSlidingMoves(state, color, PieceType::Queen, utilities);
-        moveList.splice(moveList.end(), queenMoves);
-
-        return moveList;
+        GetSlidingMoves(state, color, PieceType::Queen, utilities, moveList);
     }
 
 }
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "RandomMove.h"
+
+#include "MoveTables.h"
+#include "LeaperPieces.h"
+#include "MoveGeneration.h"
+
+namespace ChessEngine::MoveGeneration {
+
+    using namespace BitboardUtil;
+
+    uint64_t NextRandom(uint64_t& seed) {
+        seed ^= seed >> 12;
+        seed ^= seed << 25;
+        seed ^= seed >> 27;
+        return seed * 0x2545F4914F6CDD1DULL;
+    }
+
+    static void AddMoves(Bitboard targets, uint8_t fromSquareIndex, PieceType selfType, MoveType flags,
+                         const BoardOccupancies& boardOccupancies, Move* moves, int& count) {
+        while (targets != 0) {
+            uint8_t toSquareIndex = GetLSBIndex(targets);
+            auto enemyType = std::get<0>(boardOccupancies.squaresOccupants[toSquareIndex]);
+
+            Move move = {
+                    .fromSquareIndex = fromSquareIndex,
+                    .toSquareIndex = toSquareIndex,
+                    .flags = flags,
+                    .selfType = selfType,
+                    .enemyType = enemyType,
+                    .promotionType = PieceType::None
+            };
+
+            if (IsMoveType(flags, MoveType::Promotion)) {
+                for (PieceType promotionType : {PieceType::Queen, PieceType::Knight, PieceType::Rook, PieceType::Bishop}) {
+                    move.promotionType = promotionType;
+                    moves[count++] = move;
+                }
+            } else {
+                moves[count++] = move;
+            }
+
+            targets = PopBit(targets, toSquareIndex);
+        }
+    }
+
+    int GetPseudoMoves(const BoardState& state, Color color, const BoardOccupancies& boardOccupancies, Move (&moves)[maxPseudoMoves]) {
+        int count = 0;
+        Bitboard enemyOccupancies = boardOccupancies.occupancies[InvertColor(color)];
+        Bitboard globalOccupancies = boardOccupancies.occupancies[Color::Both];
+
+        // Pawns.
+        Bitboard pawns = state.pieceBoards[color][PieceType::Pawn];
+        Bitboard promotionRank = (color == Color::White) ? r7_Mask : r2_Mask;
+        while (pawns != 0) {
+            uint8_t fromSquareIndex = GetLSBIndex(pawns);
+            Bitboard pawn = SetBit(BITBOARD_EMPTY, fromSquareIndex);
+            auto promotionFlag = (pawn & promotionRank) ? MoveType::Promotion : MoveType::None;
+
+            Bitboard singlePushes = LeaperPieces::GetPawnPushes(pawn, color) & ~globalOccupancies;
+            AddMoves(singlePushes, fromSquareIndex, PieceType::Pawn, (MoveType) (MoveType::Quiet | promotionFlag), boardOccupancies, moves, count);
+
+            Bitboard doublePushes = LeaperPieces::GetDoublePawnPushes(pawn, globalOccupancies, color) & ~globalOccupancies;
+            AddMoves(doublePushes, fromSquareIndex, PieceType::Pawn, (MoveType) (MoveType::Quiet | MoveType::EnPassant), boardOccupancies, moves, count);
+
+            Bitboard captures = MoveTables::GetPawnAttacks(color, fromSquareIndex) & enemyOccupancies;
+            AddMoves(captures, fromSquareIndex, PieceType::Pawn, (MoveType) (MoveType::Capture | promotionFlag), boardOccupancies, moves, count);
+
+            pawns = PopBit(pawns, fromSquareIndex);
+        }
+
+        // En passant , the possible attackers are the pawn attacks of the en passant square.
+        if (state.enPassantBoard != BITBOARD_EMPTY) {
+            uint8_t enPassantIndex = GetLSBIndex(state.enPassantBoard);
+            Bitboard attackers = MoveTables::GetPawnAttacks(InvertColor(color), enPassantIndex) & state.pieceBoards[color][PieceType::Pawn];
+            while (attackers != 0) {
+                uint8_t fromSquareIndex = GetLSBIndex(attackers);
+                moves[count++] = {.fromSquareIndex = fromSquareIndex,
+                                  .toSquareIndex = enPassantIndex,
+                                  .flags = (MoveType) (MoveType::Capture | MoveType::EnPassant),
+                                  .selfType = PieceType::Pawn,
+                                  .enemyType = PieceType::Pawn,
+                                  .promotionType = PieceType::None};
+                attackers = PopBit(attackers, fromSquareIndex);
+            }
+        }
+
+        // Castling.
+        Bitboard colorMask = (color == Color::White) ? r1_Mask : r8_Mask;
+        if (state.kingSideCastling[color] && (colorMask & kingSideCastling_Mask & globalOccupancies) == 0) {
+            moves[count++] = {.fromSquareIndex = GetLSBIndex(kingsStartingPosBoard & colorMask),
+                              .toSquareIndex = GetLSBIndex(kingsCastlePosBoard & colorMask),
+                              .flags = MoveType::KingSideCastling,
+                              .selfType = PieceType::King,
+                              .enemyType = PieceType::None,
+                              .promotionType = PieceType::None};
+        }
+        if (state.queenSideCastling[color] && (colorMask & queenSideCastling_Mask & globalOccupancies) == 0) {
+            moves[count++] = {.fromSquareIndex = GetLSBIndex(kingsStartingPosBoard & colorMask),
+                              .toSquareIndex = GetLSBIndex(queenCastlePosBoard & colorMask),
+                              .flags = MoveType::QueenSideCastling,
+                              .selfType = PieceType::King,
+                              .enemyType = PieceType::None,
+                              .promotionType = PieceType::None};
+        }
+
+        // Pieces.
+        for (PieceType type : {PieceType::King, PieceType::Knight, PieceType::Rook, PieceType::Bishop, PieceType::Queen}) {
+            Bitboard pieces = state.pieceBoards[color][type];
+            while (pieces != 0) {
+                uint8_t fromSquareIndex = GetLSBIndex(pieces);
+
+                Bitboard targets;
+                switch (type) {
+                    case PieceType::King: targets = MoveTables::GetKingMoves(fromSquareIndex); break;
+                    case PieceType::Knight: targets = MoveTables::GetKnightMoves(fromSquareIndex); break;
+                    case PieceType::Rook: targets = MoveTables::GetRookMoves(fromSquareIndex, globalOccupancies); break;
+                    case PieceType::Bishop: targets = MoveTables::GetBishopMoves(fromSquareIndex, globalOccupancies); break;
+                    default: targets = MoveTables::GetQueenMoves(fromSquareIndex, globalOccupancies); break;
+                }
+
+                AddMoves(targets & ~globalOccupancies, fromSquareIndex, type, MoveType::Quiet, boardOccupancies, moves, count);
+                AddMoves(targets & enemyOccupancies, fromSquareIndex, type, MoveType::Capture, boardOccupancies, moves, count);
+
+                pieces = PopBit(pieces, fromSquareIndex);
+            }
+        }
+
+        return count;
+    }
+
+    bool GetRandomMove(const BoardState& state, Color color, const BoardOccupancies& boardOccupancies, uint64_t& seed, Move& move) {
+        Move moves[maxPseudoMoves];
+        int count = GetPseudoMoves(state, color, boardOccupancies, moves);
+
+        while (count > 0) {
+            int index = (int) (NextRandom(seed) % (uint64_t) count);
+            if (IsValid(moves[index], state, color, boardOccupancies)) {
+                move = moves[index];
+                return true;
+            }
+
+            // Drop the invalid move and pick again among the rest.
+            moves[index] = moves[--count];
+        }
+
+        return false;
+    }
+
+}
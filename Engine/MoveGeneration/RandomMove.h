@@ -0,0 +1,24 @@
+#ifndef RANDOM_MOVE_H
+#define RANDOM_MOVE_H
+
+#include "Move.h"
+#include "MoveList.h"
+#include "../Board/BoardState.h"
+#include "../Board/BoardOccupancies.h"
+
+namespace ChessEngine::MoveGeneration {
+
+    /* xorshift64* , every thread should keep its own seed. */
+    uint64_t NextRandom(uint64_t& seed);
+
+    /* Writes the pseudo moves straight from the move tables into a fixed array , no lists involved.
+     * Same moves as Pseudo::GetPseudoMoves. Returns the number of moves. */
+    int GetPseudoMoves(const BoardState& state, Color color, const BoardOccupancies& boardOccupancies, Move (&moves)[maxPseudoMoves]);
+
+    /* Picks a uniformly random valid move. Only the picked moves are checked for validity ,
+     * invalid ones are dropped and another one is picked. Returns false if there are no valid moves. */
+    bool GetRandomMove(const BoardState& state, Color color, const BoardOccupancies& boardOccupancies, uint64_t& seed, Move& move);
+
+}
+
+#endif
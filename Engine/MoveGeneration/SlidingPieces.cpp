@@ -123,7 +123,7 @@ namespace ChessEngine::MoveGeneration::SlidingPieces {
 
     /* Initialize the move array for each square by calculating each occupancy
      * permutation (key) and its corresponding attack (value) , creating an almost perfect hash */
-    void InitSlidingMoves(std::array<Bitboard, permutations>& slidingMoves, uint8_t squareIndex, bool forBishop){
+    void InitSlidingMoves(Bitboard* slidingMoves, uint8_t squareIndex, bool forBishop){
         auto [file, rank] = GetCoordinates(squareIndex);
 
         Bitboard blockerMask = forBishop ? bishopMasks[squareIndex] : rookMasks[squareIndex];
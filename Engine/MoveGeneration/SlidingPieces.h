@@ -36,7 +36,8 @@ namespace ChessEngine::MoveGeneration::SlidingPieces {
     BitboardUtil::Bitboard GetBishopBlockerMask(uint8_t file, uint8_t rank);
     BitboardUtil::Bitboard GetBishopMoves(uint8_t file, uint8_t rank, BitboardUtil::Bitboard occupancies);
 
-    void InitSlidingMoves(std::array<BitboardUtil::Bitboard, MagicNumbers::permutations>& slidingMoves, uint8_t squareIndex, bool forBishop);
+    /* slidingMoves holds MagicNumbers::permutations entries. */
+    void InitSlidingMoves(BitboardUtil::Bitboard* slidingMoves, uint8_t squareIndex, bool forBishop);
 
     /*******************************************************/
     /* Attack masks                                        */
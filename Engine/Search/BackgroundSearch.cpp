@@ -0,0 +1,71 @@
+#include "BackgroundSearch.h"
+
+namespace ChessEngine::Search {
+
+    BackgroundSearch::BackgroundSearch(TranspositionTable& transpositionTable)
+        : transpositionTable(transpositionTable) {}
+
+    BackgroundSearch::~BackgroundSearch() {
+        Stop();
+    }
+
+    void BackgroundSearch::Prepare(const Board& board, bool ponder) {
+        Stop();
+
+        signals.stop.store(false);
+        signals.ponderHit.store(false);
+        signals.ponder.store(ponder);
+        finished.store(false);
+
+        positionKey = board.GetState().hashKey;
+        pondering = ponder;
+    }
+
+    void BackgroundSearch::Start(const Board& board, const SearchLimits& limits, const PruningOptions& pruning, bool ponder) {
+        Prepare(board, ponder);
+
+        // The board and options are copied , the caller is free to change them.
+        worker = std::thread([this, board, limits, pruning]() {
+            result = Search(board, limits, pruning, transpositionTable, signals);
+            finished.store(true, std::memory_order_release);
+        });
+    }
+
+    void BackgroundSearch::Start(const Board& board, const SearchLimits& limits, const MonteCarloOptions& options, bool ponder) {
+        Prepare(board, ponder);
+
+        worker = std::thread([this, board, limits, options]() {
+            result = MonteCarloSearch(board, limits, options, signals);
+            finished.store(true, std::memory_order_release);
+        });
+    }
+
+    void BackgroundSearch::PonderHit(const TimeControl& time) {
+        if (!pondering)
+            return;
+
+        pondering = false;
+        signals.ponderHitTime = time;
+        signals.ponderHit.store(true, std::memory_order_release);
+    }
+
+    void BackgroundSearch::Stop() {
+        if (!worker.joinable())
+            return;
+
+        signals.stop.store(true);
+        worker.join();
+
+        result = {};
+        pondering = false;
+    }
+
+    SearchResult BackgroundSearch::Wait() {
+        if (worker.joinable())
+            worker.join();
+
+        pondering = false;
+        return result;
+    }
+
+}
@@ -0,0 +1,61 @@
+#ifndef BACKGROUND_SEARCH_H
+#define BACKGROUND_SEARCH_H
+
+#include <atomic>
+#include <thread>
+
+#include "Search.h"
+#include "MonteCarlo.h"
+
+namespace ChessEngine::Search {
+
+    /* Runs a search in a worker thread so the caller (eg: the gui) isn't blocked.
+     * Also used for pondering , searching the expected reply during the opponent's turn. */
+    class BackgroundSearch {
+    public:
+        explicit BackgroundSearch(TranspositionTable& transpositionTable);
+        ~BackgroundSearch();
+
+        BackgroundSearch(const BackgroundSearch&) = delete;
+        BackgroundSearch& operator=(const BackgroundSearch&) = delete;
+
+        /* Stops any running search and starts searching the given position.
+         * A ponder search ignores the time limits until PonderHit is called. */
+        void Start(const Board& board, const SearchLimits& limits, const PruningOptions& pruning, bool ponder);
+        /* Same as above with a Monte Carlo tree search instead of alpha beta. */
+        void Start(const Board& board, const SearchLimits& limits, const MonteCarloOptions& options, bool ponder);
+
+        /* The expected reply was played , continue as a normal timed search. */
+        void PonderHit(const TimeControl& time);
+
+        /* Stops the search and discards its result. */
+        void Stop();
+
+        /* Waits for the search to finish and returns its result. */
+        SearchResult Wait();
+
+        bool IsRunning() const { return worker.joinable(); }
+        bool IsFinished() const { return finished.load(std::memory_order_acquire); }
+        bool IsPondering() const { return IsRunning() && pondering; }
+
+        /* Hash of the position being searched. */
+        uint64_t GetPositionKey() const { return positionKey; }
+
+    private:
+        /* Stops any running search and resets the signals for a new one. */
+        void Prepare(const Board& board, bool ponder);
+
+        TranspositionTable& transpositionTable;
+
+        std::thread worker;
+        SearchSignals signals;
+        std::atomic<bool> finished = false;
+
+        SearchResult result;
+        uint64_t positionKey = 0;
+        bool pondering = false;
+    };
+
+}
+
+#endif
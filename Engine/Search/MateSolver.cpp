@@ -0,0 +1,377 @@
+#include "MateSolver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <memory>
+
+#include "../MoveGeneration/MoveGeneration.h"
+#include "../MoveGeneration/Draw.h"
+#include "Search.h"
+#include "SearchHelpers.h"
+
+namespace ChessEngine::Search {
+
+    using namespace BitboardUtil;
+    using namespace MoveGeneration;
+
+    // The numbers are kept from the point of view of the side to move (phi / delta):
+    // phi is the proof number when the attacker moves and the disproof number when the defender moves.
+    // A phi of 0 means the side to move wins , a delta of 0 means it loses.
+    constexpr uint32_t infiniteNumber = 1u << 28;
+
+    // Limit of the results that hold from anywhere.
+    constexpr uint16_t unlimitedPlies = 0xFFFF;
+
+    /*******************************************************/
+    /* Proof number table                                  */
+    /*******************************************************/
+
+    struct ProofEntry {
+        uint64_t key = 0;
+        uint32_t phi = 1;
+        uint32_t delta = 1;
+        uint16_t distance = 0; // Plies to the end of the game once solved.
+        // A failed mate attempt that ran into the ply limit or a repetition only holds with at most
+        // this many plies left , with more the position is searched again. Mates always hold.
+        uint16_t limit = unlimitedPlies;
+        uint64_t work = 0; // Nodes searched below , deeper work is replaced last.
+    };
+
+    /* Buckets of 2 , the first entry keeps the most work and the second is always replaced. */
+    class ProofTable {
+    public:
+        explicit ProofTable(size_t megabytes) {
+            size_t maxBuckets = std::max<size_t>(megabytes * 1024 * 1024 / sizeof(Bucket), 1);
+            bucketCount = 1;
+            while (bucketCount * 2 <= maxBuckets)
+                bucketCount *= 2;
+
+            buckets.resize(bucketCount);
+        }
+
+        bool Probe(uint64_t key, ProofEntry& entry) const {
+            const Bucket& bucket = buckets[key & (bucketCount - 1)];
+            for (auto& slot : bucket.slots) {
+                if (slot.key == key && slot.work != 0) {
+                    entry = slot;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void Store(const ProofEntry& entry) {
+            Bucket& bucket = buckets[entry.key & (bucketCount - 1)];
+            for (auto& slot : bucket.slots) {
+                if (slot.key == entry.key) {
+                    slot = entry;
+                    return;
+                }
+            }
+
+            if (entry.work >= bucket.slots[0].work) {
+                bucket.slots[1] = bucket.slots[0];
+                bucket.slots[0] = entry;
+            } else {
+                bucket.slots[1] = entry;
+            }
+        }
+
+    private:
+        struct Bucket {
+            ProofEntry slots[2];
+        };
+
+        std::vector<Bucket> buckets;
+        size_t bucketCount = 0;
+    };
+
+    /*******************************************************/
+    /* Search                                              */
+    /*******************************************************/
+
+    struct SolverChild {
+        Move move;
+        Board board;
+    };
+
+    struct MateSolver {
+        ProofTable table;
+        const MateSolverOptions& options;
+        Color attacker;
+
+        uint64_t nodes = 0;
+        bool aborted = false;
+
+        std::vector<uint64_t> path; // Keys of the positions leading to the current one.
+
+        MateSolver(const MateSolverOptions& options, Color attacker)
+            : table(options.hashMegabytes), options(options), attacker(attacker) {}
+    };
+
+    static uint32_t AddNumbers(uint32_t a, uint32_t b) {
+        return std::min(a + b, infiniteNumber);
+    }
+
+    static int GetRemainingPlies(const MateSolver& solver, size_t ply) {
+        return std::max(solver.options.maxPly - (int) ply, 0);
+    }
+
+    static bool IsSolved(const ProofEntry& entry) {
+        return entry.phi == 0 || entry.delta == 0;
+    }
+
+    /* The entry of a position reached with remaining plies left , results that don't hold that far are dropped. */
+    static ProofEntry Lookup(const MateSolver& solver, uint64_t key, int remaining) {
+        ProofEntry entry;
+        if (!solver.table.Probe(key, entry) || (IsSolved(entry) && entry.limit < remaining)) {
+            entry = {};
+            entry.key = key;
+        }
+        return entry;
+    }
+
+    /* Checks for the attacker , every valid move (all of them evasions) for the defender. */
+    static std::vector<SolverChild> GenerateChildren(const MateSolver& solver, const Board& board) {
+        const BoardState& state = board.GetState();
+        auto moves = GetValidMoves(state, state.turnOf, board.GetOccupancies());
+        bool isAttacker = state.turnOf == solver.attacker;
+
+        std::vector<SolverChild> children;
+        children.reserve(moves.size());
+        for (auto& move : moves) {
+            SolverChild child = {move, board};
+            MakeMove(move, state.turnOf, child.board.GetState(), child.board.GetOccupancies());
+            if (isAttacker && !InCheck(child.board))
+                continue;
+            children.push_back(child);
+        }
+
+        return children;
+    }
+
+    /* Distance and limit of a solved node. The winner takes the shortest way and the loser the longest ,
+     * a failed mate attempt holds as far as the result it rests on (the defender's best refutation ,
+     * the attacker's shortest lasting try). */
+    static void SetSolved(const MateSolver& solver, const std::vector<SolverChild>& children, int childRemaining,
+                          bool isAttacker, ProofEntry& entry) {
+        bool won = entry.phi == 0;
+        int distance = won ? maxPly : 0;
+        int limit = isAttacker ? unlimitedPlies : 0;
+        for (auto& child : children) {
+            ProofEntry childEntry = Lookup(solver, child.board.GetState().hashKey, childRemaining);
+            if (won && childEntry.delta == 0) {
+                distance = std::min<int>(distance, childEntry.distance);
+                limit = std::max<int>(limit, childEntry.limit);
+            } else if (!won) {
+                distance = std::max<int>(distance, childEntry.distance);
+                limit = std::min<int>(limit, childEntry.limit);
+            }
+        }
+
+        entry.distance = (uint16_t) (distance + 1);
+        bool attackerFailed = isAttacker != won;
+        entry.limit = (!attackerFailed || limit == unlimitedPlies) ? unlimitedPlies : (uint16_t) (limit + 1);
+    }
+
+    /* A leaf won or lost for the side to move , limited when the result depends on the path. */
+    static void StoreSolved(MateSolver& solver, ProofEntry& entry, bool won, uint16_t limit = unlimitedPlies) {
+        entry.phi = won ? 0 : infiniteNumber;
+        entry.delta = won ? infiniteNumber : 0;
+        entry.distance = 0;
+        entry.limit = limit;
+        entry.work = std::max<uint64_t>(entry.work, 1);
+        solver.table.Store(entry);
+    }
+
+    static void MultipleIterativeDeepening(MateSolver& solver, const Board& board, uint32_t thresholdPhi, uint32_t thresholdDelta) {
+        const BoardState& state = board.GetState();
+        uint64_t startNodes = solver.nodes++;
+        if (solver.options.maxNodes != 0 && solver.nodes > solver.options.maxNodes) {
+            solver.aborted = true;
+            return;
+        }
+
+        int remaining = GetRemainingPlies(solver, solver.path.size());
+        ProofEntry entry = Lookup(solver, state.hashKey, remaining);
+
+        // Repetitions , draws and lines past the ply limit are lost for the attacker.
+        // Repetitions and the ply limit depend on the path , they are stored limited to the
+        // plies left so the parent sees the result but positions reached with more plies left
+        // search again (repetitions stay the usual graph history approximation).
+        bool isAttacker = state.turnOf == solver.attacker;
+        bool onPath = std::find(solver.path.begin(), solver.path.end(), state.hashKey) != solver.path.end();
+        if (onPath) {
+            StoreSolved(solver, entry, !isAttacker, (uint16_t) remaining);
+            return;
+        }
+        if (Draw::InsufficientMaterial(state) || Draw::TablebaseDraw(state)) {
+            StoreSolved(solver, entry, !isAttacker);
+            return;
+        }
+
+        auto children = GenerateChildren(solver, board);
+        if (children.empty()) {
+            // The attacker has no checks or the defender is mated , the side to move lost.
+            StoreSolved(solver, entry, false);
+            return;
+        }
+
+        if (remaining == 0) {
+            StoreSolved(solver, entry, !isAttacker, 0);
+            return;
+        }
+
+        int childRemaining = remaining - 1;
+        solver.path.push_back(state.hashKey);
+        while (true) {
+            // phi is the smallest delta of the children , delta the sum of their phi.
+            uint32_t phi = infiniteNumber;
+            uint32_t delta = 0;
+            uint32_t bestDelta = infiniteNumber;
+            uint32_t secondDelta = infiniteNumber;
+            uint32_t bestPhi = 0;
+            size_t bestChild = 0;
+            for (size_t i = 0; i < children.size(); i++) {
+                ProofEntry childEntry = Lookup(solver, children[i].board.GetState().hashKey, childRemaining);
+                phi = std::min(phi, childEntry.delta);
+                delta = AddNumbers(delta, childEntry.phi);
+
+                if (childEntry.delta < bestDelta) {
+                    secondDelta = bestDelta;
+                    bestDelta = childEntry.delta;
+                    bestPhi = childEntry.phi;
+                    bestChild = i;
+                } else if (childEntry.delta < secondDelta) {
+                    secondDelta = childEntry.delta;
+                }
+            }
+
+            entry.phi = phi;
+            entry.delta = delta;
+            if (phi >= thresholdPhi || delta >= thresholdDelta || solver.aborted)
+                break;
+
+            // The most promising child gets the thresholds that keep it the most promising.
+            uint64_t childPhi = std::min<uint64_t>((uint64_t) thresholdDelta + bestPhi - delta, infiniteNumber);
+            uint32_t childDelta = std::min(thresholdPhi, AddNumbers(secondDelta, 1));
+            MultipleIterativeDeepening(solver, children[bestChild].board, (uint32_t) childPhi, childDelta);
+        }
+        solver.path.pop_back();
+
+        if (IsSolved(entry))
+            SetSolved(solver, children, childRemaining, isAttacker, entry);
+
+        entry.work = solver.nodes - startNodes;
+        if (!solver.aborted)
+            solver.table.Store(entry);
+    }
+
+    static ProofEntry LookupSolved(MateSolver& solver, const Board& board, const std::vector<uint64_t>& path) {
+        int remaining = GetRemainingPlies(solver, path.size());
+        ProofEntry entry = Lookup(solver, board.GetState().hashKey, remaining);
+        if (!IsSolved(entry)) {
+            solver.path = path;
+            MultipleIterativeDeepening(solver, board, infiniteNumber, infiniteNumber);
+            entry = Lookup(solver, board.GetState().hashKey, remaining);
+        }
+        return entry;
+    }
+
+    /* Follows the solved positions , the attacker picks the fastest mate and the defender the
+     * slowest. Positions that were replaced in the table are solved again. */
+    static std::vector<Move> ExtractLine(MateSolver& solver, const Board& board) {
+        std::vector<Move> line;
+        std::vector<uint64_t> path;
+        Board position = board;
+
+        while ((int) line.size() < solver.options.maxPly && !solver.aborted) {
+            auto children = GenerateChildren(solver, position);
+            if (children.empty())
+                break;
+
+            path.push_back(position.GetState().hashKey);
+            bool isAttacker = position.GetState().turnOf == solver.attacker;
+
+            const SolverChild* next = nullptr;
+            int nextDistance = 0;
+            for (auto& child : children) {
+                ProofEntry entry = Lookup(solver, child.board.GetState().hashKey, GetRemainingPlies(solver, path.size()));
+                if (!isAttacker)
+                    entry = LookupSolved(solver, child.board, path);
+
+                if (isAttacker && entry.delta == 0 && (!next || entry.distance < nextDistance)) {
+                    next = &child;
+                    nextDistance = entry.distance;
+                } else if (!isAttacker && (!next || entry.distance > nextDistance)) {
+                    next = &child;
+                    nextDistance = entry.distance;
+                }
+            }
+
+            // The proven replies were replaced , solve them again until one is found.
+            for (size_t i = 0; isAttacker && !next && i < children.size(); i++) {
+                ProofEntry entry = LookupSolved(solver, children[i].board, path);
+                if (entry.delta == 0)
+                    next = &children[i];
+            }
+
+            if (!next)
+                break;
+
+            line.push_back(next->move);
+            position = next->board;
+        }
+
+        return line;
+    }
+
+    static MateSolution Solve(const Board& board, const MateSolverOptions& options) {
+        MateSolution solution;
+
+        // The solver holds the table , keep it off the stack.
+        auto solver = std::make_unique<MateSolver>(options, board.GetState().turnOf);
+        MultipleIterativeDeepening(*solver, board, infiniteNumber, infiniteNumber);
+
+        ProofEntry root = Lookup(*solver, board.GetState().hashKey, options.maxPly);
+        if (!solver->aborted && root.phi == 0) {
+            solution.line = ExtractLine(*solver, board);
+            solution.result = solver->aborted ? MateResult::Unknown : MateResult::Mate;
+            // From the proof , the line can come out short when the table lost some of it.
+            solution.mateLength = (root.distance + 1) / 2;
+        } else if (!solver->aborted && root.delta == 0) {
+            solution.result = MateResult::NoMate;
+        }
+
+        solution.nodes = solver->nodes;
+        return solution;
+    }
+
+    MateSolution SolveMate(const Board& board, const MateSolverOptions& options) {
+        auto start = std::chrono::steady_clock::now();
+        MateSolution solution = Solve(board, options);
+
+        // Proof number search finds a mate , not the shortest one. Look for
+        // shorter mates with the line length limited , shortest first.
+        for (int length = 1; options.shortestMate && solution.result == MateResult::Mate && length < solution.mateLength; length++) {
+            MateSolverOptions limited = options;
+            limited.maxPly = 2 * length - 1;
+            if (options.maxNodes != 0)
+                limited.maxNodes = (options.maxNodes > solution.nodes) ? options.maxNodes - solution.nodes : 1;
+
+            MateSolution shorter = Solve(board, limited);
+            solution.nodes += shorter.nodes;
+            if (shorter.result == MateResult::Mate) {
+                shorter.nodes = solution.nodes;
+                solution = shorter;
+                break;
+            }
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        solution.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        return solution;
+    }
+
+}
@@ -0,0 +1,45 @@
+#ifndef MATE_SOLVER_H
+#define MATE_SOLVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../Board/Board.h"
+#include "../MoveGeneration/Move.h"
+
+namespace ChessEngine::Search {
+
+    struct MateSolverOptions {
+        uint64_t maxNodes = 10000000; // The result is Unknown once exceeded.
+        size_t hashMegabytes = 16;
+        int maxPly = 64; // Lines longer than this count as no mate.
+
+        // Once a mate is found , search again for shorter ones.
+        bool shortestMate = true;
+    };
+
+    enum class MateResult {
+        Mate, NoMate, Unknown
+    };
+
+    struct MateSolution {
+        MateResult result = MateResult::Unknown;
+
+        // In moves of the side to move , a mate in 1 is 1. Without shortestMate it may not be the shortest mate.
+        int mateLength = 0;
+        std::vector<MoveGeneration::Move> line; // Ends with the mating move.
+
+        uint64_t nodes = 0;
+        int64_t timeMs = 0;
+    };
+
+    /* Depth first proof number search (df-pn) for a mate by the side to move. The attacker
+     * only plays checks and the defender tries every evasion , so NoMate means there is no
+     * mate made of checks only. Proof and disproof numbers are kept in a fixed size table.
+     * Each call has its own table , separate calls can run on separate threads. */
+    MateSolution SolveMate(const Board& board, const MateSolverOptions& options);
+
+}
+
+#endif
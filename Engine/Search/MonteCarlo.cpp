@@ -0,0 +1,416 @@
+#include "MonteCarlo.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <thread>
+
+#include "../MoveGeneration/MoveGeneration.h"
+#include "../MoveGeneration/RandomMove.h"
+#include "../MoveGeneration/Draw.h"
+#include "../Evaluation/Evaluation.h"
+#include "../Utilities/Memory.h"
+#include "SearchHelpers.h"
+
+namespace ChessEngine::Search {
+
+    using namespace BitboardUtil;
+    using namespace MoveGeneration;
+
+    /*******************************************************/
+    /* Tree                                                */
+    /*******************************************************/
+
+    // Playout results are kept in fixed point so they can be summed atomically.
+    constexpr uint64_t valueUnit = 1 << 16;
+
+    // Evaluations and win rates are converted with the same logistic curve.
+    constexpr double centipawnScale = 400.0;
+
+    // Clock reads and stop checks happen every few playouts.
+    constexpr uint64_t playoutPollMask = 15;
+
+    // Searches without a playout limit , a depth reached or a clock to stop them.
+    constexpr uint64_t defaultMaxPlayouts = 100000;
+
+    enum NodeState : uint8_t {
+        Unexpanded, Expanding, Expanded
+    };
+
+    /* The value of a node is stored for the side that played the move leading to it. */
+    struct TreeNode {
+        Move move{};
+        float prior = 0.0f;
+
+        std::atomic<uint32_t> visits = 0;
+        std::atomic<uint32_t> virtualLoss = 0;
+        std::atomic<uint64_t> valueSum = 0; // In valueUnit.
+
+        // Children are consecutive in the arena.
+        std::atomic<uint32_t> firstChild = 0;
+        std::atomic<uint16_t> childCount = 0;
+
+        // Stays Expanding when the arena is full , the node is then always a leaf.
+        std::atomic<uint8_t> state = NodeState::Unexpanded;
+    };
+
+    /* Preallocated nodes handed out by bumping an index , nodes are never freed one by one. */
+    class NodeArena {
+    public:
+        explicit NodeArena(size_t megabytes)
+            : capacity(std::max<size_t>(megabytes * 1024 * 1024 / sizeof(TreeNode), 1)),
+              nodes(new TreeNode[capacity]) {}
+
+        /* Returns the index of the first of count consecutive nodes , or -1 if the arena is full. */
+        int64_t Allocate(size_t count) {
+            size_t first = used.fetch_add(count, std::memory_order_relaxed);
+            if (first + count > capacity)
+                return -1;
+            return (int64_t) first;
+        }
+
+        TreeNode& operator[](size_t index) { return nodes[index]; }
+        const TreeNode& operator[](size_t index) const { return nodes[index]; }
+
+        size_t GetUsed() const { return std::min(used.load(std::memory_order_relaxed), capacity); }
+
+    private:
+        size_t capacity;
+        std::unique_ptr<TreeNode[]> nodes;
+        std::atomic<size_t> used = 0;
+    };
+
+    struct MonteCarloTree {
+        NodeArena arena;
+        const MonteCarloOptions& options;
+        TimeManager timeManager;
+        SearchSignals& signals;
+
+        std::atomic<uint64_t> playouts = 0;
+        uint64_t maxPlayouts = 0; // 0 means no limit.
+        int maxDepth = 0; // Length of the most visited line that stops the search , 0 means no limit.
+        std::atomic<bool> stopped = false;
+
+        KeyHistory history; // Positions played before the root.
+
+        MonteCarloTree(const MonteCarloOptions& options, SearchSignals& signals)
+            : arena(options.treeMegabytes), options(options), signals(signals) {}
+    };
+
+    static double ScoreToWinRate(int score) {
+        return 1.0 / (1.0 + std::pow(10.0, -score / centipawnScale));
+    }
+
+    static int WinRateToScore(double winRate) {
+        winRate = std::clamp(winRate, 0.001, 0.999);
+        return (int) std::lround(centipawnScale * std::log10(winRate / (1.0 - winRate)));
+    }
+
+    static double GetWinRate(const TreeNode& node) {
+        uint32_t visits = node.visits.load(std::memory_order_relaxed);
+        if (visits == 0)
+            return 0.5;
+        return (double) node.valueSum.load(std::memory_order_relaxed) / (double) valueUnit / visits;
+    }
+
+    /*******************************************************/
+    /* Expansion and selection                             */
+    /*******************************************************/
+
+    /* Captures and promotions are explored first when using PUCT. */
+    static double GetPriorWeight(const Move& move) {
+        double weight = 1.0;
+        if (IsMoveType(move.flags, MoveType::Capture))
+            weight += Evaluation::pieceValues[move.enemyType] / 100.0;
+        if (IsMoveType(move.flags, MoveType::Promotion))
+            weight += Evaluation::pieceValues[move.promotionType] / 100.0;
+        return weight;
+    }
+
+    /* Only one thread expands a node , the others treat it as a leaf until it is done. */
+    static void Expand(MonteCarloTree& tree, TreeNode& node, const Board& board) {
+        uint8_t expected = NodeState::Unexpanded;
+        if (!node.state.compare_exchange_strong(expected, NodeState::Expanding, std::memory_order_acq_rel))
+            return;
+
+        const BoardState& state = board.GetState();
+        auto moves = GetValidMoves(state, state.turnOf, board.GetOccupancies());
+
+        if (!moves.empty()) {
+            int64_t first = tree.arena.Allocate(moves.size());
+            if (first < 0)
+                return;
+
+            double weightSum = 0.0;
+            for (auto& move : moves)
+                weightSum += GetPriorWeight(move);
+
+            size_t index = first;
+            for (auto& move : moves) {
+                TreeNode& child = tree.arena[index++];
+                child.move = move;
+                child.prior = (float) (GetPriorWeight(move) / weightSum);
+            }
+
+            node.firstChild.store((uint32_t) first, std::memory_order_relaxed);
+            node.childCount.store((uint16_t) moves.size(), std::memory_order_relaxed);
+        }
+
+        node.state.store(NodeState::Expanded, std::memory_order_release);
+    }
+
+    static uint32_t SelectChild(MonteCarloTree& tree, const TreeNode& node) {
+        const MonteCarloOptions& options = tree.options;
+        uint32_t firstChild = node.firstChild.load(std::memory_order_relaxed);
+        uint32_t childCount = node.childCount.load(std::memory_order_relaxed);
+
+        double parentVisits = node.visits.load(std::memory_order_relaxed) + node.virtualLoss.load(std::memory_order_relaxed) + 1.0;
+        double logParentVisits = std::log(parentVisits);
+        double sqrtParentVisits = std::sqrt(parentVisits);
+
+        uint32_t bestChild = firstChild;
+        double bestScore = -1.0;
+        for (uint32_t index = firstChild; index < firstChild + childCount; index++) {
+            const TreeNode& child = tree.arena[index];
+
+            // Threads below the child count as lost playouts.
+            uint32_t virtualLoss = child.virtualLoss.load(std::memory_order_relaxed);
+            double visits = child.visits.load(std::memory_order_relaxed) + virtualLoss;
+            double value = (double) child.valueSum.load(std::memory_order_relaxed) / (double) valueUnit;
+
+            double score;
+            if (options.puct) {
+                double winRate = visits > 0 ? value / visits : 0.5;
+                score = winRate + options.exploration * child.prior * sqrtParentVisits / (1.0 + visits);
+            } else if (visits == 0) {
+                score = 1000.0 + child.prior; // Every move is tried once first.
+            } else {
+                score = value / visits + options.exploration * std::sqrt(logParentVisits / visits);
+            }
+
+            if (score > bestScore) {
+                bestScore = score;
+                bestChild = index;
+            }
+        }
+
+        return bestChild;
+    }
+
+    /*******************************************************/
+    /* Playouts                                            */
+    /*******************************************************/
+
+    /* Plays random moves from the position , returns the result for the side to move. */
+    static double Playout(const MonteCarloTree& tree, const Board& board, uint64_t& seed) {
+        Board playout = board;
+        BoardState& state = playout.GetState();
+        Color startColor = state.turnOf;
+
+        for (int ply = 0; ply < tree.options.playoutDepth; ply++) {
+            if (Draw::InsufficientMaterial(state) || Draw::TablebaseDraw(state))
+                return 0.5;
+
+            Move move{};
+            if (!GetRandomMove(state, state.turnOf, playout.GetOccupancies(), seed, move)) {
+                if (!InCheck(playout))
+                    return 0.5; // Stalemate.
+                return state.turnOf == startColor ? 0.0 : 1.0; // The side to move is mated.
+            }
+
+            MakeMove(move, state.turnOf, state, playout.GetOccupancies());
+        }
+
+        double winRate = ScoreToWinRate(Evaluation::Evaluate(state));
+        return state.turnOf == startColor ? winRate : 1.0 - winRate;
+    }
+
+    /* keys holds the positions before the root , it is left the same. */
+    static void RunIteration(MonteCarloTree& tree, const Board& root, uint64_t& seed, KeyHistory& keys) {
+        uint32_t path[maxPly];
+        int pathLength = 0;
+        uint32_t virtualLoss = tree.options.virtualLoss;
+
+        Board board = root;
+        uint32_t index = 0;
+        double value; // For the side to move at the end of the path.
+        while (true) {
+            TreeNode& node = tree.arena[index];
+            path[pathLength++] = index;
+            node.virtualLoss.fetch_add(virtualLoss, std::memory_order_relaxed);
+
+            if (pathLength > 1 && (Draw::InsufficientMaterial(board.GetState()) || Draw::TablebaseDraw(board.GetState()) ||
+                                   IsSearchDraw(board, keys))) {
+                value = 0.5;
+                break;
+            }
+
+            uint8_t state = node.state.load(std::memory_order_acquire);
+            if (state == NodeState::Unexpanded) {
+                // A new leaf , a playout is enough for its first visit.
+                Expand(tree, node, board);
+                value = Playout(tree, board, seed);
+                break;
+            }
+
+            if (state == NodeState::Expanding || pathLength == maxPly) {
+                value = Playout(tree, board, seed);
+                break;
+            }
+
+            if (node.childCount.load(std::memory_order_relaxed) == 0) {
+                value = InCheck(board) ? 0.0 : 0.5;
+                break;
+            }
+
+            index = SelectChild(tree, node);
+            const Move& move = tree.arena[index].move;
+            keys.Push(board.GetState().hashKey);
+            MakeMove(move, board.GetState().turnOf, board.GetState(), board.GetOccupancies());
+        }
+
+        for (int i = 1; i < pathLength; i++)
+            keys.Pop();
+
+        // Every node stores the result of the side that moved into it.
+        for (int i = pathLength - 1; i >= 0; i--) {
+            TreeNode& node = tree.arena[path[i]];
+            value = 1.0 - value;
+            node.valueSum.fetch_add((uint64_t) std::lround(value * valueUnit), std::memory_order_relaxed);
+            node.visits.fetch_add(1, std::memory_order_relaxed);
+            node.virtualLoss.fetch_sub(virtualLoss, std::memory_order_relaxed);
+        }
+    }
+
+    /* The child with the most visits , null before any was visited. */
+    static const TreeNode* GetMostVisitedChild(const MonteCarloTree& tree, const TreeNode& node) {
+        if (node.state.load(std::memory_order_acquire) != NodeState::Expanded || node.childCount.load(std::memory_order_relaxed) == 0)
+            return nullptr;
+
+        uint32_t firstChild = node.firstChild.load(std::memory_order_relaxed);
+        uint32_t childCount = node.childCount.load(std::memory_order_relaxed);
+
+        const TreeNode* bestChild = &tree.arena[firstChild];
+        for (uint32_t index = firstChild + 1; index < firstChild + childCount; index++) {
+            if (tree.arena[index].visits.load(std::memory_order_relaxed) > bestChild->visits.load(std::memory_order_relaxed))
+                bestChild = &tree.arena[index];
+        }
+        return bestChild->visits.load(std::memory_order_relaxed) != 0 ? bestChild : nullptr;
+    }
+
+    static int GetMostVisitedLineLength(const MonteCarloTree& tree) {
+        int length = 0;
+        for (const TreeNode* node = GetMostVisitedChild(tree, tree.arena[0]); node && length < maxPly; node = GetMostVisitedChild(tree, *node))
+            length++;
+        return length;
+    }
+
+    static bool ShouldStop(MonteCarloTree& tree, uint64_t playouts, bool isMainThread) {
+        if (tree.signals.stop.load(std::memory_order_relaxed))
+            tree.stopped.store(true, std::memory_order_relaxed);
+
+        if (tree.maxPlayouts != 0 && playouts >= tree.maxPlayouts)
+            tree.stopped.store(true, std::memory_order_relaxed);
+
+        // There are no iterations , the search stops once the soft limit is reached.
+        if (isMainThread && (playouts & playoutPollMask) == 0) {
+            if (tree.signals.ponderHit.exchange(false, std::memory_order_acq_rel)) {
+                tree.timeManager.Start(tree.signals.ponderHitTime);
+                tree.signals.ponder.store(false, std::memory_order_relaxed);
+            }
+            if (tree.timeManager.SoftLimitReached())
+                tree.stopped.store(true, std::memory_order_relaxed);
+            if (tree.maxDepth != 0 && GetMostVisitedLineLength(tree) >= tree.maxDepth)
+                tree.stopped.store(true, std::memory_order_relaxed);
+        }
+
+        return tree.stopped.load(std::memory_order_relaxed);
+    }
+
+    static void RunThread(MonteCarloTree& tree, const Board& root, int threadIndex) {
+        uint64_t seed = 0x9E3779B97F4A7C15ULL * (threadIndex + 1);
+        if (threadIndex != 0 && Memory::GetOptions().pinThreads)
+            Memory::PinThread(threadIndex); // The calling thread is left alone.
+
+        KeyHistory keys = tree.history;
+        while (true) {
+            RunIteration(tree, root, seed, keys);
+            uint64_t playouts = tree.playouts.fetch_add(1, std::memory_order_relaxed) + 1;
+            if (ShouldStop(tree, playouts, threadIndex == 0))
+                break;
+        }
+    }
+
+    /*******************************************************/
+    /* Search                                              */
+    /*******************************************************/
+
+    SearchResult MonteCarloSearch(const Board& board, const SearchLimits& limits, const MonteCarloOptions& options) {
+        SearchSignals signals;
+        return MonteCarloSearch(board, limits, options, signals);
+    }
+
+    SearchResult MonteCarloSearch(const Board& board, const SearchLimits& limits, const MonteCarloOptions& options, SearchSignals& signals) {
+        SearchResult result;
+
+        const BoardState& state = board.GetState();
+        auto rootMoves = GetValidMoves(state, state.turnOf, board.GetOccupancies());
+        if (rootMoves.empty())
+            return result;
+
+        result.bestMove = rootMoves.front();
+        result.hasMove = true;
+
+        // The tree holds the arena , keep it off the stack.
+        auto tree = std::make_unique<MonteCarloTree>(options, signals);
+        tree->maxPlayouts = limits.nodes;
+        tree->maxDepth = (limits.depth < maxPly - 1) ? std::max(limits.depth, 1) : 0;
+        tree->history = limits.history;
+        tree->arena.Allocate(1); // Root.
+        bool ponder = signals.ponder.load(std::memory_order_relaxed);
+        if (!ponder)
+            tree->timeManager.Start(limits.time);
+
+        // Without a clock the line may never get that long (mates , a full arena) , a budget ends the search anyway.
+        // Pondering runs until the stop or the ponder hit.
+        if (!ponder && !tree->timeManager.IsActive() && tree->maxPlayouts == 0)
+            tree->maxPlayouts = defaultMaxPlayouts;
+
+        // The calling thread is the first one.
+        std::vector<std::thread> helpers;
+        for (int i = 1; i < std::max(options.threads, 1); i++)
+            helpers.emplace_back(RunThread, std::ref(*tree), std::cref(board), i);
+        RunThread(*tree, board, 0);
+        for (auto& helper : helpers)
+            helper.join();
+
+        // The most visited line , its first move is the best move.
+        std::vector<Move> pv;
+        double winRate = 0.5;
+        const TreeNode* node = &tree->arena[0];
+        while ((int) pv.size() < maxPly) {
+            const TreeNode* bestChild = GetMostVisitedChild(*tree, *node);
+            if (!bestChild)
+                break;
+
+            if (pv.empty())
+                winRate = GetWinRate(*bestChild);
+            pv.push_back(bestChild->move);
+            node = bestChild;
+        }
+
+        if (!pv.empty()) {
+            result.bestMove = pv.front();
+            result.pv = pv;
+        }
+
+        result.score = WinRateToScore(winRate);
+        result.depth = (int) pv.size();
+        result.nodes = tree->playouts.load(std::memory_order_relaxed);
+        result.timeMs = tree->timeManager.ElapsedMs();
+        result.lines = {PVLine{result.pv, result.score, result.depth, result.nodes}};
+        return result;
+    }
+
+}
@@ -0,0 +1,39 @@
+#ifndef MONTE_CARLO_H
+#define MONTE_CARLO_H
+
+#include <cstddef>
+
+#include "Search.h"
+
+namespace ChessEngine::Search {
+
+    struct MonteCarloOptions {
+        int threads = 1;
+
+        // PUCT weighs the exploration of a move by a prior (captures and promotions first) , UCT treats every move the same.
+        bool puct = false;
+        double exploration = 1.4;
+
+        // Playouts are cut after this many random plies and the position is evaluated.
+        int playoutDepth = 16;
+
+        // Playouts a thread adds to a node while it is searching below it , so the other threads pick other paths.
+        int virtualLoss = 3;
+
+        size_t treeMegabytes = 64; // The tree stops growing once the arena is full.
+    };
+
+    /* Monte Carlo tree search. Nodes are taken from a preallocated arena , threads
+     * share the tree and spread over it with virtual loss. Playouts play random
+     * valid moves (see MoveGeneration::GetRandomMove).
+     *
+     * limits.nodes is the number of playouts and limits.depth stops the search once the most
+     * visited line is that long. Without either and without a clock (or pondering) the search
+     * stops after a default number of playouts. The result's depth is the length of the most
+     * visited line and the score is the win rate converted to centipawns. */
+    SearchResult MonteCarloSearch(const Board& board, const SearchLimits& limits, const MonteCarloOptions& options);
+    SearchResult MonteCarloSearch(const Board& board, const SearchLimits& limits, const MonteCarloOptions& options, SearchSignals& signals);
+
+}
+
+#endif
@@ -0,0 +1,792 @@
+#include "ParallelSearch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+#include "../MoveGeneration/MoveGeneration.h"
+#include "../MoveGeneration/Draw.h"
+#include "../Evaluation/Evaluation.h"
+#include "../Utilities/Memory.h"
+#include "SearchHelpers.h"
+#include "SearchTrace.h"
+
+namespace ChessEngine::Search {
+
+    using namespace BitboardUtil;
+    using namespace MoveGeneration;
+
+    /*******************************************************/
+    /* Deterministic transposition table                   */
+    /*******************************************************/
+
+    /* Probes only see the entries of finished iterations , stores of the running
+     * iteration go to a second table that is published once the iteration ends.
+     * When two stores land on the same entry the one with the higher priority
+     * wins , so the table doesn't depend on which thread got there first. */
+    class IterationTable {
+    public:
+        explicit IterationTable(size_t megabytes) {
+            // Round down to a power of 2 number of entries.
+            size_t maxEntries = megabytes * 1024 * 1024 / (2 * sizeof(Entry));
+            entryCount = 1;
+            while (entryCount * 2 <= maxEntries)
+                entryCount *= 2;
+
+            readEntries.resize(entryCount);
+            writeEntries.resize(entryCount);
+        }
+
+        bool Probe(uint64_t key, TTData& data) const {
+            const Entry& entry = readEntries[key & (entryCount - 1)];
+            if (entry.key != key || entry.data == 0)
+                return false;
+
+            data = TranspositionTable::Unpack(entry.data);
+            return true;
+        }
+
+        void Store(uint64_t key, const TTData& data, int iteration) {
+            size_t index = key & (entryCount - 1);
+            Entry entry = {key, TranspositionTable::Pack(data, 0), iteration};
+
+            std::lock_guard<std::mutex> lock(locks[index & (lockCount - 1)]);
+            if (HasPriority(entry, writeEntries[index]))
+                writeEntries[index] = entry;
+        }
+
+        /* Makes the stores of the finished iteration visible to probes. */
+        void Publish() {
+            readEntries = writeEntries;
+        }
+
+    private:
+        struct Entry {
+            uint64_t key = 0;
+            uint64_t data = 0;
+            int iteration = 0;
+        };
+
+        /* Newer iterations first , then deeper and more exact results. The rest
+         * only breaks ties so the order of the stores never matters. */
+        static bool HasPriority(const Entry& a, const Entry& b) {
+            TTData dataA = TranspositionTable::Unpack(a.data);
+            TTData dataB = TranspositionTable::Unpack(b.data);
+            return std::tie(a.iteration, dataA.depth, dataA.bound, a.data, a.key) >
+                   std::tie(b.iteration, dataB.depth, dataB.bound, b.data, b.key);
+        }
+
+        std::vector<Entry> readEntries;
+        std::vector<Entry> writeEntries;
+        size_t entryCount = 0;
+
+        static constexpr size_t lockCount = 1024;
+        std::mutex locks[lockCount];
+    };
+
+    /*******************************************************/
+    /* Workers                                             */
+    /*******************************************************/
+
+    // Enough for a full line plus tasks run while waiting on a split.
+    constexpr int frameCount = 4 * maxPly;
+
+    struct SplitTask;
+
+    /* Per ply data of a worker. A node orders its moves with the killers of its
+     * own frame and clears the frame of its children , so killers are only
+     * shared between brothers. The rest is storage the node reuses so searching
+     * doesn't allocate , the frames are built once with the worker. */
+    struct Frame {
+        Frame() { pv.reserve(maxPly); }
+
+        Move killers[2]{};
+
+        Board board{BoardState{}}; // Position of the node , written by its parent (copy-make , nothing to undo).
+        MoveList moves;
+        ScoredMove orderedMoves[maxPseudoMoves];
+        std::vector<Move> pv; // Principal variation of the node.
+
+        // Only used by split nodes , they keep their capacity between splits.
+        std::vector<SplitTask> tasks;
+        KeyHistory splitKeys;
+        KeyHistory savedKeys; // The worker's own keys while it runs a task in this frame.
+    };
+
+    /* A younger brother of a split node. */
+    struct SplitTask {
+        const Board* board = nullptr; // Position of the split node.
+        const KeyHistory* keys = nullptr; // Positions before the split node.
+        Move move{};
+        int depth = 0;
+        int alpha = 0;
+        int beta = 0;
+        int ply = 0;
+        int moveNumber = 0;
+        bool isPv = false;
+        bool inCheck = false;
+        bool isQuiet = false;
+
+        int score = 0;
+        std::vector<Move> pv; // Of the child , without the move.
+        std::atomic<int>* pending = nullptr; // Tasks of the split node still running.
+    };
+
+    struct SearchPool;
+
+    struct Worker {
+        SearchPool* pool = nullptr;
+        int index = 0;
+
+        // The owner takes tasks from the back , thieves from the front.
+        std::mutex queueLock;
+        std::deque<SplitTask*> queue;
+
+        std::vector<Frame> frames = std::vector<Frame>(frameCount);
+        KeyHistory keys; // The game history followed by the searched line.
+
+        uint64_t nodes = 0;
+        SearchStats* stats = nullptr;
+#ifdef ENGINE_SEARCH_TRACE
+        TraceWriter trace;
+#endif
+    };
+
+    struct SearchPool {
+        IterationTable table;
+        const PruningOptions& pruning;
+        ReductionTable reductions;
+        const ParallelOptions& options;
+        TimeManager timeManager;
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        int iteration = 0;
+
+        std::atomic<bool> stopped = false;
+        std::atomic<bool> canStop = false; // The first iteration always completes so there is a move to play.
+        std::atomic<bool> quit = false;
+
+        SearchPool(const PruningOptions& pruning, const ParallelOptions& options)
+            : table(options.hashMegabytes), pruning(pruning), reductions(pruning), options(options) {}
+    };
+
+    static bool ShouldStop(Worker& worker) {
+        SearchPool& pool = *worker.pool;
+        if (pool.stopped.load(std::memory_order_relaxed))
+            return true;
+
+        // Reading the clock is a syscall , only do it every few nodes.
+        if ((worker.nodes & TimeManager::pollMask) == 0 && pool.canStop.load(std::memory_order_relaxed) &&
+            pool.timeManager.HardLimitReached()) {
+            pool.stopped.store(true, std::memory_order_relaxed);
+            return true;
+        }
+
+        return false;
+    }
+
+    static bool IsStopped(const Worker& worker) {
+        return worker.pool->stopped.load(std::memory_order_relaxed);
+    }
+
+    /* Own tasks first , then tasks stolen from the other workers.
+     * With ownPending set only the tasks of that split can be taken. */
+    static SplitTask* FindTask(Worker& worker, const std::atomic<int>* ownPending, bool canSteal) {
+        {
+            std::lock_guard<std::mutex> lock(worker.queueLock);
+            if (!worker.queue.empty() && (ownPending == nullptr || worker.queue.back()->pending == ownPending || canSteal)) {
+                SplitTask* task = worker.queue.back();
+                worker.queue.pop_back();
+                return task;
+            }
+        }
+
+        if (!canSteal)
+            return nullptr;
+
+        auto& workers = worker.pool->workers;
+        for (size_t offset = 1; offset < workers.size(); offset++) {
+            Worker& victim = *workers[(worker.index + offset) % workers.size()];
+            std::lock_guard<std::mutex> lock(victim.queueLock);
+            if (!victim.queue.empty()) {
+                SplitTask* task = victim.queue.front();
+                victim.queue.pop_front();
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /*******************************************************/
+    /* Search                                              */
+    /*******************************************************/
+
+    static int Node(Worker& worker, Frame* frame, const Board& board, int depth, int alpha, int beta, int ply, bool allowNull);
+    static int Quiescence(Worker& worker, Frame* frame, const Board& board, int alpha, int beta, int ply);
+
+    static int QuiescenceNode(Worker& worker, Frame* frame, const Board& board, int alpha, int beta, int ply) {
+        worker.nodes++;
+        SEARCH_STATS_INC(*worker.stats, quiescenceNodes);
+        if (ShouldStop(worker))
+            return 0;
+
+        const BoardState& state = board.GetState();
+        if (ply >= maxPly - 1)
+            return Evaluation::Evaluate(state);
+
+        // When in check every evasion is searched , otherwise only captures and promotions.
+        bool inCheck = InCheck(board);
+        int bestScore;
+        if (inCheck) {
+            bestScore = -infinity;
+        } else {
+            bestScore = CachedEvaluate(state, *worker.stats);
+            if (bestScore >= beta)
+                return bestScore;
+            alpha = std::max(alpha, bestScore);
+        }
+
+        MoveList& moves = frame->moves;
+        GetValidMoves(state, state.turnOf, board.GetOccupancies(), moves);
+        if (moves.Empty())
+            return inCheck ? -mateScore + ply : bestScore;
+
+        if (!inCheck) {
+            moves.Filter([](const Move& move) { return !IsQuiet(move); });
+        }
+
+        Frame* childFrame = frame + 1;
+        int moveCount = OrderMoves(moves, 0, nullptr, nullptr, frame->orderedMoves);
+        for (int i = 0; i < moveCount; i++) {
+            const Move& move = frame->orderedMoves[i].move;
+            Board& child = childFrame->board;
+            child = board;
+            MakeMove(move, state.turnOf, child.GetState(), child.GetOccupancies());
+
+            SEARCH_TRACE_EDGE(worker.trace, move, 0);
+            int score = -Quiescence(worker, childFrame, child, -beta, -alpha, ply + 1);
+            if (IsStopped(worker))
+                return 0;
+
+            if (score > bestScore) {
+                bestScore = score;
+                if (score > alpha) {
+                    alpha = score;
+                    if (score >= beta)
+                        break;
+                }
+            }
+        }
+
+        return bestScore;
+    }
+
+    /* Searches a single move of a node , the eldest brother with the full window
+     * and the rest with a (possibly reduced) null window first. The child's line
+     * is left in childFrame->pv. */
+    static int SearchMove(Worker& worker, Frame* childFrame, const Board& board, const Move& move, int depth, int alpha, int beta,
+                          int ply, int moveNumber, bool isPv, bool inCheck, bool isQuiet) {
+        Color color = board.GetState().turnOf;
+        Board& child = childFrame->board;
+        child = board;
+        MakeMove(move, color, child.GetState(), child.GetOccupancies());
+        worker.keys.Push(board.GetState().hashKey);
+
+        int score;
+        if (moveNumber == 1) {
+            SEARCH_TRACE_EDGE(worker.trace, move, 0);
+            score = -Node(worker, childFrame, child, depth - 1, -beta, -alpha, ply + 1, true);
+        } else {
+            int reduction = 0;
+            if (worker.pool->pruning.lateMoveReductions && depth >= 3 && isQuiet && !inCheck && !InCheck(child)) {
+                reduction = worker.pool->reductions.Get(depth, moveNumber - 1);
+                if (isPv)
+                    reduction--;
+                reduction = std::clamp(reduction, 0, depth - 2);
+            }
+
+            if (reduction > 0)
+                SEARCH_STATS_INC(*worker.stats, lmrSearches);
+
+            SEARCH_TRACE_EDGE(worker.trace, move, reduction);
+            score = -Node(worker, childFrame, child, depth - 1 - reduction, -alpha - 1, -alpha, ply + 1, true);
+
+            // The reduced search beat alpha , search again at full depth.
+            if (score > alpha && reduction > 0) {
+                SEARCH_STATS_INC(*worker.stats, lmrResearches);
+                SEARCH_TRACE_EDGE(worker.trace, move, 0);
+                score = -Node(worker, childFrame, child, depth - 1, -alpha - 1, -alpha, ply + 1, true);
+            }
+
+            if (score > alpha && score < beta) {
+                SEARCH_TRACE_EDGE(worker.trace, move, 0);
+                score = -Node(worker, childFrame, child, depth - 1, -beta, -alpha, ply + 1, true);
+            }
+        }
+
+        worker.keys.Pop();
+        return score;
+    }
+
+    static void RunTask(Worker& worker, SplitTask& task, Frame* frame) {
+        // The task doesn't inherit killers , whoever runs it gets the same result.
+        frame->killers[0] = {};
+        frame->killers[1] = {};
+
+        // Search from the path of the split node , whatever this worker was searching continues after.
+        // Swapping keeps both buffers , copying the task's keys reuses the capacity of earlier tasks.
+        std::swap(worker.keys, frame->savedKeys);
+        worker.keys = *task.keys;
+
+#ifdef ENGINE_SEARCH_TRACE
+        int previousTaskLevel = worker.trace.BeginTask();
+#endif
+        task.score = SearchMove(worker, frame, *task.board, task.move, task.depth, task.alpha, task.beta,
+                                task.ply, task.moveNumber, task.isPv, task.inCheck, task.isQuiet);
+#ifdef ENGINE_SEARCH_TRACE
+        worker.trace.EndTask(previousTaskLevel);
+#endif
+        std::swap(worker.keys, frame->savedKeys);
+
+        task.pv.assign(frame->pv.begin(), frame->pv.end());
+
+        task.pending->fetch_sub(1, std::memory_order_release);
+    }
+
+    /* Runs tasks until every brother of the split is done. Tasks of other splits
+     * are only picked up while there are enough free frames for a full line. */
+    static void WaitForTasks(Worker& worker, Frame* frame, std::atomic<int>& pending) {
+        Frame* taskFrame = frame + 1;
+        bool canSteal = taskFrame + maxPly + 2 <= worker.frames.data() + worker.frames.size();
+
+        while (pending.load(std::memory_order_acquire) > 0) {
+            SplitTask* task = FindTask(worker, &pending, canSteal);
+            if (task)
+                RunTask(worker, *task, taskFrame);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    static void UpdateKillers(Frame* frame, const Move& move) {
+        if (!SameMove(move, frame->killers[0])) {
+            frame->killers[1] = frame->killers[0];
+            frame->killers[0] = move;
+        }
+    }
+
+    static int SearchNode(Worker& worker, Frame* frame, const Board& board, int depth, int alpha, int beta, int ply, bool allowNull) {
+        SearchPool& pool = *worker.pool;
+        std::vector<Move>& pv = frame->pv;
+        pv.clear();
+
+        if (ply > 0 && IsSearchDraw(board, worker.keys))
+            return 0;
+
+        if (depth <= 0)
+            return Quiescence(worker, frame, board, alpha, beta, ply);
+
+        worker.nodes++;
+        if (ShouldStop(worker))
+            return 0;
+
+        const BoardState& state = board.GetState();
+        Color color = state.turnOf;
+        bool isPv = beta - alpha > 1;
+
+        if (ply > 0) {
+            if (Draw::InsufficientMaterial(state))
+                return 0;
+            if (ply >= maxPly - 1)
+                return Evaluation::Evaluate(state);
+
+            int tablebaseScore;
+            if (ProbeTablebase(state, ply, tablebaseScore)) {
+                SEARCH_STATS_INC(*worker.stats, tablebaseHits);
+                return tablebaseScore;
+            }
+
+            // Mate distance pruning , a shorter mate was already found.
+            alpha = std::max(alpha, -mateScore + ply);
+            beta = std::min(beta, mateScore - ply - 1);
+            if (alpha >= beta)
+                return alpha;
+        }
+
+        Frame* childFrame = frame + 1;
+        childFrame->killers[0] = {};
+        childFrame->killers[1] = {};
+
+        TTData ttData;
+        bool ttHit = pool.table.Probe(state.hashKey, ttData);
+        SEARCH_STATS_INC(*worker.stats, ttProbes);
+        if (ttHit)
+            SEARCH_STATS_INC(*worker.stats, ttHits);
+
+        int ttScore = ttHit ? ScoreFromTT(ttData.score, ply) : 0;
+        if (ttHit && !isPv && ttData.depth >= depth) {
+            if (ttData.bound == Bound::BoundExact ||
+                (ttData.bound == Bound::BoundLower && ttScore >= beta) ||
+                (ttData.bound == Bound::BoundUpper && ttScore <= alpha)) {
+                SEARCH_STATS_INC(*worker.stats, ttCutoffs);
+                return ttScore;
+            }
+        }
+
+        bool inCheck = InCheck(board);
+        if (inCheck)
+            depth++; // Check extension.
+
+        int staticEval = -infinity;
+        if (!inCheck)
+            staticEval = ttHit ? ttData.eval : CachedEvaluate(state, *worker.stats);
+
+        if (!isPv && !inCheck) {
+            // Razoring , far below alpha near the leaves only captures can save the position.
+            if (pool.pruning.razoring && depth <= razoringDepth && staticEval + GetRazoringMargin(pool.pruning, depth) < alpha) {
+                SEARCH_TRACE_NO_EDGE(worker.trace);
+                int score = Quiescence(worker, frame, board, alpha, beta, ply);
+                if (score < alpha)
+                    return score;
+            }
+
+            // Reverse futility , the position is so good that a quiet move won't lose the advantage.
+            if (pool.pruning.reverseFutility && depth <= reverseFutilityDepth &&
+                staticEval - pool.pruning.reverseFutilityMargin * depth >= beta && staticEval < mateBound) {
+                return staticEval;
+            }
+
+            // Null move , if passing still fails high the position is good enough to cut.
+            if (pool.pruning.nullMove && allowNull && depth >= nullMoveDepth &&
+                staticEval >= beta && HasNonPawnMaterial(state, color)) {
+                int reduction = GetNullMoveReduction(pool.pruning, depth);
+
+                Board& child = childFrame->board;
+                child = board;
+                MakeNullMove(color, child.GetState());
+                SEARCH_STATS_INC(*worker.stats, nullMoveTries);
+                worker.keys.Push(state.hashKey);
+                SEARCH_TRACE_NULL_EDGE(worker.trace, reduction);
+                int score = -Node(worker, childFrame, child, depth - 1 - reduction, -beta, -beta + 1, ply + 1, false);
+                worker.keys.Pop();
+                if (IsStopped(worker))
+                    return 0;
+
+                if (score >= beta) {
+                    if (score >= mateBound)
+                        score = beta; // Don't trust mates found after passing.
+
+                    if (!pool.pruning.nullMoveVerification || !IsZugzwangProne(state, color)) {
+                        SEARCH_STATS_INC(*worker.stats, nullMoveCutoffs);
+                        return score;
+                    }
+
+                    // Verify with a reduced search without null moves.
+                    SEARCH_TRACE_NO_EDGE(worker.trace);
+                    int verification = Node(worker, frame, board, depth - 1 - reduction, beta - 1, beta, ply, false);
+                    if (IsStopped(worker))
+                        return 0;
+                    if (verification >= beta) {
+                        SEARCH_STATS_INC(*worker.stats, nullMoveCutoffs);
+                        return score;
+                    }
+                    pv.clear(); // The verification ran in this frame.
+                }
+            }
+        }
+
+        MoveList& moves = frame->moves;
+        GetValidMoves(state, color, board.GetOccupancies(), moves);
+        if (moves.Empty())
+            return inCheck ? -mateScore + ply : 0;
+
+        int moveCount = OrderMoves(moves, ttHit ? ttData.move : 0, frame->killers, nullptr, frame->orderedMoves);
+        const ScoredMove* orderedMoves = frame->orderedMoves;
+
+        bool canFutilityPrune = pool.pruning.futility && !isPv && !inCheck && depth <= futilityDepth &&
+                                staticEval + GetFutilityMargin(pool.pruning, depth) <= alpha;
+
+        int alphaOriginal = alpha;
+        int bestScore = -infinity;
+        Move bestMove{};
+        bool hasBestMove = false;
+        int quietsSearched = 0;
+        int movesSearched = 0;
+        bool cutoff = false;
+
+        // Returns true on a beta cutoff.
+        // The line is the move followed by childPv.
+        auto updateBest = [&](const Move& move, int score, const std::vector<Move>& childPv, bool isQuiet, int moveNumber) {
+            if (score <= bestScore)
+                return false;
+
+            bestScore = score;
+            bestMove = move;
+            hasBestMove = true;
+            if (score <= alpha)
+                return false;
+
+            alpha = score;
+            pv.clear();
+            pv.push_back(move);
+            pv.insert(pv.end(), childPv.begin(), childPv.end());
+            if (score < beta)
+                return false;
+
+            SEARCH_STATS_INC(*worker.stats, betaCutoffs);
+            if (moveNumber == 1)
+                SEARCH_STATS_INC(*worker.stats, firstMoveCutoffs);
+            if (isQuiet)
+                UpdateKillers(frame, move);
+            return true;
+        };
+
+        // Late moves are pruned the same way whether the node is split or not.
+        auto isPruned = [&](bool isQuiet) {
+            if (isPv || inCheck || !isQuiet || bestScore <= -mateBound)
+                return false;
+            if (pool.pruning.lateMovePruning && depth <= lateMovePruningDepth &&
+                quietsSearched >= GetLateMovePruningCount(pool.pruning, depth)) {
+                return true;
+            }
+            return canFutilityPrune;
+        };
+
+        bool canSplit = depth >= pool.options.minSplitDepth;
+        int next = 0;
+        for (; next < moveCount; next++) {
+            // The eldest brother was searched , the rest can run in parallel.
+            if (canSplit && movesSearched > 0)
+                break;
+
+            const Move& move = orderedMoves[next].move;
+            bool isQuiet = IsQuiet(move);
+            if (isPruned(isQuiet))
+                continue;
+
+            if (isQuiet)
+                quietsSearched++;
+            movesSearched++;
+
+            int score = SearchMove(worker, childFrame, board, move, depth, alpha, beta, ply, movesSearched, isPv, inCheck, isQuiet);
+            if (IsStopped(worker))
+                return 0;
+
+            if (updateBest(move, score, childFrame->pv, isQuiet, movesSearched)) {
+                cutoff = true;
+                break;
+            }
+        }
+
+        if (!cutoff && next < moveCount) {
+            // Every brother is searched with the window known after the eldest one ,
+            // a cutoff among them doesn't abort the rest so the node count stays the same.
+            // The worker's own keys change while it helps with other tasks.
+            frame->splitKeys = worker.keys;
+
+            // The tasks are reused (with their pv buffers) , only the ones of this split are valid.
+            auto& tasks = frame->tasks;
+            int taskCount = 0;
+            for (; next < moveCount; next++) {
+                const Move& move = orderedMoves[next].move;
+                bool isQuiet = IsQuiet(move);
+                if (isPruned(isQuiet))
+                    continue;
+
+                if (isQuiet)
+                    quietsSearched++;
+                movesSearched++;
+
+                if (taskCount == (int) tasks.size())
+                    tasks.emplace_back();
+                SplitTask& task = tasks[taskCount++];
+                task.board = &board;
+                task.keys = &frame->splitKeys;
+                task.move = move;
+                task.depth = depth;
+                task.alpha = alpha;
+                task.beta = beta;
+                task.ply = ply;
+                task.moveNumber = movesSearched;
+                task.isPv = isPv;
+                task.inCheck = inCheck;
+                task.isQuiet = isQuiet;
+                task.score = 0;
+            }
+
+            std::atomic<int> pending = taskCount;
+            {
+                // The next move in order ends up at the back , where the owner takes it.
+                std::lock_guard<std::mutex> lock(worker.queueLock);
+                for (int i = taskCount - 1; i >= 0; i--) {
+                    tasks[i].pending = &pending;
+                    worker.queue.push_back(&tasks[i]);
+                }
+            }
+            WaitForTasks(worker, frame, pending);
+
+            if (IsStopped(worker))
+                return 0;
+
+            for (int i = 0; i < taskCount; i++) {
+                if (updateBest(tasks[i].move, tasks[i].score, tasks[i].pv, tasks[i].isQuiet, tasks[i].moveNumber))
+                    break;
+            }
+        }
+
+        Bound bound;
+        if (bestScore >= beta)
+            bound = Bound::BoundLower;
+        else if (bestScore > alphaOriginal)
+            bound = Bound::BoundExact;
+        else
+            bound = Bound::BoundUpper;
+
+        TTData newData;
+        newData.move = hasBestMove && bound != Bound::BoundUpper ? PackMove(bestMove) : 0;
+        newData.score = (int16_t) ScoreToTT(bestScore, ply);
+        newData.eval = (int16_t) staticEval;
+        newData.depth = (uint8_t) depth;
+        newData.bound = bound;
+        pool.table.Store(state.hashKey, newData, pool.iteration);
+
+        return bestScore;
+    }
+
+    /* The searches are entered through these , with ENGINE_SEARCH_TRACE every node is recorded. */
+
+    static int Quiescence(Worker& worker, Frame* frame, const Board& board, int alpha, int beta, int ply) {
+#ifdef ENGINE_SEARCH_TRACE
+        if (worker.trace.IsOpen()) {
+            return worker.trace.Node(ply, 0, alpha, beta, TraceFlags::Quiescence,
+                                     [&]() { return QuiescenceNode(worker, frame, board, alpha, beta, ply); },
+                                     [&]() { return IsStopped(worker); });
+        }
+#endif
+        return QuiescenceNode(worker, frame, board, alpha, beta, ply);
+    }
+
+    static int Node(Worker& worker, Frame* frame, const Board& board, int depth, int alpha, int beta, int ply, bool allowNull) {
+#ifdef ENGINE_SEARCH_TRACE
+        // Horizon nodes are recorded by Quiescence.
+        if (worker.trace.IsOpen() && depth > 0) {
+            return worker.trace.Node(ply, depth, alpha, beta, 0,
+                                     [&]() { return SearchNode(worker, frame, board, depth, alpha, beta, ply, allowNull); },
+                                     [&]() { return IsStopped(worker); });
+        }
+#endif
+        return SearchNode(worker, frame, board, depth, alpha, beta, ply, allowNull);
+    }
+
+    static void HelperLoop(Worker& worker) {
+        if (Memory::GetOptions().pinThreads)
+            Memory::PinThread(worker.index);
+
+        while (!worker.pool->quit.load(std::memory_order_relaxed)) {
+            SplitTask* task = FindTask(worker, nullptr, true);
+            if (task)
+                RunTask(worker, *task, worker.frames.data());
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    static uint64_t TotalNodes(const SearchPool& pool) {
+        uint64_t nodes = 0;
+        for (auto& worker : pool.workers)
+            nodes += worker->nodes;
+        return nodes;
+    }
+
+    SearchResult ParallelSearch(const Board& board, const SearchLimits& limits, const PruningOptions& pruning, const ParallelOptions& options) {
+        SearchResult result;
+
+        const BoardState& state = board.GetState();
+        MoveList rootMoves;
+        GetValidMoves(state, state.turnOf, board.GetOccupancies(), rootMoves);
+        if (rootMoves.Empty())
+            return result;
+
+        // Always have a move ready , even if the search is stopped early.
+        result.bestMove = rootMoves[0];
+        result.hasMove = true;
+
+        int threadCount = std::max(options.threads, 1);
+        SearchPool pool(pruning, options);
+        SearchStatistics statistics(threadCount);
+        for (int i = 0; i < threadCount; i++) {
+            auto worker = std::make_unique<Worker>();
+            worker->pool = &pool;
+            worker->index = i;
+            worker->stats = &statistics.ForThread(i);
+#ifdef ENGINE_SEARCH_TRACE
+            if (!limits.traceFile.empty())
+                worker->trace.Open(GetTracePath(limits.traceFile, i), i);
+#endif
+            pool.workers.push_back(std::move(worker));
+        }
+        pool.timeManager.Start(limits.time);
+
+        // The calling thread is the first worker.
+        std::vector<std::thread> helpers;
+        for (int i = 1; i < threadCount; i++)
+            helpers.emplace_back(HelperLoop, std::ref(*pool.workers[i]));
+
+        Worker& mainWorker = *pool.workers[0];
+        mainWorker.keys = limits.history;
+        mainWorker.keys.Reserve(mainWorker.keys.Size() + maxPly);
+        int maxDepth = std::clamp(limits.depth, 1, maxPly - 1);
+        for (int depth = 1; depth <= maxDepth; depth++) {
+            pool.iteration = depth;
+
+            Frame* root = mainWorker.frames.data();
+            int score = Node(mainWorker, root, board, depth, -infinity, infinity, 0, false);
+            if (IsStopped(mainWorker) || root->pv.empty())
+                break;
+            std::vector<Move> pv = root->pv;
+
+            pool.table.Publish();
+
+            bool bestMoveChanged = depth > 1 && !SameMove(result.bestMove, pv.front());
+            pool.timeManager.UpdateIteration(bestMoveChanged, result.score, score);
+
+            uint64_t nodes = TotalNodes(pool);
+            result.bestMove = pv.front();
+            result.score = score;
+            result.depth = depth;
+            result.pv = pv;
+            result.lines = {PVLine{pv, score, depth, nodes}};
+
+#ifdef ENGINE_SEARCH_STATS
+            statistics.AddIteration(depth, nodes, pool.timeManager.ElapsedMs());
+#endif
+
+            pool.canStop.store(true, std::memory_order_relaxed);
+            if (limits.nodes != 0 && nodes >= limits.nodes)
+                break;
+            if (pool.timeManager.SoftLimitReached())
+                break;
+        }
+
+        pool.quit.store(true, std::memory_order_relaxed);
+        for (auto& helper : helpers)
+            helper.join();
+
+        result.nodes = TotalNodes(pool);
+        result.timeMs = pool.timeManager.ElapsedMs();
+
+#ifdef ENGINE_SEARCH_STATS
+        for (auto& worker : pool.workers)
+            worker->stats->nodes = worker->nodes;
+        result.stats = statistics.Aggregate();
+        result.iterations = statistics.GetIterations();
+#endif
+        return result;
+    }
+
+}
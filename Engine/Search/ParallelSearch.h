@@ -0,0 +1,37 @@
+#ifndef PARALLEL_SEARCH_H
+#define PARALLEL_SEARCH_H
+
+#include <cstddef>
+
+#include "Search.h"
+
+namespace ChessEngine::Search {
+
+    struct ParallelOptions {
+        int threads = 1;
+
+        // Nodes with less depth are searched by a single thread.
+        int minSplitDepth = 4;
+
+        size_t hashMegabytes = 16;
+    };
+
+    /* Young brothers wait parallel search over a work stealing pool. The eldest
+     * move of a node is searched first , the younger brothers then become tasks
+     * any thread can steal.
+     *
+     * The search is deterministic , the same position and limits give the same
+     * best move , score and node count for any number of threads :
+     * - Nodes split the same way no matter how many threads there are.
+     * - Transposition table reads only see entries of previous iterations and
+     *   colliding writes are resolved by priority instead of by arrival order.
+     * - Killers are only shared between brothers searched by the same task and
+     *   there are no history tables.
+     * - The node limit is checked between iterations.
+     * A time limit or a stop still cuts an iteration at an unpredictable point.
+     * Multi-PV isn't supported. */
+    SearchResult ParallelSearch(const Board& board, const SearchLimits& limits, const PruningOptions& pruning, const ParallelOptions& options);
+
+}
+
+#endif
@@ -0,0 +1,543 @@
+#include "Search.h"
+
+#include <memory>
+#include <algorithm>
+
+#include "../MoveGeneration/MoveGeneration.h"
+#include "../MoveGeneration/Draw.h"
+#include "../Evaluation/Evaluation.h"
+#include "SearchHelpers.h"
+#include "SearchTrace.h"
+
+namespace ChessEngine::Search {
+
+    using namespace BitboardUtil;
+    using namespace MoveGeneration;
+
+    /*******************************************************/
+    /* Search state                                        */
+    /*******************************************************/
+
+    /* Everything a node needs for its ply , allocated with the thread so searching allocates nothing. */
+    struct SearchFrame {
+        MoveList moves;
+        ScoredMove orderedMoves[maxPseudoMoves];
+        Board child{BoardState{}}; // The position after the move being searched (copy-make , so there is nothing to undo).
+        Move currentMove{};
+        int staticEval = 0;
+
+        Move killers[2]{};
+
+        // Triangular principal variation table , this ply's line from pv[ply] to pv[pvLength - 1].
+        Move pv[maxPly]{};
+        int pvLength = 0;
+    };
+
+    struct SearchThread {
+        TranspositionTable& transpositionTable;
+        const PruningOptions& pruning;
+        ReductionTable reductions;
+        SearchLimits limits;
+        TimeManager timeManager;
+        SearchSignals* signals;
+        SearchStats* stats = nullptr;
+#ifdef ENGINE_SEARCH_TRACE
+        TraceWriter trace;
+#endif
+
+        uint64_t nodes = 0;
+        bool stopped = false;
+        bool canStop = false; // The first iteration always completes so there is a move to play.
+
+        KeyHistory keys; // The game history followed by the searched line.
+
+        SearchFrame frames[maxPly]; // By ply.
+        int history[2][64][64]{}; // [color][from][to]
+
+        // Root moves already reported as a better line in Multi-PV mode.
+        std::vector<uint16_t> excludedRootMoves;
+
+        SearchThread(TranspositionTable& transpositionTable, const PruningOptions& pruning, const SearchLimits& limits, SearchSignals* signals)
+            : transpositionTable(transpositionTable), pruning(pruning), reductions(pruning), limits(limits), signals(signals), keys(limits.history) {
+            keys.Reserve(keys.Size() + maxPly);
+            excludedRootMoves.reserve(maxPseudoMoves);
+        }
+    };
+
+    static bool IsExcludedRootMove(const SearchThread& thread, const Move& move) {
+        auto& excluded = thread.excludedRootMoves;
+        return std::find(excluded.begin(), excluded.end(), PackMove(move)) != excluded.end();
+    }
+
+    /* A ponder hit starts the clock , the search continues where it was. */
+    static void CheckPonderHit(SearchThread& thread) {
+        if (thread.signals && thread.signals->ponderHit.exchange(false, std::memory_order_acq_rel)) {
+            thread.timeManager.Start(thread.signals->ponderHitTime);
+            thread.signals->ponder.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    static bool ShouldStop(SearchThread& thread) {
+        // An external stop discards the search , no need to finish the first iteration.
+        if (thread.signals && thread.signals->stop.load(std::memory_order_relaxed))
+            thread.stopped = true;
+
+        if (thread.stopped || !thread.canStop)
+            return thread.stopped;
+
+        if (thread.limits.nodes != 0 && thread.nodes >= thread.limits.nodes)
+            thread.stopped = true;
+
+        // Reading the clock is a syscall , only do it every few nodes.
+        if ((thread.nodes & TimeManager::pollMask) == 0) {
+            CheckPonderHit(thread);
+            if (thread.timeManager.HardLimitReached())
+                thread.stopped = true;
+        }
+
+        return thread.stopped;
+    }
+
+    /*******************************************************/
+    /* Move ordering                                       */
+    /*******************************************************/
+
+    static void UpdateQuietHeuristics(SearchThread& thread, const Move& move, int depth, int ply, Color color) {
+        Move* killers = thread.frames[ply].killers;
+        if (!SameMove(move, killers[0])) {
+            killers[1] = killers[0];
+            killers[0] = move;
+        }
+
+        int& history = thread.history[color][move.fromSquareIndex][move.toSquareIndex];
+        history = std::min(history + depth * depth, 50000);
+    }
+
+    /*******************************************************/
+    /* Search                                              */
+    /*******************************************************/
+
+    static int Quiescence(SearchThread& thread, const Board& board, int alpha, int beta, int ply);
+    static int Negamax(SearchThread& thread, const Board& board, int depth, int alpha, int beta, int ply, bool allowNull);
+
+    static int QuiescenceNode(SearchThread& thread, const Board& board, int alpha, int beta, int ply) {
+        thread.nodes++;
+        SEARCH_STATS_INC(*thread.stats, quiescenceNodes);
+        if (ShouldStop(thread))
+            return 0;
+
+        const BoardState& state = board.GetState();
+        if (ply >= maxPly - 1)
+            return Evaluation::Evaluate(state);
+
+        // When in check every evasion is searched , otherwise only captures and promotions.
+        bool inCheck = InCheck(board);
+        int bestScore;
+        if (inCheck) {
+            bestScore = -infinity;
+        } else {
+            bestScore = CachedEvaluate(state, *thread.stats);
+            if (bestScore >= beta)
+                return bestScore;
+            alpha = std::max(alpha, bestScore);
+        }
+
+        SearchFrame& frame = thread.frames[ply];
+        frame.staticEval = bestScore;
+
+        MoveList& moves = frame.moves;
+        GetValidMoves(state, state.turnOf, board.GetOccupancies(), moves);
+        if (moves.Empty())
+            return inCheck ? -mateScore + ply : bestScore;
+
+        if (!inCheck) {
+            moves.Filter([](const Move& move) { return !IsQuiet(move); });
+        }
+
+        int moveCount = OrderMoves(moves, 0, frame.killers, thread.history[state.turnOf], frame.orderedMoves);
+        for (int i = 0; i < moveCount; i++) {
+            const Move& move = frame.orderedMoves[i].move;
+            Board& child = frame.child;
+            child = board;
+            MakeMove(move, state.turnOf, child.GetState(), child.GetOccupancies());
+            frame.currentMove = move;
+
+            SEARCH_TRACE_EDGE(thread.trace, move, 0);
+            int score = -Quiescence(thread, child, -beta, -alpha, ply + 1);
+            if (thread.stopped)
+                return 0;
+
+            if (score > bestScore) {
+                bestScore = score;
+                if (score > alpha) {
+                    alpha = score;
+                    if (score >= beta)
+                        break;
+                }
+            }
+        }
+
+        return bestScore;
+    }
+
+    static int NegamaxNode(SearchThread& thread, const Board& board, int depth, int alpha, int beta, int ply, bool allowNull) {
+        SearchFrame& frame = thread.frames[ply];
+        frame.pvLength = ply;
+
+        if (ply > 0 && IsSearchDraw(board, thread.keys))
+            return 0;
+
+        if (depth <= 0)
+            return Quiescence(thread, board, alpha, beta, ply);
+
+        thread.nodes++;
+        if (ShouldStop(thread))
+            return 0;
+
+        const BoardState& state = board.GetState();
+        Color color = state.turnOf;
+        bool isPv = beta - alpha > 1;
+
+        if (ply > 0) {
+            if (Draw::InsufficientMaterial(state))
+                return 0;
+            if (ply >= maxPly - 1)
+                return Evaluation::Evaluate(state);
+
+            int tablebaseScore;
+            if (ProbeTablebase(state, ply, tablebaseScore)) {
+                SEARCH_STATS_INC(*thread.stats, tablebaseHits);
+                return tablebaseScore;
+            }
+
+            // Mate distance pruning , a shorter mate was already found.
+            alpha = std::max(alpha, -mateScore + ply);
+            beta = std::min(beta, mateScore - ply - 1);
+            if (alpha >= beta)
+                return alpha;
+        }
+
+        TTData ttData;
+        bool ttHit = thread.transpositionTable.Probe(state.hashKey, ttData);
+        SEARCH_STATS_INC(*thread.stats, ttProbes);
+        if (ttHit)
+            SEARCH_STATS_INC(*thread.stats, ttHits);
+
+        int ttScore = ttHit ? ScoreFromTT(ttData.score, ply) : 0;
+        if (ttHit && !isPv && ttData.depth >= depth) {
+            if (ttData.bound == Bound::BoundExact ||
+                (ttData.bound == Bound::BoundLower && ttScore >= beta) ||
+                (ttData.bound == Bound::BoundUpper && ttScore <= alpha)) {
+                SEARCH_STATS_INC(*thread.stats, ttCutoffs);
+                return ttScore;
+            }
+        }
+
+        bool inCheck = InCheck(board);
+        if (inCheck)
+            depth++; // Check extension.
+
+        int staticEval = -infinity;
+        if (!inCheck)
+            staticEval = ttHit ? ttData.eval : CachedEvaluate(state, *thread.stats);
+        frame.staticEval = staticEval;
+
+        if (!isPv && !inCheck) {
+            // Razoring , far below alpha near the leaves only captures can save the position.
+            if (thread.pruning.razoring && depth <= razoringDepth && staticEval + GetRazoringMargin(thread.pruning, depth) < alpha) {
+                SEARCH_TRACE_NO_EDGE(thread.trace);
+                int score = Quiescence(thread, board, alpha, beta, ply);
+                if (score < alpha)
+                    return score;
+            }
+
+            // Reverse futility , the position is so good that a quiet move won't lose the advantage.
+            if (thread.pruning.reverseFutility && depth <= reverseFutilityDepth &&
+                staticEval - thread.pruning.reverseFutilityMargin * depth >= beta && staticEval < mateBound) {
+                return staticEval;
+            }
+
+            // Null move , if passing still fails high the position is good enough to cut.
+            if (thread.pruning.nullMove && allowNull && depth >= nullMoveDepth &&
+                staticEval >= beta && HasNonPawnMaterial(state, color)) {
+                int reduction = GetNullMoveReduction(thread.pruning, depth);
+
+                Board& child = frame.child;
+                child = board;
+                MakeNullMove(color, child.GetState());
+                frame.currentMove = {};
+                SEARCH_STATS_INC(*thread.stats, nullMoveTries);
+                thread.keys.Push(state.hashKey);
+                SEARCH_TRACE_NULL_EDGE(thread.trace, reduction);
+                int score = -Negamax(thread, child, depth - 1 - reduction, -beta, -beta + 1, ply + 1, false);
+                thread.keys.Pop();
+                if (thread.stopped)
+                    return 0;
+
+                if (score >= beta) {
+                    if (score >= mateBound)
+                        score = beta; // Don't trust mates found after passing.
+
+                    if (!thread.pruning.nullMoveVerification || !IsZugzwangProne(state, color)) {
+                        SEARCH_STATS_INC(*thread.stats, nullMoveCutoffs);
+                        return score;
+                    }
+
+                    // Verify with a reduced search without null moves.
+                    SEARCH_TRACE_NO_EDGE(thread.trace);
+                    int verification = Negamax(thread, board, depth - 1 - reduction, beta - 1, beta, ply, false);
+                    if (thread.stopped)
+                        return 0;
+                    if (verification >= beta) {
+                        SEARCH_STATS_INC(*thread.stats, nullMoveCutoffs);
+                        return score;
+                    }
+                }
+            }
+        }
+
+        MoveList& moves = frame.moves;
+        GetValidMoves(state, color, board.GetOccupancies(), moves);
+        if (moves.Empty())
+            return inCheck ? -mateScore + ply : 0;
+
+        int moveCount = OrderMoves(moves, ttHit ? ttData.move : 0, frame.killers, thread.history[color], frame.orderedMoves);
+
+        bool canFutilityPrune = thread.pruning.futility && !isPv && !inCheck && depth <= futilityDepth &&
+                                staticEval + GetFutilityMargin(thread.pruning, depth) <= alpha;
+
+        int alphaOriginal = alpha;
+        int bestScore = -infinity;
+        Move bestMove{};
+        bool hasBestMove = false;
+        int quietsSearched = 0;
+        int movesSearched = 0;
+
+        for (int i = 0; i < moveCount; i++) {
+            const Move& move = frame.orderedMoves[i].move;
+            bool isQuiet = IsQuiet(move);
+
+            if (ply == 0 && IsExcludedRootMove(thread, move))
+                continue;
+
+            // Prune late quiet moves only once a move that doesn't lose to mate was found.
+            if (!isPv && !inCheck && isQuiet && bestScore > -mateBound) {
+                if (thread.pruning.lateMovePruning && depth <= lateMovePruningDepth &&
+                    quietsSearched >= GetLateMovePruningCount(thread.pruning, depth)) {
+                    continue;
+                }
+                if (canFutilityPrune)
+                    continue;
+            }
+
+            Board& child = frame.child;
+            child = board;
+            MakeMove(move, color, child.GetState(), child.GetOccupancies());
+            frame.currentMove = move;
+            thread.keys.Push(state.hashKey);
+            if (isQuiet)
+                quietsSearched++;
+            movesSearched++;
+
+            int score;
+            if (movesSearched == 1) {
+                SEARCH_TRACE_EDGE(thread.trace, move, 0);
+                score = -Negamax(thread, child, depth - 1, -beta, -alpha, ply + 1, true);
+            } else {
+                int reduction = 0;
+                if (thread.pruning.lateMoveReductions && depth >= 3 && isQuiet && !inCheck && !InCheck(child)) {
+                    reduction = thread.reductions.Get(depth, movesSearched - 1);
+                    if (isPv)
+                        reduction--;
+                    reduction = std::clamp(reduction, 0, depth - 2);
+                }
+
+                if (reduction > 0)
+                    SEARCH_STATS_INC(*thread.stats, lmrSearches);
+
+                SEARCH_TRACE_EDGE(thread.trace, move, reduction);
+                score = -Negamax(thread, child, depth - 1 - reduction, -alpha - 1, -alpha, ply + 1, true);
+
+                // The reduced search beat alpha , search again at full depth.
+                if (score > alpha && reduction > 0) {
+                    SEARCH_STATS_INC(*thread.stats, lmrResearches);
+                    SEARCH_TRACE_EDGE(thread.trace, move, 0);
+                    score = -Negamax(thread, child, depth - 1, -alpha - 1, -alpha, ply + 1, true);
+                }
+
+                if (score > alpha && score < beta) {
+                    SEARCH_TRACE_EDGE(thread.trace, move, 0);
+                    score = -Negamax(thread, child, depth - 1, -beta, -alpha, ply + 1, true);
+                }
+            }
+
+            thread.keys.Pop();
+            if (thread.stopped)
+                return 0;
+
+            if (score > bestScore) {
+                bestScore = score;
+                bestMove = move;
+                hasBestMove = true;
+
+                if (score > alpha) {
+                    alpha = score;
+
+                    // Update the principal variation.
+                    const SearchFrame& next = thread.frames[ply + 1];
+                    frame.pv[ply] = move;
+                    for (int nextPly = ply + 1; nextPly < next.pvLength; nextPly++)
+                        frame.pv[nextPly] = next.pv[nextPly];
+                    frame.pvLength = std::max(next.pvLength, ply + 1);
+
+                    if (score >= beta) {
+                        SEARCH_STATS_INC(*thread.stats, betaCutoffs);
+                        if (movesSearched == 1)
+                            SEARCH_STATS_INC(*thread.stats, firstMoveCutoffs);
+
+                        if (isQuiet)
+                            UpdateQuietHeuristics(thread, move, depth, ply, color);
+                        break;
+                    }
+                }
+            }
+        }
+
+        Bound bound;
+        if (bestScore >= beta)
+            bound = Bound::BoundLower;
+        else if (bestScore > alphaOriginal)
+            bound = Bound::BoundExact;
+        else
+            bound = Bound::BoundUpper;
+
+        TTData newData;
+        newData.move = hasBestMove && bound != Bound::BoundUpper ? PackMove(bestMove) : 0;
+        newData.score = (int16_t) ScoreToTT(bestScore, ply);
+        newData.eval = (int16_t) staticEval;
+        newData.depth = (uint8_t) depth;
+        newData.bound = bound;
+
+        // A root searched without its best moves doesn't describe the real position.
+        if (ply != 0 || thread.excludedRootMoves.empty())
+            thread.transpositionTable.Store(state.hashKey, newData);
+
+        return bestScore;
+    }
+
+    /* The searches are entered through these , with ENGINE_SEARCH_TRACE every node is recorded. */
+
+    static int Quiescence(SearchThread& thread, const Board& board, int alpha, int beta, int ply) {
+#ifdef ENGINE_SEARCH_TRACE
+        if (thread.trace.IsOpen()) {
+            return thread.trace.Node(ply, 0, alpha, beta, TraceFlags::Quiescence,
+                                     [&]() { return QuiescenceNode(thread, board, alpha, beta, ply); },
+                                     [&]() { return thread.stopped; });
+        }
+#endif
+        return QuiescenceNode(thread, board, alpha, beta, ply);
+    }
+
+    static int Negamax(SearchThread& thread, const Board& board, int depth, int alpha, int beta, int ply, bool allowNull) {
+#ifdef ENGINE_SEARCH_TRACE
+        // Horizon nodes are recorded by Quiescence.
+        if (thread.trace.IsOpen() && depth > 0) {
+            return thread.trace.Node(ply, depth, alpha, beta, 0,
+                                     [&]() { return NegamaxNode(thread, board, depth, alpha, beta, ply, allowNull); },
+                                     [&]() { return thread.stopped; });
+        }
+#endif
+        return NegamaxNode(thread, board, depth, alpha, beta, ply, allowNull);
+    }
+
+    SearchResult Search(const Board& board, const SearchLimits& limits, const PruningOptions& pruning, TranspositionTable& transpositionTable) {
+        SearchSignals signals;
+        return Search(board, limits, pruning, transpositionTable, signals);
+    }
+
+    SearchResult Search(const Board& board, const SearchLimits& limits, const PruningOptions& pruning, TranspositionTable& transpositionTable, SearchSignals& signals) {
+        SearchResult result;
+
+        const BoardState& state = board.GetState();
+        MoveList rootMoves;
+        GetValidMoves(state, state.turnOf, board.GetOccupancies(), rootMoves);
+        if (rootMoves.Empty())
+            return result;
+
+        // Always have a move ready , even if the search is stopped early.
+        result.bestMove = rootMoves[0];
+        result.hasMove = true;
+
+        transpositionTable.NewSearch();
+
+        // The thread holds large tables , keep it off the stack.
+        auto thread = std::make_unique<SearchThread>(transpositionTable, pruning, limits, &signals);
+        SearchStatistics statistics;
+        thread->stats = &statistics.ForThread(0);
+#ifdef ENGINE_SEARCH_TRACE
+        if (!limits.traceFile.empty())
+            thread->trace.Open(GetTracePath(limits.traceFile, 0), 0);
+#endif
+        if (!signals.ponder.load(std::memory_order_relaxed))
+            thread->timeManager.Start(limits.time);
+
+        int maxDepth = std::clamp(limits.depth, 1, maxPly - 1);
+        int pvCount = std::clamp(limits.multiPV, 1, rootMoves.Size());
+        for (int depth = 1; depth <= maxDepth; depth++) {
+            // Every line is searched with the previous ones excluded from the root.
+            std::vector<PVLine> lines;
+            thread->excludedRootMoves.clear();
+            for (int pvIndex = 0; pvIndex < pvCount; pvIndex++) {
+                int score = Negamax(*thread, board, depth, -infinity, infinity, 0, false);
+                const SearchFrame& root = thread->frames[0];
+                if (thread->stopped || root.pvLength == 0)
+                    break;
+
+                PVLine line;
+                line.moves.assign(root.pv, root.pv + root.pvLength);
+                line.score = score;
+                line.depth = depth;
+                line.nodes = thread->nodes;
+                lines.push_back(line);
+
+                thread->excludedRootMoves.push_back(PackMove(line.moves.front()));
+            }
+            if (thread->stopped || lines.empty())
+                break;
+
+            std::stable_sort(lines.begin(), lines.end(), [](const PVLine& a, const PVLine& b) {
+                return a.score > b.score;
+            });
+
+            const PVLine& best = lines.front();
+            bool bestMoveChanged = depth > 1 && !SameMove(result.bestMove, best.moves.front());
+            thread->timeManager.UpdateIteration(bestMoveChanged, result.score, best.score);
+
+            result.bestMove = best.moves.front();
+            result.score = best.score;
+            result.depth = depth;
+            result.pv = best.moves;
+            result.lines = lines;
+
+#ifdef ENGINE_SEARCH_STATS
+            statistics.AddIteration(depth, thread->nodes, thread->timeManager.ElapsedMs());
+#endif
+
+            thread->canStop = true;
+            CheckPonderHit(*thread);
+            if (thread->timeManager.SoftLimitReached())
+                break;
+        }
+
+        result.nodes = thread->nodes;
+        result.timeMs = thread->timeManager.ElapsedMs();
+
+#ifdef ENGINE_SEARCH_STATS
+        thread->stats->nodes = thread->nodes;
+        result.stats = statistics.Aggregate();
+        result.iterations = statistics.GetIterations();
+#endif
+        return result;
+    }
+
+}
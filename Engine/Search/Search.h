@@ -0,0 +1,110 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <atomic>
+#include <vector>
+#include <string>
+
+#include "../Board/Board.h"
+#include "../Board/KeyHistory.h"
+#include "../MoveGeneration/Move.h"
+#include "TranspositionTable.h"
+#include "TimeManager.h"
+#include "SearchStats.h"
+
+namespace ChessEngine::Search {
+
+    constexpr int maxPly = 128;
+    constexpr int infinity = 32000;
+    constexpr int mateScore = 31000;
+    constexpr int mateBound = mateScore - maxPly; // Scores beyond this are mates.
+
+    /* Selective pruning techniques. Each one can be switched off on its own
+     * so its impact on node counts and strength can be measured separately. */
+    struct PruningOptions {
+        bool nullMove = true;
+        bool nullMoveVerification = true; // Only applies to zugzwang prone positions.
+        bool lateMoveReductions = true;
+        bool reverseFutility = true;
+        bool futility = true;
+        bool lateMovePruning = true;
+        bool razoring = true;
+
+        // Margins and reductions , they can be set by name (TunableOptions.h) to tune them by self play.
+        int reverseFutilityMargin = 90; // Per depth.
+        int futilityMargin = 120; // Per depth.
+        int razoringMargin = 300; // At depth 1.
+        int razoringDepthMargin = 250; // Added per depth above 1.
+        int nullMoveReduction = 3;
+        int nullMoveDepthDivisor = 6; // One more ply of reduction per this many plies of depth.
+        int lateMovePruningBase = 4; // Quiet moves searched at depth d before pruning : base + d * d.
+        int lateMoveReductionBase = 75; // Hundredths of a ply.
+        int lateMoveReductionDivisor = 225; // Hundredths , base + log(depth) * log(move number) / divisor.
+    };
+
+    struct SearchLimits {
+        int depth = maxPly - 1;
+        uint64_t nodes = 0; // 0 means no limit.
+        TimeControl time; // Untimed by default.
+
+        int multiPV = 1; // Number of best lines to search.
+
+        // Positions played before the root , repetitions of them are draws.
+        KeyHistory history;
+
+        // Every node is appended to "<traceFile>.<thread index>" (see SearchTrace.h) , empty for none.
+        // Only in builds with ENGINE_SEARCH_TRACE.
+        std::string traceFile;
+    };
+
+    struct PVLine {
+        std::vector<MoveGeneration::Move> moves;
+        int score = 0;
+        int depth = 0;
+        uint64_t nodes = 0; // Nodes searched when the line was found.
+    };
+
+    struct SearchResult {
+        MoveGeneration::Move bestMove{};
+        bool hasMove = false; // False if there are no valid moves.
+
+        int score = 0;
+        int depth = 0; // Last fully searched depth.
+        uint64_t nodes = 0;
+        int64_t timeMs = 0;
+
+        std::vector<MoveGeneration::Move> pv;
+
+        // Best lines ranked by score , has multiPV lines (or less if there are fewer valid moves).
+        std::vector<PVLine> lines;
+
+        // All zero and no iterations when the engine is built without ENGINE_SEARCH_STATS.
+        SearchStats stats;
+        std::vector<IterationStats> iterations;
+    };
+
+    /* Lets another thread control a running search. */
+    struct SearchSignals {
+        std::atomic<bool> stop = false;
+
+        // While pondering the time limits don't apply , the search runs until
+        // a ponder hit turns it into a normal timed search.
+        std::atomic<bool> ponder = false;
+        std::atomic<bool> ponderHit = false;
+        TimeControl ponderHitTime; // Written before ponderHit is set.
+    };
+
+    /* Size of the evaluation cache shared by every search , 0 disables it. Not while a search runs. */
+    constexpr size_t defaultEvalCacheKilobytes = 1024;
+    void SetEvalCacheSize(size_t kilobytes);
+    /* After the evaluation changed (eg: Nnue::SetNetwork). Transposition table entries keep
+     * static evaluations too , clear the tables as well. */
+    void ClearEvalCache();
+
+    /* Iterative deepening alpha beta search of the position. */
+    SearchResult Search(const Board& board, const SearchLimits& limits, const PruningOptions& pruning, TranspositionTable& transpositionTable);
+    SearchResult Search(const Board& board, const SearchLimits& limits, const PruningOptions& pruning, TranspositionTable& transpositionTable, SearchSignals& signals);
+
+}
+
+#endif
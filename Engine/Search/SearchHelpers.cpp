@@ -0,0 +1,188 @@
+#include "SearchHelpers.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Search.h"
+#include "../MoveGeneration/MoveGeneration.h"
+#include "../MoveGeneration/Draw.h"
+#include "../Evaluation/Evaluation.h"
+#include "../Evaluation/EvalCache.h"
+#include "../Tablebase/Tablebase.h"
+
+namespace ChessEngine::Search {
+
+    using namespace BitboardUtil;
+    using namespace MoveGeneration;
+
+    /*******************************************************/
+    /* Pruning margins                                     */
+    /*******************************************************/
+
+    int GetRazoringMargin(const PruningOptions& pruning, int depth) {
+        return pruning.razoringMargin + (depth - 1) * pruning.razoringDepthMargin;
+    }
+
+    int GetFutilityMargin(const PruningOptions& pruning, int depth) {
+        return pruning.futilityMargin * depth;
+    }
+
+    int GetLateMovePruningCount(const PruningOptions& pruning, int depth) {
+        return pruning.lateMovePruningBase + depth * depth;
+    }
+
+    int GetNullMoveReduction(const PruningOptions& pruning, int depth) {
+        return pruning.nullMoveReduction + depth / std::max(pruning.nullMoveDepthDivisor, 1);
+    }
+
+    ReductionTable::ReductionTable(const PruningOptions& pruning) {
+        double base = pruning.lateMoveReductionBase / 100.0;
+        double divisor = std::max(pruning.lateMoveReductionDivisor, 1) / 100.0;
+        for (int depth = 1; depth < 64; depth++) {
+            for (int moveNumber = 1; moveNumber < 64; moveNumber++) {
+                double reduction = base + std::log(depth) * std::log(moveNumber) / divisor;
+                reductions[depth][moveNumber] = (int8_t) std::clamp((int) reduction, 0, 63);
+            }
+        }
+    }
+
+    int ReductionTable::Get(int depth, int moveNumber) const {
+        return reductions[std::min(depth, 63)][std::min(moveNumber, 63)];
+    }
+
+    /*******************************************************/
+    /* Position and move helpers                           */
+    /*******************************************************/
+
+    bool IsQuiet(const Move& move) {
+        return !IsMoveType(move.flags, (MoveType) (MoveType::Capture | MoveType::Promotion));
+    }
+
+    bool SameMove(const Move& a, const Move& b) {
+        return PackMove(a) == PackMove(b);
+    }
+
+    bool InCheck(const Board& board) {
+        const BoardState& state = board.GetState();
+        return NumberOfChecks(state.turnOf, state, board.GetOccupancies()) != 0;
+    }
+
+    bool HasNonPawnMaterial(const BoardState& state, Color color) {
+        return state.pieceBoards[color][PieceType::Queen] |
+               state.pieceBoards[color][PieceType::Rook] |
+               state.pieceBoards[color][PieceType::Bishop] |
+               state.pieceBoards[color][PieceType::Knight];
+    }
+
+    bool IsZugzwangProne(const BoardState& state, Color color) {
+        Bitboard pieces = state.pieceBoards[color][PieceType::Queen] |
+                          state.pieceBoards[color][PieceType::Rook] |
+                          state.pieceBoards[color][PieceType::Bishop] |
+                          state.pieceBoards[color][PieceType::Knight];
+        return GetBitCount(pieces) <= 1;
+    }
+
+    bool IsSearchDraw(const Board& board, const KeyHistory& keys) {
+        const BoardState& state = board.GetState();
+        if (Draw::Repetition(state, keys, 1))
+            return true;
+
+        if (!Draw::MaxMoves(state))
+            return false;
+
+        // Rare , the mate check can be slow.
+        if (!InCheck(board))
+            return true;
+        MoveList moves;
+        GetValidMoves(state, state.turnOf, board.GetOccupancies(), moves);
+        return !moves.Empty();
+    }
+
+    bool ProbeTablebase(const BoardState& state, int ply, int& score) {
+        Tablebase::ProbeResult result;
+        if (!Tablebase::Probe(state, result))
+            return false;
+
+        if (result.outcome == Tablebase::Outcome::Draw) {
+            score = 0;
+            return true;
+        }
+
+        if (state.halfMoves + result.distance > 100)
+            return false;
+
+        // Mates past the deepest ply can't be told apart , they score just below the mate scores.
+        int distance = ply + result.distance;
+        int winScore = (distance < maxPly) ? mateScore - distance : mateBound - 1;
+        score = (result.outcome == Tablebase::Outcome::Win) ? winScore : -winScore;
+        return true;
+    }
+
+    static Evaluation::EvalCache evalCache(defaultEvalCacheKilobytes);
+
+    void SetEvalCacheSize(size_t kilobytes) {
+        evalCache.Resize(kilobytes);
+    }
+
+    void ClearEvalCache() {
+        evalCache.Clear();
+    }
+
+    int CachedEvaluate(const BoardState& state, SearchStats& stats) {
+        if (!evalCache.IsEnabled())
+            return Evaluation::Evaluate(state);
+
+        int score;
+        SEARCH_STATS_INC(stats, evalProbes);
+        if (evalCache.Probe(state.hashKey, score)) {
+            SEARCH_STATS_INC(stats, evalHits);
+            return score;
+        }
+
+        score = Evaluation::Evaluate(state);
+        evalCache.Store(state.hashKey, score);
+        return score;
+    }
+
+    int ScoreToTT(int score, int ply) {
+        if (score >= mateBound) return score + ply;
+        if (score <= -mateBound) return score - ply;
+        return score;
+    }
+
+    int ScoreFromTT(int score, int ply) {
+        if (score >= mateBound) return score - ply;
+        if (score <= -mateBound) return score + ply;
+        return score;
+    }
+
+    int OrderMoves(const MoveList& moves, uint16_t ttMove, const Move* killers, const int (*history)[64], ScoredMove* scoredMoves) {
+        int count = 0;
+        for (auto move : moves) {
+            int score = 0;
+            if (PackMove(move) == ttMove) {
+                score = 1000000;
+            } else if (IsMoveType(move.flags, MoveType::Capture)) {
+                // Most valuable victim , least valuable attacker.
+                score = 100000 + Evaluation::pieceValues[move.enemyType] * 10 - Evaluation::pieceValues[move.selfType] / 10;
+            } else if (IsMoveType(move.flags, MoveType::Promotion)) {
+                score = 90000 + Evaluation::pieceValues[move.promotionType];
+            } else if (killers && SameMove(move, killers[0])) {
+                score = 80000;
+            } else if (killers && SameMove(move, killers[1])) {
+                score = 79000;
+            } else if (history) {
+                score = history[move.fromSquareIndex][move.toSquareIndex];
+            }
+
+            // Insertion sort , the lists are short and equal scores stay in generation order.
+            int i = count++;
+            for (; i > 0 && scoredMoves[i - 1].score < score; i--)
+                scoredMoves[i] = scoredMoves[i - 1];
+            scoredMoves[i] = {move, score};
+        }
+
+        return count;
+    }
+
+}
@@ -0,0 +1,90 @@
+#ifndef SEARCH_HELPERS_H
+#define SEARCH_HELPERS_H
+
+#include <vector>
+
+#include "../Board/Board.h"
+#include "../Board/KeyHistory.h"
+#include "../MoveGeneration/Move.h"
+#include "../MoveGeneration/MoveList.h"
+#include "SearchStats.h"
+#include "Search.h"
+
+namespace ChessEngine::Search {
+
+    // Shared by the sequential and the parallel search.
+
+    /*******************************************************/
+    /* Pruning margins                                     */
+    /*******************************************************/
+
+    // Deepest depth each one applies at , the margins come from PruningOptions.
+    constexpr int lateMovePruningDepth = 8;
+    constexpr int reverseFutilityDepth = 7;
+    constexpr int futilityDepth = 3;
+    constexpr int razoringDepth = 2;
+
+    constexpr int nullMoveDepth = 3; // Shallowest.
+
+    int GetRazoringMargin(const PruningOptions& pruning, int depth);
+    int GetFutilityMargin(const PruningOptions& pruning, int depth);
+    /* Number of quiet moves searched before the rest are pruned. */
+    int GetLateMovePruningCount(const PruningOptions& pruning, int depth);
+    int GetNullMoveReduction(const PruningOptions& pruning, int depth);
+
+    /* Late move reductions by [depth][move number] , built from the pruning options when a search starts. */
+    class ReductionTable {
+    public:
+        explicit ReductionTable(const PruningOptions& pruning);
+
+        int Get(int depth, int moveNumber) const;
+
+    private:
+        int8_t reductions[64][64]{};
+    };
+
+    /*******************************************************/
+    /* Position and move helpers                           */
+    /*******************************************************/
+
+    bool IsQuiet(const MoveGeneration::Move& move);
+    bool SameMove(const MoveGeneration::Move& a, const MoveGeneration::Move& b);
+    bool InCheck(const Board& board);
+
+    bool HasNonPawnMaterial(const BoardState& state, Color color);
+    /* Positions where passing is likely better than any move , null move results can't be trusted there. */
+    bool IsZugzwangProne(const BoardState& state, Color color);
+
+    /* Fifty move rule or a repetition of a position in keys (one is enough inside a search ,
+     * the side that could avoid it didn't). A mate on the fiftieth move still counts. */
+    bool IsSearchDraw(const Board& board, const KeyHistory& keys);
+
+    /* Static evaluation through the shared evaluation cache , counts its probes and hits. */
+    int CachedEvaluate(const BoardState& state, SearchStats& stats);
+
+    /* The score of a tablebase position (see Tablebase::Probe) , its mates counted from the root.
+     * False without a table or when the fifty move rule would end the game before the mate. */
+    bool ProbeTablebase(const BoardState& state, int ply, int& score);
+
+    /* Mate scores are stored relative to the node instead of the root. */
+    int ScoreToTT(int score, int ply);
+    int ScoreFromTT(int score, int ply);
+
+    /*******************************************************/
+    /* Move ordering                                       */
+    /*******************************************************/
+
+    struct ScoredMove {
+        MoveGeneration::Move move;
+        int score;
+    };
+
+    /* Sorts by tt move , MVV-LVA captures , promotions , killers and history into scoredMoves
+     * (room for all the moves) and returns their number. Moves with the same score keep their order.
+     * Killers ([2]) and history ([from][to]) can be null when not used. */
+    int OrderMoves(const MoveGeneration::MoveList& moves, uint16_t ttMove, const MoveGeneration::Move* killers,
+                   const int (*history)[64], ScoredMove* scoredMoves);
+
+}
+
+#endif
@@ -0,0 +1,64 @@
+#include "SearchStats.h"
+
+namespace ChessEngine::Search {
+
+    void SearchStats::Add(const SearchStats& other) {
+        nodes += other.nodes;
+        quiescenceNodes += other.quiescenceNodes;
+        ttProbes += other.ttProbes;
+        ttHits += other.ttHits;
+        ttCutoffs += other.ttCutoffs;
+        betaCutoffs += other.betaCutoffs;
+        firstMoveCutoffs += other.firstMoveCutoffs;
+        nullMoveTries += other.nullMoveTries;
+        nullMoveCutoffs += other.nullMoveCutoffs;
+        lmrSearches += other.lmrSearches;
+        lmrResearches += other.lmrResearches;
+        evalProbes += other.evalProbes;
+        evalHits += other.evalHits;
+        tablebaseHits += other.tablebaseHits;
+    }
+
+    SearchStats SearchStatistics::Aggregate() const {
+        SearchStats total;
+        for (auto& stats : threadStats)
+            total.Add(stats);
+        return total;
+    }
+
+    void SearchStatistics::AddIteration(int depth, uint64_t totalNodes, int64_t totalTimeMs) {
+        IterationStats iteration;
+        iteration.depth = depth;
+        iteration.nodes = totalNodes - previousNodes;
+        iteration.timeMs = totalTimeMs - previousTimeMs;
+        if (!iterations.empty() && iterations.back().nodes != 0)
+            iteration.branchingFactor = (double) iteration.nodes / (double) iterations.back().nodes;
+
+        iterations.push_back(iteration);
+        previousNodes = totalNodes;
+        previousTimeMs = totalTimeMs;
+    }
+
+    static double Percent(uint64_t part, uint64_t total) {
+        return total == 0 ? 0.0 : 100.0 * (double) part / (double) total;
+    }
+
+    std::ostream& operator<<(std::ostream& out, const SearchStats& stats) {
+        out << "nodes " << stats.nodes
+            << " , qnodes " << stats.quiescenceNodes << std::endl
+            << "tt probes " << stats.ttProbes
+            << " , hits " << Percent(stats.ttHits, stats.ttProbes) << "%"
+            << " , cutoffs " << stats.ttCutoffs << std::endl
+            << "beta cutoffs " << stats.betaCutoffs
+            << " , on first move " << Percent(stats.firstMoveCutoffs, stats.betaCutoffs) << "%" << std::endl
+            << "null moves " << stats.nullMoveTries
+            << " , cutoffs " << Percent(stats.nullMoveCutoffs, stats.nullMoveTries) << "%" << std::endl
+            << "lmr searches " << stats.lmrSearches
+            << " , re-searches " << Percent(stats.lmrResearches, stats.lmrSearches) << "%" << std::endl
+            << "eval cache probes " << stats.evalProbes
+            << " , hits " << Percent(stats.evalHits, stats.evalProbes) << "%" << std::endl
+            << "tablebase hits " << stats.tablebaseHits;
+        return out;
+    }
+
+}
@@ -0,0 +1,75 @@
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+#include <cstdint>
+#include <vector>
+#include <ostream>
+
+// Counting is compiled out when ENGINE_SEARCH_STATS isn't defined (see Engine/CMakeLists.txt).
+#ifdef ENGINE_SEARCH_STATS
+#define SEARCH_STATS_INC(stats, counter) ((stats).counter++)
+#else
+#define SEARCH_STATS_INC(stats, counter) ((void) (stats))
+#endif
+
+namespace ChessEngine::Search {
+
+    /* Counters of a single search thread. Aligned to a cache line so
+     * threads updating their own counters don't invalidate each other's lines.
+     * Without ENGINE_SEARCH_STATS nothing writes to them or sums them. */
+    struct alignas(64) SearchStats {
+        uint64_t nodes = 0;
+        uint64_t quiescenceNodes = 0;
+
+        uint64_t ttProbes = 0;
+        uint64_t ttHits = 0;
+        uint64_t ttCutoffs = 0;
+
+        uint64_t betaCutoffs = 0;
+        uint64_t firstMoveCutoffs = 0; // Beta cutoffs caused by the first searched move.
+
+        uint64_t nullMoveTries = 0;
+        uint64_t nullMoveCutoffs = 0;
+
+        uint64_t lmrSearches = 0;
+        uint64_t lmrResearches = 0; // Reduced searches that beat alpha and had to be searched again.
+
+        uint64_t evalProbes = 0;
+        uint64_t evalHits = 0;
+
+        uint64_t tablebaseHits = 0;
+
+        void Add(const SearchStats& other);
+    };
+
+    struct IterationStats {
+        int depth = 0;
+        uint64_t nodes = 0; // Nodes of this iteration only.
+        int64_t timeMs = 0; // Time of this iteration only.
+        double branchingFactor = 0.0; // Nodes compared to the previous iteration.
+    };
+
+    /* Per thread counters , summed only when requested. */
+    class SearchStatistics {
+    public:
+        explicit SearchStatistics(int threadCount = 1) : threadStats(threadCount) {}
+
+        SearchStats& ForThread(int threadIndex) { return threadStats[threadIndex]; }
+        SearchStats Aggregate() const;
+
+        void AddIteration(int depth, uint64_t totalNodes, int64_t totalTimeMs);
+        const std::vector<IterationStats>& GetIterations() const { return iterations; }
+
+    private:
+        std::vector<SearchStats> threadStats;
+        std::vector<IterationStats> iterations;
+
+        uint64_t previousNodes = 0;
+        int64_t previousTimeMs = 0;
+    };
+
+    std::ostream& operator<<(std::ostream& out, const SearchStats& stats);
+
+}
+
+#endif
@@ -0,0 +1,49 @@
+#include "SearchTrace.h"
+
+#include <cstring>
+
+namespace ChessEngine::Search {
+
+    bool TraceWriter::Open(const std::string& path, int threadIndex) {
+        Close();
+
+        file.open(path, std::ios::binary | std::ios::app);
+        if (!file)
+            return false;
+
+        // A new file starts with the header , searches after the first are appended.
+        file.seekp(0, std::ios::end);
+        if (file.tellp() == 0) {
+            char header[traceHeaderSize] = {};
+            uint32_t thread = (uint32_t) threadIndex;
+            std::memcpy(header, traceMagic, sizeof(traceMagic));
+            std::memcpy(header + 8, &traceVersion, sizeof(traceVersion));
+            std::memcpy(header + 12, &thread, sizeof(thread));
+            file.write(header, traceHeaderSize);
+        }
+
+        buffer.reserve(bufferSize);
+        edge = {0, 0, 0, -1};
+        level = 0;
+        taskLevel = -1;
+        return true;
+    }
+
+    void TraceWriter::Close() {
+        if (!file.is_open())
+            return;
+
+        Flush();
+        file.close();
+    }
+
+    void TraceWriter::Flush() {
+        file.write((const char*) buffer.data(), (std::streamsize) (buffer.size() * sizeof(TraceRecord)));
+        buffer.clear();
+    }
+
+    std::string GetTracePath(const std::string& path, int threadIndex) {
+        return path + "." + std::to_string(threadIndex);
+    }
+
+}
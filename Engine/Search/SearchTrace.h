@@ -0,0 +1,156 @@
+#ifndef SEARCH_TRACE_H
+#define SEARCH_TRACE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "../MoveGeneration/Move.h"
+
+// Tracing is compiled out when ENGINE_SEARCH_TRACE isn't defined (see Engine/CMakeLists.txt).
+// Before every recursive call the caller sets the edge to the node : the move played (with its reduction) ,
+// a null move or none when the node searches its own position again (verification , razoring).
+#ifdef ENGINE_SEARCH_TRACE
+#define SEARCH_TRACE_EDGE(trace, move, reduction) ((trace).SetEdge(MoveGeneration::PackMove(move), (reduction), 0))
+#define SEARCH_TRACE_NULL_EDGE(trace, reduction) ((trace).SetEdge(0, (reduction), TraceFlags::NullMove))
+#define SEARCH_TRACE_NO_EDGE(trace) ((trace).SetEdge(0, 0, 0))
+#else
+#define SEARCH_TRACE_EDGE(trace, move, reduction) ((void) 0)
+#define SEARCH_TRACE_NULL_EDGE(trace, reduction) ((void) 0)
+#define SEARCH_TRACE_NO_EDGE(trace) ((void) 0)
+#endif
+
+namespace ChessEngine::Search {
+
+    /* A binary log of every node a search visits , written when the node returns (post order) so its
+     * record has the score. A node's children are the records before it with a level (recursion depth
+     * in the thread) one higher , back to the previous record of its own level or lower. Tools/Trace
+     * rebuilds the tree. The file is a 16 byte header (the magic "CETRACE" , a version and the thread
+     * index) followed by the records , searches are appended to it. */
+
+    enum class TraceNodeType : uint8_t {
+        Pv, // Score inside the window.
+        Cut, // Failed high.
+        All // Failed low.
+    };
+
+    namespace TraceFlags {
+        constexpr uint8_t TypeMask = 3;
+        constexpr uint8_t Quiescence = 1 << 2;
+        constexpr uint8_t NullMove = 1 << 3;
+        constexpr uint8_t Task = 1 << 4; // A split task of ParallelSearch , its real parent can be in another thread's file.
+        constexpr uint8_t Stopped = 1 << 5; // Score meaningless , the search was stopped.
+    }
+
+    struct TraceRecord {
+        uint16_t move; // MoveGeneration::PackMove of the move into the node , 0 for roots , null moves and re-searches.
+        uint8_t level;
+        uint8_t ply;
+        int16_t alpha;
+        int16_t beta;
+        int16_t score;
+        int8_t depth; // Remaining depth , 0 in quiescence.
+        uint8_t reduction; // Late move or null move reduction.
+        uint8_t flags; // TraceNodeType | TraceFlags.
+        uint8_t reserved[3];
+    };
+
+    static_assert(sizeof(TraceRecord) == 16, "Trace records are stored as they are in memory");
+
+    constexpr char traceMagic[8] = {'C', 'E', 'T', 'R', 'A', 'C', 'E', '\0'};
+    constexpr uint32_t traceVersion = 1;
+    constexpr size_t traceHeaderSize = 16;
+
+    /* Buffered writer of a single search thread. */
+    class TraceWriter {
+    public:
+        TraceWriter() = default;
+        ~TraceWriter() { Close(); }
+
+        TraceWriter(const TraceWriter&) = delete;
+        TraceWriter& operator=(const TraceWriter&) = delete;
+
+        /* Appends to path , false when it can't be opened. */
+        bool Open(const std::string& path, int threadIndex);
+        void Close();
+        bool IsOpen() const { return file.is_open(); }
+
+        // Called from the parent's search , one level deeper than the parent already.
+        void SetEdge(uint16_t move, int reduction, uint8_t flags) {
+            edge = {move, reduction, flags, level};
+        }
+
+        /* Runs search (returning the node's score) one level deeper and records the node. */
+        template<typename Function, typename Stopped>
+        int Node(int ply, int depth, int alpha, int beta, uint8_t flags, Function search, Stopped stopped) {
+            // A stale edge of a node that wasn't recorded (eg: a draw at the horizon) isn't this node's.
+            Edge nodeEdge = edge.level == level ? edge : Edge{0, 0, 0, level};
+            edge.level = -1;
+
+            level++;
+            int score = search();
+            level--;
+
+            TraceRecord record{};
+            record.move = nodeEdge.move;
+            record.level = (uint8_t) level;
+            record.ply = (uint8_t) ply;
+            record.alpha = (int16_t) alpha;
+            record.beta = (int16_t) beta;
+            record.score = (int16_t) score;
+            record.depth = (int8_t) depth;
+            record.reduction = (uint8_t) nodeEdge.reduction;
+            record.flags = flags | nodeEdge.flags | (uint8_t) GetNodeType(score, alpha, beta);
+            if (level == taskLevel)
+                record.flags |= TraceFlags::Task;
+            if (stopped())
+                record.flags |= TraceFlags::Stopped;
+
+            buffer.push_back(record);
+            if (buffer.size() == bufferSize)
+                Flush();
+            return score;
+        }
+
+        /* The nodes started at the current level are split tasks , until EndTask restores the previous level. */
+        int BeginTask() {
+            int previous = taskLevel;
+            taskLevel = level;
+            return previous;
+        }
+        void EndTask(int previous) { taskLevel = previous; }
+
+    private:
+        struct Edge {
+            uint16_t move;
+            int reduction;
+            uint8_t flags;
+            int level; // Of the child the edge leads to.
+        };
+
+        static TraceNodeType GetNodeType(int score, int alpha, int beta) {
+            if (score >= beta)
+                return TraceNodeType::Cut;
+            if (score <= alpha)
+                return TraceNodeType::All;
+            return TraceNodeType::Pv;
+        }
+
+        void Flush();
+
+        static constexpr size_t bufferSize = 1 << 16;
+
+        std::ofstream file;
+        std::vector<TraceRecord> buffer;
+        Edge edge{0, 0, 0, -1};
+        int level = 0;
+        int taskLevel = -1;
+    };
+
+    /* Trace file of a search thread , "<path>.<thread index>". */
+    std::string GetTracePath(const std::string& path, int threadIndex);
+
+}
+
+#endif
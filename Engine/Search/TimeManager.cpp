@@ -0,0 +1,76 @@
+#include "TimeManager.h"
+
+#include <algorithm>
+
+namespace ChessEngine::Search {
+
+    // Time kept aside for move overhead (rendering , thread wake ups etc).
+    constexpr int64_t moveOverheadMs = 30;
+    // Moves assumed to be left when playing sudden death.
+    constexpr int defaultMovesToGo = 30;
+
+    void TimeManager::Start(const TimeControl& control) {
+        startTime = std::chrono::steady_clock::now();
+        stabilityFactor = 1.0;
+        scoreDropFactor = 1.0;
+        stableIterations = 0;
+        iterations = 0;
+
+        active = control.remainingMs > 0;
+        if (!active)
+            return;
+
+        int64_t available = std::max<int64_t>(control.remainingMs - moveOverheadMs, 1);
+        int movesToGo = (control.movesToGo > 0) ? std::min(control.movesToGo, defaultMovesToGo) : defaultMovesToGo;
+
+        int64_t optimum = available / movesToGo + control.incrementMs * 3 / 4;
+        softLimitMs = std::min(optimum, available);
+        // Never use more than a fraction of the clock on a single move.
+        int64_t maxMs = (control.movesToGo == 1) ? available : available * 3 / 4;
+        hardLimitMs = std::min(optimum * 4, maxMs);
+        softLimitMs = std::min(softLimitMs, hardLimitMs);
+    }
+
+    void TimeManager::UpdateIteration(bool bestMoveChanged, int previousScore, int score) {
+        // An unstable best move means the search hasn't settled , give it more time.
+        if (bestMoveChanged) {
+            stableIterations = 0;
+            stabilityFactor = std::min(stabilityFactor * 1.4, 2.0);
+        } else {
+            stableIterations++;
+            if (stableIterations >= 3)
+                stabilityFactor = std::max(stabilityFactor * 0.85, 0.5);
+        }
+
+        // A falling score means trouble was found , search longer to find a way out.
+        // The first iteration has nothing to compare with.
+        if (iterations++ == 0)
+            return;
+
+        int drop = previousScore - score;
+        if (drop >= 50)
+            scoreDropFactor = 1.6;
+        else if (drop >= 20)
+            scoreDropFactor = 1.3;
+        else
+            scoreDropFactor = std::max(scoreDropFactor * 0.9, 1.0);
+    }
+
+    bool TimeManager::SoftLimitReached() const {
+        if (!active)
+            return false;
+
+        double scaled = (double) softLimitMs * stabilityFactor * scoreDropFactor;
+        return (double) ElapsedMs() >= std::min(scaled, (double) hardLimitMs);
+    }
+
+    bool TimeManager::HardLimitReached() const {
+        return active && ElapsedMs() >= hardLimitMs;
+    }
+
+    int64_t TimeManager::ElapsedMs() const {
+        auto elapsed = std::chrono::steady_clock::now() - startTime;
+        return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+    }
+
+}
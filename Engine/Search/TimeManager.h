@@ -0,0 +1,55 @@
+#ifndef TIME_MANAGER_H
+#define TIME_MANAGER_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace ChessEngine::Search {
+
+    struct TimeControl {
+        int64_t remainingMs = 0; // 0 means the search isn't timed.
+        int64_t incrementMs = 0;
+        int movesToGo = 0; // 0 means the rest of the game (sudden death).
+    };
+
+    /* Splits the remaining time into a soft limit , checked between iterations ,
+     * and a hard limit , polled during the search. The soft limit is scaled by how
+     * stable the best move is and how much the score dropped between iterations. */
+    class TimeManager {
+    public:
+        // Nodes between clock reads , needs to be a power of 2 minus 1.
+        static constexpr uint64_t pollMask = 1023;
+
+        void Start(const TimeControl& control);
+
+        bool IsActive() const { return active; }
+
+        /* Should be called after every completed iteration. previousScore is ignored after the first one. */
+        void UpdateIteration(bool bestMoveChanged, int previousScore, int score);
+
+        /* Checked between iterations , starting a new iteration isn't worth it. */
+        bool SoftLimitReached() const;
+        /* Checked during the search every pollMask nodes. */
+        bool HardLimitReached() const;
+
+        int64_t ElapsedMs() const;
+        int64_t GetSoftLimitMs() const { return softLimitMs; }
+        int64_t GetHardLimitMs() const { return hardLimitMs; }
+
+    private:
+        bool active = false;
+        std::chrono::steady_clock::time_point startTime;
+
+        int64_t softLimitMs = 0;
+        int64_t hardLimitMs = 0;
+
+        // Scaling applied to the soft limit.
+        double stabilityFactor = 1.0;
+        double scoreDropFactor = 1.0;
+        int stableIterations = 0;
+        int iterations = 0; // Completed since Start.
+    };
+
+}
+
+#endif
@@ -0,0 +1,396 @@
+#include "TranspositionTable.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "../Hashing/Zobrist.h"
+
+namespace ChessEngine::Search {
+
+    // Data layout (64 bits):
+    // move 16 | score 16 | eval 16 | depth 8 | bound 2 | generation 6
+    constexpr uint8_t generationMask = 0x3F;
+
+    // Table files , the version changes whenever the entry layout does.
+    constexpr char fileMagic[8] = {'C', 'E', 'T', 'A', 'B', 'L', 'E', '\0'};
+    constexpr uint32_t fileVersion = 1;
+
+    TranspositionTable::TranspositionTable(size_t megabytes) {
+        Resize(megabytes);
+    }
+
+    TranspositionTable::~TranspositionTable() {
+        Release();
+    }
+
+    void TranspositionTable::Release() {
+        if (sharedHeader)
+            DetachShared();
+        Memory::Unmap(mapping);
+
+        entries = nullptr;
+        header = nullptr;
+        entryCount = 0;
+    }
+
+    size_t TranspositionTable::GetEntryCount(size_t megabytes) {
+        // Round down to a power of 2 number of entries.
+        size_t maxEntries = megabytes * 1024 * 1024 / sizeof(Entry);
+        size_t count = 1;
+        while (count * 2 <= maxEntries)
+            count *= 2;
+        return count;
+    }
+
+    void TranspositionTable::Resize(size_t megabytes) {
+        Release();
+
+        entryCount = GetEntryCount(megabytes);
+        if (!Memory::Allocate(entryCount * sizeof(Entry), Memory::GetOptions().hugePages, mapping))
+            throw std::bad_alloc();
+
+        entries = (Entry*) mapping.address;
+        Clear();
+    }
+
+    void TranspositionTable::Clear() {
+        if (Memory::GetOptions().numaFirstTouch) {
+            Memory::FirstTouch(entries, entryCount * sizeof(Entry));
+        } else {
+            for (size_t i = 0; i < entryCount; i++) {
+                entries[i].key.store(0, std::memory_order_relaxed);
+                entries[i].data.store(0, std::memory_order_relaxed);
+            }
+        }
+        generation = 0;
+        if (header)
+            header->generation = generation;
+    }
+
+    void TranspositionTable::NewSearch() {
+        generation = (generation + 1) & generationMask;
+        if (header)
+            header->generation = generation;
+    }
+
+    const Memory::Mapping& TranspositionTable::GetMapping() const {
+        return mapping;
+    }
+
+    /*******************************************************/
+    /* Table files                                         */
+    /*******************************************************/
+
+    // Entries live in raw mapped memory and the file holds them as they are in memory.
+    static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t) && std::atomic<uint64_t>::is_always_lock_free);
+
+    TranspositionTable::FileHeader TranspositionTable::MakeHeader() const {
+        FileHeader fileHeader = {};
+        std::memcpy(fileHeader.magic, fileMagic, sizeof(fileMagic));
+        fileHeader.version = fileVersion;
+        fileHeader.entrySize = sizeof(Entry);
+        fileHeader.entryCount = entryCount;
+        fileHeader.hashScheme = Zobrist::GetSchemeKey();
+        fileHeader.generation = generation;
+        return fileHeader;
+    }
+
+    bool TranspositionTable::MapFile(const std::string& path, size_t megabytes, bool& reattached) {
+        size_t count = GetEntryCount(megabytes);
+        Memory::Mapping newMapping;
+        bool existed = false;
+        if (!Memory::MapFile(path, sizeof(FileHeader) + count * sizeof(Entry), newMapping, existed))
+            return false;
+
+        Release();
+        mapping = newMapping;
+        header = (FileHeader*) mapping.address;
+        entries = (Entry*) (header + 1);
+        entryCount = count;
+
+        FileHeader expected = MakeHeader();
+        reattached = existed &&
+                     std::memcmp(header->magic, expected.magic, sizeof(fileMagic)) == 0 &&
+                     header->version == expected.version &&
+                     header->entrySize == expected.entrySize &&
+                     header->entryCount == expected.entryCount &&
+                     header->hashScheme == expected.hashScheme;
+
+        if (reattached) {
+            generation = header->generation & generationMask;
+        } else {
+            // The header is written last so a file cut short while clearing is never reattached.
+            std::memset(header, 0, sizeof(FileHeader));
+            Clear();
+            *header = MakeHeader();
+        }
+
+        return true;
+    }
+
+    /*******************************************************/
+    /* Shared tables                                       */
+    /*******************************************************/
+
+    // Taken by a process while it attaches or detaches. A process that died holding it never
+    // gives it back , the next one takes it over.
+    static void LockShared(std::atomic<uint64_t>& lock, uint64_t processId) {
+        while (true) {
+            uint64_t owner = 0;
+            if (lock.compare_exchange_weak(owner, processId, std::memory_order_acquire))
+                return;
+            if (owner != 0 && !Memory::IsProcessAlive(owner) &&
+                lock.compare_exchange_strong(owner, processId, std::memory_order_acquire)) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    static void UnlockShared(std::atomic<uint64_t>& lock) {
+        lock.store(0, std::memory_order_release);
+    }
+
+    bool TranspositionTable::AttachShared(const std::string& name, size_t megabytes, bool& reattached) {
+        size_t count = GetEntryCount(megabytes);
+        size_t size = sizeof(SharedHeader) + count * sizeof(Entry);
+        uint64_t processId = Memory::GetProcessId();
+
+        FileHeader expected = MakeHeader();
+        expected.entryCount = count;
+        expected.generation = 0;
+
+        // A segment can be removed by its last process or found stale between opening and locking it ,
+        // the next try opens (or creates) the segment that replaced it.
+        constexpr int tries = 8;
+        for (int attempt = 0; attempt < tries; attempt++) {
+            Memory::Mapping newMapping;
+            bool created = false;
+            if (!Memory::MapShared(name, size, newMapping, created)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10)); // Still being sized.
+                continue;
+            }
+
+            if (newMapping.size < sizeof(SharedHeader)) {
+                Memory::Unmap(newMapping);
+                Memory::RemoveShared(name); // Not a table.
+                continue;
+            }
+
+            auto* segment = (SharedHeader*) newMapping.address;
+            int slot = 0;
+            if (created) {
+                // New segments are zeroed , only the headers need writing.
+                segment->processes[slot].store(processId, std::memory_order_relaxed);
+                segment->table = expected;
+                segment->ready.store(1, std::memory_order_release);
+            } else {
+                // Wait for the creator to write the header , give up on it once it died.
+                auto start = std::chrono::steady_clock::now();
+                while (!segment->ready.load(std::memory_order_acquire) &&
+                       std::chrono::steady_clock::now() - start < std::chrono::seconds(1)) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                if (!segment->ready.load(std::memory_order_acquire)) {
+                    uint64_t creator = segment->processes[0].load(std::memory_order_relaxed);
+                    Memory::Unmap(newMapping);
+                    if (creator != 0 && Memory::IsProcessAlive(creator))
+                        return false;
+                    Memory::RemoveShared(name);
+                    continue;
+                }
+
+                LockShared(segment->lock, processId);
+                if (segment->removed.load(std::memory_order_relaxed)) {
+                    UnlockShared(segment->lock);
+                    Memory::Unmap(newMapping);
+                    continue;
+                }
+
+                // Drop the processes that died without detaching.
+                int liveProcesses = 0;
+                slot = -1;
+                for (int i = 0; i < maxSharedProcesses; i++) {
+                    uint64_t attached = segment->processes[i].load(std::memory_order_relaxed);
+                    if (attached != 0 && !Memory::IsProcessAlive(attached)) {
+                        segment->processes[i].store(0, std::memory_order_relaxed);
+                        attached = 0;
+                    }
+                    if (attached != 0)
+                        liveProcesses++;
+                    else if (slot < 0)
+                        slot = i;
+                }
+
+                const FileHeader& table = segment->table;
+                bool matches = newMapping.size >= size &&
+                               std::memcmp(table.magic, expected.magic, sizeof(fileMagic)) == 0 &&
+                               table.version == expected.version &&
+                               table.entrySize == expected.entrySize &&
+                               table.entryCount == expected.entryCount &&
+                               table.hashScheme == expected.hashScheme;
+
+                if (!matches || slot < 0) {
+                    bool stale = liveProcesses == 0;
+                    if (stale) {
+                        // Left by processes that died , make room for a new one.
+                        segment->removed.store(1, std::memory_order_relaxed);
+                        Memory::RemoveShared(name);
+                    }
+                    UnlockShared(segment->lock);
+                    Memory::Unmap(newMapping);
+                    if (stale)
+                        continue;
+                    return false;
+                }
+
+                segment->processes[slot].store(processId, std::memory_order_relaxed);
+                UnlockShared(segment->lock);
+            }
+
+            Release();
+            mapping = newMapping;
+            sharedHeader = segment;
+            header = &segment->table;
+            entries = (Entry*) (segment + 1);
+            entryCount = count;
+            generation = header->generation & generationMask;
+            sharedName = name;
+            sharedSlot = slot;
+
+            reattached = !created;
+            return true;
+        }
+
+        return false;
+    }
+
+    void TranspositionTable::DetachShared() {
+        LockShared(sharedHeader->lock, Memory::GetProcessId());
+        sharedHeader->processes[sharedSlot].store(0, std::memory_order_relaxed);
+
+        // The last live process removes the segment , later processes create a new one.
+        bool last = true;
+        for (auto& attached : sharedHeader->processes) {
+            uint64_t processId = attached.load(std::memory_order_relaxed);
+            if (processId != 0 && Memory::IsProcessAlive(processId))
+                last = false;
+        }
+        if (last) {
+            sharedHeader->removed.store(1, std::memory_order_relaxed);
+            Memory::RemoveShared(sharedName);
+        }
+        UnlockShared(sharedHeader->lock);
+
+        sharedHeader = nullptr;
+        sharedName.clear();
+        sharedSlot = -1;
+    }
+
+    bool TranspositionTable::IsShared() const {
+        return sharedHeader != nullptr;
+    }
+
+    bool TranspositionTable::Flush() {
+        return Memory::FlushMapping(mapping);
+    }
+
+    bool TranspositionTable::Save(const std::string& path) const {
+        // NOTE: Should not be the file the table is mapped to , use Flush for that.
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        FileHeader fileHeader = MakeHeader();
+        file.write((const char*) &fileHeader, sizeof(fileHeader));
+
+        // Entries are written in chunks , read one at a time so a search can keep running.
+        constexpr size_t chunkEntries = 4096;
+        std::vector<uint64_t> chunk;
+        chunk.reserve(chunkEntries * 2);
+        for (size_t i = 0; i < entryCount; i++) {
+            chunk.push_back(entries[i].key.load(std::memory_order_relaxed));
+            chunk.push_back(entries[i].data.load(std::memory_order_relaxed));
+            if (chunk.size() == chunk.capacity() || i + 1 == entryCount) {
+                file.write((const char*) chunk.data(), (std::streamsize) (chunk.size() * sizeof(uint64_t)));
+                chunk.clear();
+            }
+        }
+
+        return (bool) file;
+    }
+
+    uint64_t TranspositionTable::Pack(const TTData& data, uint8_t generation) {
+        return (uint64_t) data.move |
+               (uint64_t) (uint16_t) data.score << 16 |
+               (uint64_t) (uint16_t) data.eval << 32 |
+               (uint64_t) data.depth << 48 |
+               (uint64_t) data.bound << 56 |
+               (uint64_t) (generation & generationMask) << 58;
+    }
+
+    TTData TranspositionTable::Unpack(uint64_t data) {
+        TTData unpacked;
+        unpacked.move = data & 0xFFFF;
+        unpacked.score = (int16_t) (data >> 16 & 0xFFFF);
+        unpacked.eval = (int16_t) (data >> 32 & 0xFFFF);
+        unpacked.depth = data >> 48 & 0xFF;
+        unpacked.bound = (Bound) (data >> 56 & 0x3);
+        return unpacked;
+    }
+
+    uint8_t TranspositionTable::GetGeneration(uint64_t data) {
+        return data >> 58 & generationMask;
+    }
+
+    bool TranspositionTable::Probe(uint64_t key, TTData& data) const {
+        const Entry& entry = entries[key & (entryCount - 1)];
+        uint64_t entryData = entry.data.load(std::memory_order_relaxed);
+        uint64_t entryKey = entry.key.load(std::memory_order_relaxed);
+
+        if ((entryKey ^ entryData) != key || entryData == 0)
+            return false;
+
+        data = Unpack(entryData);
+        return true;
+    }
+
+    void TranspositionTable::Store(uint64_t key, const TTData& data) {
+        Entry& entry = entries[key & (entryCount - 1)];
+        uint64_t oldData = entry.data.load(std::memory_order_relaxed);
+        uint64_t oldKey = entry.key.load(std::memory_order_relaxed) ^ oldData;
+        TTData old = Unpack(oldData);
+
+        // Prefer keeping deep entries of the current search.
+        bool replace = oldKey != key ||
+                       GetGeneration(oldData) != generation ||
+                       data.bound == Bound::BoundExact ||
+                       data.depth + 2 >= old.depth;
+        if (!replace)
+            return;
+
+        TTData newData = data;
+        if (newData.move == 0 && oldKey == key)
+            newData.move = old.move; // Keep the best move of an older search of the same position.
+
+        uint64_t packed = Pack(newData, generation);
+        entry.key.store(key ^ packed, std::memory_order_relaxed);
+        entry.data.store(packed, std::memory_order_relaxed);
+    }
+
+    int TranspositionTable::Hashfull() const {
+        size_t sample = (entryCount < 1000) ? entryCount : 1000;
+        int used = 0;
+        for (size_t i = 0; i < sample; i++) {
+            uint64_t data = entries[i].data.load(std::memory_order_relaxed);
+            if (data != 0 && GetGeneration(data) == generation)
+                used++;
+        }
+        return (int) (used * 1000 / sample);
+    }
+
+}
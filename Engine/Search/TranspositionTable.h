@@ -0,0 +1,126 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "../Utilities/Memory.h"
+
+namespace ChessEngine::Search {
+
+    enum Bound : uint8_t {
+        BoundNone, BoundUpper, BoundLower, BoundExact
+    };
+
+    struct TTData {
+        uint16_t move = 0; // Packed move , see MoveGeneration::PackMove.
+        int16_t score = 0;
+        int16_t eval = 0;
+        uint8_t depth = 0;
+        Bound bound = Bound::BoundNone;
+    };
+
+    class TranspositionTable {
+    public:
+        explicit TranspositionTable(size_t megabytes);
+        ~TranspositionTable();
+
+        TranspositionTable(const TranspositionTable&) = delete;
+        TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+        /* Reallocate the table , previous entries are lost. */
+        void Resize(size_t megabytes);
+        void Clear();
+
+        /* Place the table in a memory mapped file so a later run can reattach it without copying.
+         * A file with a matching header (version , size and Zobrist keys) is reattached ,
+         * anything else is overwritten with an empty table. On failure the table keeps its
+         * previous storage. Resize moves the table back to memory. */
+        bool MapFile(const std::string& path, size_t megabytes, bool& reattached);
+
+        /* Place the table in the shared memory segment name (eg: "/chess-engine-table") so the engine
+         * processes of the machine search with one table , through the same lockless entries. The first
+         * process creates the segment , the others attach when its size and Zobrist keys match (reattached
+         * is then true). Processes that died attached are dropped , a segment only they used that doesn't
+         * match is removed and created again. On failure (a live process uses the name with another size)
+         * the table keeps its previous storage. Resize , MapFile and the destructor detach , the last
+         * process to detach removes the segment. Clear empties the table of every process. */
+        bool AttachShared(const std::string& name, size_t megabytes, bool& reattached);
+        bool IsShared() const;
+
+        /* Write a mapped table back to its file now instead of when the OS decides to. */
+        bool Flush();
+
+        /* Write a snapshot of the table in the format MapFile reads. */
+        bool Save(const std::string& path) const;
+
+        /* Should be called before every new search so older entries get replaced first. */
+        void NewSearch();
+
+        bool Probe(uint64_t key, TTData& data) const;
+        void Store(uint64_t key, const TTData& data);
+
+        /* The memory holding the entries , to report the pages it got (see Memory::MemoryOptions). */
+        const Memory::Mapping& GetMapping() const;
+
+        /* Permille of the first entries that belong to the current search. */
+        int Hashfull() const;
+
+        /* Entry encoding , also used by tables with their own storage. */
+        static uint64_t Pack(const TTData& data, uint8_t generation);
+        static TTData Unpack(uint64_t data);
+
+    private:
+        // Lockless entries , the key is stored xored with the data so a torn
+        // write from another thread makes the entry fail verification instead
+        // of returning a mixed up result.
+        struct Entry {
+            std::atomic<uint64_t> key;
+            std::atomic<uint64_t> data;
+        };
+
+        // Start of a table file , the entries follow.
+        struct alignas(64) FileHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t entrySize;
+            uint64_t entryCount;
+            uint64_t hashScheme;
+            uint8_t generation;
+        };
+
+        static constexpr int maxSharedProcesses = 64;
+
+        // Start of a shared segment , the table's header and the processes attached to it.
+        struct alignas(64) SharedHeader {
+            FileHeader table;
+            std::atomic<uint32_t> ready; // Set once the creator wrote the table's header.
+            std::atomic<uint32_t> removed; // The name is gone , attach to a new segment instead.
+            std::atomic<uint64_t> lock; // Process attaching or detaching , 0 when free.
+            std::atomic<uint64_t> processes[maxSharedProcesses]; // Attached process ids , 0 for a free slot.
+        };
+
+        Entry* entries = nullptr;
+        size_t entryCount = 0; // Always a power of 2 so the key can be masked.
+        uint8_t generation = 0;
+
+        Memory::Mapping mapping;
+        FileHeader* header = nullptr;
+
+        SharedHeader* sharedHeader = nullptr;
+        std::string sharedName;
+        int sharedSlot = -1;
+
+        void Release();
+        void DetachShared();
+        FileHeader MakeHeader() const;
+
+        static size_t GetEntryCount(size_t megabytes);
+        static uint8_t GetGeneration(uint64_t data);
+    };
+
+}
+
+#endif
@@ -0,0 +1,38 @@
+#include "TunableOptions.h"
+
+#include <algorithm>
+
+namespace ChessEngine::Search {
+
+    const std::vector<TunableOption>& GetTunableOptions() {
+        static const std::vector<TunableOption> options = {
+                {"reverseFutilityMargin", &PruningOptions::reverseFutilityMargin, 20, 300, 10},
+                {"futilityMargin", &PruningOptions::futilityMargin, 20, 400, 15},
+                {"razoringMargin", &PruningOptions::razoringMargin, 50, 1000, 30},
+                {"razoringDepthMargin", &PruningOptions::razoringDepthMargin, 0, 1000, 30},
+                {"nullMoveReduction", &PruningOptions::nullMoveReduction, 1, 6, 1},
+                {"nullMoveDepthDivisor", &PruningOptions::nullMoveDepthDivisor, 2, 16, 1},
+                {"lateMovePruningBase", &PruningOptions::lateMovePruningBase, 0, 20, 1},
+                {"lateMoveReductionBase", &PruningOptions::lateMoveReductionBase, -100, 300, 10},
+                {"lateMoveReductionDivisor", &PruningOptions::lateMoveReductionDivisor, 100, 600, 20},
+        };
+        return options;
+    }
+
+    const TunableOption* FindTunableOption(const std::string& name) {
+        for (auto& option : GetTunableOptions())
+            if (option.name == name)
+                return &option;
+        return nullptr;
+    }
+
+    bool SetTunableOption(PruningOptions& pruning, const std::string& name, int value) {
+        const TunableOption* option = FindTunableOption(name);
+        if (!option)
+            return false;
+
+        pruning.*(option->field) = std::clamp(value, option->min, option->max);
+        return true;
+    }
+
+}
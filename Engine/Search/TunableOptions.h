@@ -0,0 +1,31 @@
+#ifndef TUNABLE_OPTIONS_H
+#define TUNABLE_OPTIONS_H
+
+#include <string>
+#include <vector>
+
+#include "Search.h"
+
+namespace ChessEngine::Search {
+
+    /* The numeric search parameters by name , so tools (the SPSA tuner) can set them
+     * without knowing PruningOptions. */
+    struct TunableOption {
+        std::string name;
+        int PruningOptions::* field;
+        int min;
+        int max;
+        int step; // A perturbation big enough to be measured in games.
+    };
+
+    const std::vector<TunableOption>& GetTunableOptions();
+
+    /* Nullptr when there is no such option. */
+    const TunableOption* FindTunableOption(const std::string& name);
+
+    /* The value is clamped to the option's range. False when there is no such option. */
+    bool SetTunableOption(PruningOptions& pruning, const std::string& name, int value);
+
+}
+
+#endif
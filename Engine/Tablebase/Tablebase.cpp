@@ -0,0 +1,368 @@
+#include "Tablebase.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+
+#include "../Evaluation/Material.h"
+#include "../Utilities/Memory.h"
+
+namespace ChessEngine::Tablebase {
+
+    using namespace BitboardUtil;
+
+    constexpr char fileMagic[8] = {'C', 'E', 'T', 'A', 'B', 'L', 'E', '\0'};
+    constexpr uint32_t fileVersion = 1;
+    constexpr size_t headerSize = 64;
+    constexpr size_t nameSize = 16;
+    constexpr const char* fileExtension = ".tb";
+
+    /*******************************************************/
+    /* Signatures                                          */
+    /*******************************************************/
+
+    static const std::string pieceOrder = "KQRBNP";
+
+    static PieceType CharToPieceType(char c) {
+        switch (c) {
+            case 'K': return PieceType::King;
+            case 'Q': return PieceType::Queen;
+            case 'R': return PieceType::Rook;
+            case 'B': return PieceType::Bishop;
+            case 'N': return PieceType::Knight;
+            case 'P': return PieceType::Pawn;
+            default: return PieceType::None;
+        }
+    }
+
+    static int GetOrder(PieceType type) {
+        return (int) pieceOrder.find(PieceTypeToChar(type, Color::White));
+    }
+
+    bool ParseSignature(const std::string& name, Signature& signature) {
+        size_t separator = name.find('v');
+        if (separator == std::string::npos)
+            return false;
+
+        Signature parsed;
+        std::string sides[2] = {name.substr(0, separator), name.substr(separator + 1)};
+        for (int side = 0; side < 2; side++) {
+            for (char c : sides[side]) {
+                PieceType type = CharToPieceType(c);
+                if (type == PieceType::None)
+                    return false;
+                parsed.pieces[side].push_back(type);
+            }
+
+            auto& pieces = parsed.pieces[side];
+            std::sort(pieces.begin(), pieces.end(), [](PieceType a, PieceType b) { return GetOrder(a) < GetOrder(b); });
+            if (std::count(pieces.begin(), pieces.end(), PieceType::King) != 1)
+                return false;
+        }
+
+        if (parsed.pieces[0].size() + parsed.pieces[1].size() > maxPieces)
+            return false;
+
+        signature = parsed;
+        return true;
+    }
+
+    std::string SignatureToString(const Signature& signature) {
+        std::string name;
+        for (int side = 0; side < 2; side++) {
+            if (side == 1)
+                name += 'v';
+            for (PieceType type : signature.pieces[side])
+                name += PieceTypeToChar(type, Color::White);
+        }
+        return name;
+    }
+
+    uint64_t GetSignatureKey(const Signature& signature, Color firstSide) {
+        uint64_t key = 0;
+        for (int side = 0; side < 2; side++) {
+            Color color = (side == 0) ? firstSide : InvertColor(firstSide);
+            for (PieceType type : signature.pieces[side])
+                if (type != PieceType::King)
+                    key += Evaluation::GetMaterialDelta(color, type);
+        }
+        return key;
+    }
+
+    /*******************************************************/
+    /* Indexing                                            */
+    /*******************************************************/
+
+    // Squares the first king is moved to , the a1-d1-d4 triangle without pawns and files A to D with them.
+    constexpr int pawnlessKingSquares = 10;
+    constexpr int pawnKingSquares = 32;
+
+    static int GetKingSlot(uint8_t square, bool hasPawns) {
+        int file = square % 8;
+        int rank = square / 8;
+        if (file > File::D)
+            return -1;
+        if (hasPawns)
+            return rank * 4 + file;
+        return (rank <= file) ? file * (file + 1) / 2 + rank : -1;
+    }
+
+    static constexpr std::array<uint8_t, pawnlessKingSquares> pawnlessKingTable = {0, 1, 9, 2, 10, 18, 3, 11, 19, 27};
+
+    static uint8_t GetKingSquare(int slot, bool hasPawns) {
+        return hasPawns ? (uint8_t) ((slot / 4) * 8 + slot % 4) : pawnlessKingTable[slot];
+    }
+
+    /* Bit 0 mirrors the files , bit 1 the ranks and bit 2 the a1-h8 diagonal (applied first). */
+    static uint8_t Transform(uint8_t square, int symmetry) {
+        if (symmetry & 4)
+            square = (uint8_t) (((square & 7) << 3) | (square >> 3));
+        if (symmetry & 1)
+            square ^= 7;
+        if (symmetry & 2)
+            square ^= 56;
+        return square;
+    }
+
+    TableIndex::TableIndex(const Signature& signature) {
+        for (int side = 0; side < 2; side++) {
+            for (PieceType type : signature.pieces[side]) {
+                types.push_back(type);
+                colors.push_back(side == 0 ? Color::White : Color::Black);
+                hasPawns |= type == PieceType::Pawn;
+            }
+        }
+
+        size = 2 * (uint64_t) (hasPawns ? pawnKingSquares : pawnlessKingSquares);
+        for (size_t i = 1; i < types.size(); i++)
+            size *= (types[i] == PieceType::Pawn) ? 48 : 64;
+    }
+
+    uint64_t TableIndex::GetRawIndex(const uint8_t* squares, Color turnOf) const {
+        uint64_t index = turnOf;
+        index = index * (hasPawns ? pawnKingSquares : pawnlessKingSquares) + GetKingSlot(squares[0], hasPawns);
+        for (size_t i = 1; i < types.size(); i++) {
+            if (types[i] == PieceType::Pawn)
+                index = index * 48 + (squares[i] - 8);
+            else
+                index = index * 64 + squares[i];
+        }
+        return index;
+    }
+
+    uint64_t TableIndex::GetIndex(const uint8_t* squares, Color turnOf) const {
+        int count = (int) types.size();
+        int symmetries = hasPawns ? 2 : 8;
+
+        uint64_t best = UINT64_MAX;
+        for (int symmetry = 0; symmetry < symmetries; symmetry++) {
+            uint8_t transformed[maxPieces];
+            for (int i = 0; i < count; i++)
+                transformed[i] = Transform(squares[i], symmetry);
+            if (GetKingSlot(transformed[0], hasPawns) < 0)
+                continue;
+
+            // Identical pieces in square order , swapping them gives the same position.
+            for (int i = 1; i < count; i++) {
+                for (int j = i; j > 1 && types[j - 1] == types[j] && colors[j - 1] == colors[j] &&
+                                transformed[j - 1] > transformed[j]; j--) {
+                    std::swap(transformed[j - 1], transformed[j]);
+                }
+            }
+
+            best = std::min(best, GetRawIndex(transformed, turnOf));
+        }
+        return best;
+    }
+
+    bool TableIndex::GetPosition(uint64_t index, uint8_t* squares, Color& turnOf) const {
+        uint64_t remaining = index;
+        for (size_t i = types.size() - 1; i >= 1; i--) {
+            if (types[i] == PieceType::Pawn) {
+                squares[i] = (uint8_t) (remaining % 48 + 8);
+                remaining /= 48;
+            } else {
+                squares[i] = (uint8_t) (remaining % 64);
+                remaining /= 64;
+            }
+        }
+
+        int kingSquares = hasPawns ? pawnKingSquares : pawnlessKingSquares;
+        squares[0] = GetKingSquare((int) (remaining % kingSquares), hasPawns);
+        turnOf = (Color) (remaining / kingSquares);
+
+        Bitboard occupied = BITBOARD_EMPTY;
+        for (size_t i = 0; i < types.size(); i++) {
+            if (GetBit(occupied, squares[i]))
+                return false;
+            occupied = SetBit(occupied, squares[i]);
+        }
+
+        return GetIndex(squares, turnOf) == index;
+    }
+
+    /*******************************************************/
+    /* Entries                                             */
+    /*******************************************************/
+
+    uint8_t EncodeEntry(const ProbeResult& result) {
+        if (result.outcome == Outcome::Draw)
+            return drawEntry;
+        return (uint8_t) (result.distance + 1);
+    }
+
+    ProbeResult DecodeEntry(uint8_t entry) {
+        if (entry == drawEntry)
+            return {};
+
+        int distance = entry - 1;
+        return {(distance % 2 == 1) ? Outcome::Win : Outcome::Loss, distance};
+    }
+
+    std::string GetTablePath(const std::string& directory, const Signature& signature) {
+        return (std::filesystem::path(directory) / (SignatureToString(signature) + fileExtension)).string();
+    }
+
+    bool SaveTable(const std::string& path, const Signature& signature, const std::vector<uint8_t>& entries) {
+        if (entries.size() != TableIndex(signature).GetSize())
+            return false;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        char header[headerSize] = {};
+        std::string name = SignatureToString(signature);
+        uint64_t entryCount = entries.size();
+        std::memcpy(header, fileMagic, sizeof(fileMagic));
+        std::memcpy(header + 8, &fileVersion, sizeof(fileVersion));
+        std::memcpy(header + 16, name.c_str(), std::min(name.size(), nameSize - 1));
+        std::memcpy(header + 32, &entryCount, sizeof(entryCount));
+
+        file.write(header, headerSize);
+        file.write((const char*) entries.data(), (std::streamsize) entries.size());
+        return (bool) file;
+    }
+
+    /*******************************************************/
+    /* Probing                                             */
+    /*******************************************************/
+
+    struct Table {
+        TableIndex index;
+        Memory::Mapping mapping;
+        const uint8_t* entries;
+
+        Table(const Signature& signature, const Memory::Mapping& mapping)
+            : index(signature), mapping(mapping), entries((const uint8_t*) mapping.address + headerSize) {}
+    };
+
+    /* A table and whether the position's colors are swapped to match it. */
+    struct TableReference {
+        const Table* table;
+        bool flipped;
+    };
+
+    static std::vector<std::unique_ptr<Table>> tables;
+    static std::unordered_map<uint64_t, TableReference> tablesByMaterial;
+    static int pieceLimit = 0;
+
+    static bool LoadTable(const std::string& path) {
+        Memory::Mapping mapping;
+        if (!Memory::MapReadOnly(path, mapping))
+            return false;
+
+        auto header = (const char*) mapping.address;
+        Signature signature;
+        uint32_t version = 0;
+        uint64_t entryCount = 0;
+        if (mapping.size >= headerSize) {
+            std::memcpy(&version, header + 8, sizeof(version));
+            std::memcpy(&entryCount, header + 32, sizeof(entryCount));
+        }
+
+        if (mapping.size < headerSize || std::memcmp(header, fileMagic, sizeof(fileMagic)) != 0 || version != fileVersion ||
+            !ParseSignature(std::string(header + 16, strnlen(header + 16, nameSize)), signature) ||
+            entryCount != TableIndex(signature).GetSize() || mapping.size != headerSize + entryCount) {
+            Memory::Unmap(mapping);
+            return false;
+        }
+
+        // A second file of the same material replaces the first. With the same pieces on both
+        // sides (KPvKP) the keys are equal and the unflipped reference stays.
+        auto& table = tables.emplace_back(std::make_unique<Table>(signature, mapping));
+        tablesByMaterial[GetSignatureKey(signature, Color::Black)] = {table.get(), true};
+        tablesByMaterial[GetSignatureKey(signature, Color::White)] = {table.get(), false};
+        pieceLimit = std::max(pieceLimit, table->index.GetPieceCount());
+        return true;
+    }
+
+    int LoadTables(const std::string& directory) {
+        std::error_code error;
+        int count = 0;
+        for (auto& entry : std::filesystem::directory_iterator(directory, error)) {
+            if (entry.path().extension() == fileExtension && LoadTable(entry.path().string()))
+                count++;
+        }
+        return count;
+    }
+
+    void UnloadTables() {
+        tablesByMaterial.clear();
+        for (auto& table : tables)
+            Memory::Unmap(table->mapping);
+        tables.clear();
+        pieceLimit = 0;
+    }
+
+    int GetPieceLimit() {
+        return pieceLimit;
+    }
+
+    bool Probe(const BoardState& state, ProbeResult& result) {
+        if (pieceLimit == 0)
+            return false;
+
+        Bitboard occupied = BITBOARD_EMPTY;
+        for (auto& colorBoards : state.pieceBoards)
+            for (Bitboard board : colorBoards)
+                occupied |= board;
+        if (GetBitCount(occupied) > pieceLimit)
+            return false;
+
+        if (state.enPassantBoard != BITBOARD_EMPTY ||
+            state.kingSideCastling[Color::White] || state.queenSideCastling[Color::White] ||
+            state.kingSideCastling[Color::Black] || state.queenSideCastling[Color::Black])
+            return false;
+
+        auto found = tablesByMaterial.find(state.materialKey);
+        if (found == tablesByMaterial.end())
+            return false;
+
+        // With the colors swapped the board is mirrored so the pawns keep their direction.
+        auto [table, flipped] = found->second;
+        const TableIndex& index = table->index;
+        uint8_t flip = flipped ? 56 : 0;
+
+        Bitboard pieces[2][6];
+        std::memcpy(pieces, state.pieceBoards, sizeof(pieces));
+
+        uint8_t squares[maxPieces];
+        for (int i = 0; i < index.GetPieceCount(); i++) {
+            Color color = flipped ? InvertColor(index.GetColor(i)) : index.GetColor(i);
+            Bitboard& board = pieces[color][index.GetType(i)];
+            uint8_t square = GetLSBIndex(board);
+            board &= board - 1;
+            squares[i] = square ^ flip;
+        }
+
+        Color turnOf = flipped ? InvertColor(state.turnOf) : state.turnOf;
+        result = DecodeEntry(table->entries[index.GetIndex(squares, turnOf)]);
+        return true;
+    }
+
+}
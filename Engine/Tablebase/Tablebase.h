@@ -0,0 +1,109 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Board/BoardState.h"
+
+namespace ChessEngine::Tablebase {
+
+    /* Endgame tablebases with the distance to mate of every position of a material signature
+     * (KRvK , KQvKR , KPvKP ...) up to maxPieces pieces. The tables are built offline by the
+     * Tablebases tool and memory mapped uncompressed , a probe is a single byte read. */
+
+    constexpr int maxPieces = 4;
+
+    /*******************************************************/
+    /* Signatures and indexing                             */
+    /*******************************************************/
+
+    /* The pieces of a table , the first side is White in the table's positions. Each side starts
+     * with its king followed by the rest ordered queens , rooks , bishops , knights , pawns. */
+    struct Signature {
+        std::vector<PieceType> pieces[2];
+    };
+
+    /* Names like "KRvK" , false when the name isn't a valid signature of up to maxPieces pieces. */
+    bool ParseSignature(const std::string& name, Signature& signature);
+    std::string SignatureToString(const Signature& signature);
+
+    /* The material key (see Evaluation::GetMaterialKey) of the positions , with the first side as color. */
+    uint64_t GetSignatureKey(const Signature& signature, Color firstSide);
+
+    /* Orders the positions of a signature. The first king is moved by the board symmetries to the
+     * a1-d1-d4 triangle (to files A to D with pawns , only the mirror keeps pawns moving forward) ,
+     * the other pieces take 64 squares each and pawns 48. Of the positions the symmetries or the
+     * order of identical pieces make equal only the one with the lowest index is stored. */
+    class TableIndex {
+    public:
+        explicit TableIndex(const Signature& signature);
+
+        uint64_t GetSize() const { return size; }
+        int GetPieceCount() const { return (int) types.size(); }
+        PieceType GetType(int piece) const { return types[piece]; }
+        Color GetColor(int piece) const { return colors[piece]; }
+
+        /* squares in the signature's order , the first side as White. */
+        uint64_t GetIndex(const uint8_t* squares, Color turnOf) const;
+
+        /* False for overlapping pieces and the indices that aren't the lowest of their position. */
+        bool GetPosition(uint64_t index, uint8_t* squares, Color& turnOf) const;
+
+    private:
+        uint64_t GetRawIndex(const uint8_t* squares, Color turnOf) const;
+
+        std::vector<PieceType> types;
+        std::vector<Color> colors;
+        bool hasPawns = false;
+        uint64_t size = 0;
+    };
+
+    /*******************************************************/
+    /* Entries                                             */
+    /*******************************************************/
+
+    enum class Outcome {
+        Loss, Draw, Win
+    };
+
+    /* From the side to move's point of view. */
+    struct ProbeResult {
+        Outcome outcome = Outcome::Draw;
+        int distance = 0; // Plies to mate with best play , 0 for draws.
+    };
+
+    /* One byte per position : 0 for a draw (and for illegal positions) , otherwise 1 + the plies
+     * to mate. The side to move wins in an odd number of plies and loses in an even one. */
+    constexpr uint8_t drawEntry = 0;
+    constexpr int maxDistance = 254;
+
+    uint8_t EncodeEntry(const ProbeResult& result);
+    ProbeResult DecodeEntry(uint8_t entry);
+
+    /* File name of a signature's table in directory. */
+    std::string GetTablePath(const std::string& directory, const Signature& signature);
+
+    /* entries in TableIndex order. The file is a 64 byte header (the magic "CETABLE" , a version ,
+     * the signature name and the entry count) followed by the entries. */
+    bool SaveTable(const std::string& path, const Signature& signature, const std::vector<uint8_t>& entries);
+
+    /*******************************************************/
+    /* Probing                                             */
+    /*******************************************************/
+
+    /* Map every table in directory , returns how many. Not while a search runs. */
+    int LoadTables(const std::string& directory);
+    void UnloadTables();
+
+    /* Most pieces of a loaded table , 0 without tables. */
+    int GetPieceLimit();
+
+    /* False when no loaded table has the position's material , or with castling or en passant
+     * rights (the tables have neither). The fifty move rule is ignored. */
+    bool Probe(const BoardState& state, ProbeResult& result);
+
+}
+
+#endif
@@ -0,0 +1,440 @@
+#include "Memory.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#endif
+
+namespace ChessEngine::Memory {
+
+    constexpr size_t hugePageSize = 2 * 1024 * 1024;
+
+    static MemoryOptions memoryOptions;
+
+    void SetOptions(const MemoryOptions& options) {
+        memoryOptions = options;
+    }
+
+    const MemoryOptions& GetOptions() {
+        return memoryOptions;
+    }
+
+    std::string PageSizeToString(PageSize pages) {
+        switch (pages) {
+            case PageSize::Huge:
+                return "huge";
+            case PageSize::TransparentHuge:
+                return "transparent huge";
+            default:
+                return "normal";
+        }
+    }
+
+    static int GetCpuCount() {
+        return (int) std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    void FirstTouch(void* address, size_t size) {
+        int threads = GetCpuCount();
+        size_t slice = (size + threads - 1) / threads;
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threads; i++) {
+            size_t start = std::min(size, slice * i);
+            size_t end = std::min(size, start + slice);
+            workers.emplace_back([=]() {
+                PinThread(i);
+                std::memset((char*) address + start, 0, end - start);
+            });
+        }
+
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+#ifdef _WIN32
+
+    bool MapFile(const std::string& path, size_t size, Mapping& mapping, bool& existed) {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                  OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER fileSize;
+        existed = GetFileSizeEx(file, &fileSize) && (size_t) fileSize.QuadPart == size;
+
+        LARGE_INTEGER newSize;
+        newSize.QuadPart = (LONGLONG) size;
+        if (!existed && (!SetFilePointerEx(file, newSize, nullptr, FILE_BEGIN) || !SetEndOfFile(file))) {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, newSize.HighPart, newSize.LowPart, nullptr);
+        CloseHandle(file);
+        if (!fileMapping)
+            return false;
+
+        // The view keeps the mapping alive.
+        void* address = MapViewOfFile(fileMapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        CloseHandle(fileMapping);
+        if (!address)
+            return false;
+
+        mapping = {address, size};
+        return true;
+    }
+
+    bool MapReadOnly(const std::string& path, Mapping& mapping) {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!fileMapping)
+            return false;
+
+        void* address = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(fileMapping);
+        if (!address)
+            return false;
+
+        mapping = {address, (size_t) fileSize.QuadPart};
+        return true;
+    }
+
+    bool MapShared(const std::string& name, size_t size, Mapping& mapping, bool& created) {
+        // Named mappings of the session , backed by the paging file.
+        std::string sharedName = "Local\\" + (name.rfind('/', 0) == 0 ? name.substr(1) : name);
+        ULARGE_INTEGER mappingSize;
+        mappingSize.QuadPart = size;
+        HANDLE fileMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, mappingSize.HighPart,
+                                                mappingSize.LowPart, sharedName.c_str());
+        if (!fileMapping)
+            return false;
+        created = GetLastError() != ERROR_ALREADY_EXISTS;
+
+        // The view keeps the mapping alive.
+        void* address = MapViewOfFile(fileMapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        CloseHandle(fileMapping);
+        if (!address)
+            return false;
+
+        // NOTE: The size of an existing mapping is only known rounded up to a page.
+        if (!created) {
+            MEMORY_BASIC_INFORMATION info = {};
+            size = VirtualQuery(address, &info, sizeof(info)) ? info.RegionSize : 0;
+        }
+
+        mapping = {address, size};
+        return true;
+    }
+
+    bool RemoveShared(const std::string& name) {
+        return true;
+    }
+
+    uint64_t GetProcessId() {
+        return GetCurrentProcessId();
+    }
+
+    bool IsProcessAlive(uint64_t processId) {
+        HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, (DWORD) processId);
+        if (!process)
+            return GetLastError() == ERROR_ACCESS_DENIED; // Exists , but belongs to someone else.
+
+        DWORD exitCode = 0;
+        bool alive = GetExitCodeProcess(process, &exitCode) && exitCode == STILL_ACTIVE;
+        CloseHandle(process);
+        return alive;
+    }
+
+    bool Allocate(size_t size, bool hugePages, Mapping& mapping) {
+        // NOTE: Large pages need the "lock pages in memory" privilege , without it normal pages are used.
+        size_t largePageSize = GetLargePageMinimum();
+        if (hugePages && largePageSize != 0) {
+            size_t largeSize = (size + largePageSize - 1) / largePageSize * largePageSize;
+            void* address = VirtualAlloc(nullptr, largeSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (address) {
+                mapping = {address, largeSize, true, PageSize::Huge};
+                return true;
+            }
+        }
+
+        void* address = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (!address)
+            return false;
+
+        mapping = {address, size, true, PageSize::Normal};
+        return true;
+    }
+
+    bool FlushMapping(const Mapping& mapping) {
+        return mapping.address && !mapping.anonymous && FlushViewOfFile(mapping.address, mapping.size);
+    }
+
+    void Unmap(Mapping& mapping) {
+        if (mapping.address && mapping.anonymous)
+            VirtualFree(mapping.address, 0, MEM_RELEASE);
+        else if (mapping.address)
+            UnmapViewOfFile(mapping.address);
+        mapping = {};
+    }
+
+    size_t GetHugePageBytes(const Mapping& mapping) {
+        return mapping.pages == PageSize::Huge ? mapping.size : 0;
+    }
+
+    int GetNumaNodeCount() {
+        ULONG highestNode = 0;
+        return GetNumaHighestNodeNumber(&highestNode) ? (int) highestNode + 1 : 1;
+    }
+
+    bool PinThread(int index) {
+        int cpu = index % std::min(GetCpuCount(), 64); // A single processor group.
+        return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) 1 << cpu) != 0;
+    }
+
+#else
+
+    bool MapFile(const std::string& path, size_t size, Mapping& mapping, bool& existed) {
+        int file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (file < 0)
+            return false;
+
+        struct stat fileStat = {};
+        existed = fstat(file, &fileStat) == 0 && (size_t) fileStat.st_size == size;
+        if (!existed && ftruncate(file, (off_t) size) != 0) {
+            close(file);
+            return false;
+        }
+
+        // The mapping stays valid after the descriptor is closed.
+        void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+        close(file);
+        if (address == MAP_FAILED)
+            return false;
+
+        mapping = {address, size};
+        return true;
+    }
+
+    bool MapReadOnly(const std::string& path, Mapping& mapping) {
+        int file = open(path.c_str(), O_RDONLY);
+        if (file < 0)
+            return false;
+
+        struct stat fileStat = {};
+        if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0) {
+            close(file);
+            return false;
+        }
+
+        int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+        flags |= MAP_POPULATE;
+#endif
+        auto size = (size_t) fileStat.st_size;
+        void* address = mmap(nullptr, size, PROT_READ, flags, file, 0);
+        close(file);
+        if (address == MAP_FAILED)
+            return false;
+
+        mapping = {address, size};
+        return true;
+    }
+
+    static std::string GetSharedName(const std::string& name) {
+        return name.rfind('/', 0) == 0 ? name : "/" + name;
+    }
+
+    bool MapShared(const std::string& name, size_t size, Mapping& mapping, bool& created) {
+        std::string sharedName = GetSharedName(name);
+
+        // Exclusive create tells the process that sizes the segment apart from the ones opening it.
+        created = true;
+        int file = shm_open(sharedName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (file < 0 && errno == EEXIST) {
+            created = false;
+            file = shm_open(sharedName.c_str(), O_RDWR, 0);
+        }
+        if (file < 0)
+            return false;
+
+        if (created && ftruncate(file, (off_t) size) != 0) {
+            close(file);
+            shm_unlink(sharedName.c_str());
+            return false;
+        }
+
+        if (!created) {
+            struct stat fileStat = {};
+            if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0) {
+                close(file);
+                return false;
+            }
+            size = (size_t) fileStat.st_size;
+        }
+
+        // The mapping stays valid after the descriptor is closed.
+        void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+        close(file);
+        if (address == MAP_FAILED) {
+            if (created)
+                shm_unlink(sharedName.c_str());
+            return false;
+        }
+
+        mapping = {address, size};
+        return true;
+    }
+
+    bool RemoveShared(const std::string& name) {
+        return shm_unlink(GetSharedName(name).c_str()) == 0;
+    }
+
+    uint64_t GetProcessId() {
+        return (uint64_t) getpid();
+    }
+
+    bool IsProcessAlive(uint64_t processId) {
+        // Signal 0 only checks , EPERM means it exists but belongs to someone else.
+        return kill((pid_t) processId, 0) == 0 || errno == EPERM;
+    }
+
+    bool Allocate(size_t size, bool hugePages, Mapping& mapping) {
+        size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+
+        if (hugePages) {
+            size_t hugeSize = (size + hugePageSize - 1) / hugePageSize * hugePageSize;
+
+#ifdef MAP_HUGETLB
+            // Only works when pages were reserved (vm.nr_hugepages).
+            void* address = mmap(nullptr, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (address != MAP_FAILED) {
+                mapping = {address, hugeSize, true, PageSize::Huge};
+                return true;
+            }
+#endif
+
+#ifdef MADV_HUGEPAGE
+            // Over allocate so the start can be aligned to a huge page , the kernel only
+            // backs whole aligned 2 MB ranges with huge pages.
+            size_t reserved = hugeSize + hugePageSize;
+            void* reservation = mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (reservation != MAP_FAILED) {
+                auto start = (uintptr_t) reservation;
+                auto alignedStart = (start + hugePageSize - 1) / hugePageSize * hugePageSize;
+                if (alignedStart > start)
+                    munmap(reservation, alignedStart - start);
+                if (alignedStart + hugeSize < start + reserved)
+                    munmap((void*) (alignedStart + hugeSize), start + reserved - alignedStart - hugeSize);
+
+                auto address = (void*) alignedStart;
+                bool advised = madvise(address, hugeSize, MADV_HUGEPAGE) == 0;
+                mapping = {address, hugeSize, true, advised ? PageSize::TransparentHuge : PageSize::Normal};
+                return true;
+            }
+#endif
+        }
+
+        size = (size + pageSize - 1) / pageSize * pageSize;
+        void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (address == MAP_FAILED)
+            return false;
+
+        mapping = {address, size, true, PageSize::Normal};
+        return true;
+    }
+
+    bool FlushMapping(const Mapping& mapping) {
+        return mapping.address && !mapping.anonymous && msync(mapping.address, mapping.size, MS_SYNC) == 0;
+    }
+
+    void Unmap(Mapping& mapping) {
+        if (mapping.address)
+            munmap(mapping.address, mapping.size);
+        mapping = {};
+    }
+
+    size_t GetHugePageBytes(const Mapping& mapping) {
+        if (mapping.pages == PageSize::Huge)
+            return mapping.size;
+        if (mapping.pages != PageSize::TransparentHuge)
+            return 0;
+
+        // Sum AnonHugePages of the regions inside the mapping , regions start with an "address-address" line.
+        std::ifstream smaps("/proc/self/smaps");
+        auto begin = (uintptr_t) mapping.address;
+        auto end = begin + mapping.size;
+
+        size_t bytes = 0;
+        bool inside = false;
+        std::string line;
+        while (std::getline(smaps, line)) {
+            size_t dash = line.find('-');
+            size_t space = line.find(' ');
+            if (dash != std::string::npos && space != std::string::npos && dash < space && line.find(':') > space) {
+                uintptr_t regionStart = std::stoull(line.substr(0, dash), nullptr, 16);
+                inside = regionStart >= begin && regionStart < end;
+            } else if (inside && line.rfind("AnonHugePages:", 0) == 0) {
+                std::istringstream stream(line.substr(14));
+                size_t kilobytes = 0;
+                stream >> kilobytes;
+                bytes += kilobytes * 1024;
+            }
+        }
+
+        return bytes;
+    }
+
+    int GetNumaNodeCount() {
+        std::error_code error;
+        int nodes = 0;
+        for (auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", error)) {
+            std::string name = entry.path().filename().string();
+            if (name.rfind("node", 0) == 0 && name.size() > 4 && std::isdigit((unsigned char) name[4]))
+                nodes++;
+        }
+        return std::max(nodes, 1);
+    }
+
+    bool PinThread(int index) {
+#ifdef __linux__
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(index % GetCpuCount(), &cpus);
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+#else
+        return false;
+#endif
+    }
+
+#endif
+
+}
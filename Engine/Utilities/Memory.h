@@ -0,0 +1,88 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ChessEngine::Memory {
+
+    /* Switches for the large engine tables (sliding moves , transposition tables) and the worker threads.
+     * Tables allocated before a change keep what they got. */
+    struct MemoryOptions {
+        bool hugePages = true; // 2 MB pages , fewer TLB misses on random probes.
+
+        // Clear tables from threads spread over every cpu , with first touch placement the pages
+        // end up spread over the NUMA nodes instead of all on the node of the clearing thread.
+        bool numaFirstTouch = false;
+
+        bool pinThreads = false; // Pin search workers to a cpu each.
+    };
+
+    void SetOptions(const MemoryOptions& options); // Before Init so the move tables follow them.
+    const MemoryOptions& GetOptions();
+
+    enum class PageSize {
+        Normal, // 4 KB pages.
+        Huge, // Reserved 2 MB pages (MAP_HUGETLB).
+        TransparentHuge // Requested from the kernel (MADV_HUGEPAGE) , see GetHugePageBytes for how many it gave.
+    };
+
+    std::string PageSizeToString(PageSize pages);
+
+    struct Mapping {
+        void* address = nullptr;
+        size_t size = 0;
+
+        bool anonymous = false; // Not backed by a file.
+        PageSize pages = PageSize::Normal;
+    };
+
+    /* Map a file into memory , writes to the mapping reach the file. The file is created
+     * if missing and resized to size bytes. existed is true when the file was already
+     * of that size (its contents are kept). */
+    bool MapFile(const std::string& path, size_t size, Mapping& mapping, bool& existed);
+
+    /* Map an existing file read only , the mapping is the size of the file. The pages are read
+     * in up front where the system can (MAP_POPULATE) so later reads don't wait for the disk. */
+    bool MapReadOnly(const std::string& path, Mapping& mapping);
+
+    /* Create or open the shared memory segment name (shm_open , a named mapping on Windows) so the
+     * processes of the machine map the same memory. A new segment is size zeroed bytes and created is
+     * true , an existing one is mapped at its own size. Fails on an empty segment (its creator
+     * hasn't sized it yet). POSIX names start with a '/' , one is added when missing. */
+    bool MapShared(const std::string& name, size_t size, Mapping& mapping, bool& created);
+
+    /* Remove the name of a shared segment , processes that mapped it keep their mapping. Nothing to
+     * do on Windows , the segment goes away with its last mapping. */
+    bool RemoveShared(const std::string& name);
+
+    uint64_t GetProcessId();
+    /* False once the process exited. Processes of another pid namespace can't be told apart. */
+    bool IsProcessAlive(uint64_t processId);
+
+    /* Zeroed memory aligned to a page. With hugePages reserved 2 MB pages are tried
+     * first , then transparent huge pages , then normal pages. The size is rounded up
+     * to the page size. */
+    bool Allocate(size_t size, bool hugePages, Mapping& mapping);
+
+    /* Write the dirty pages of a mapping back to its file. */
+    bool FlushMapping(const Mapping& mapping);
+
+    void Unmap(Mapping& mapping);
+
+    /* Bytes of a mapping currently backed by huge pages , 0 where it can't be known. */
+    size_t GetHugePageBytes(const Mapping& mapping);
+
+    /* Zero memory from one thread per cpu , each thread pinned to its cpu and
+     * zeroing its own slice so the first touch places the pages near it. */
+    void FirstTouch(void* address, size_t size);
+
+    int GetNumaNodeCount(); // 1 where it can't be known.
+
+    /* Pin the calling thread to cpu index (modulo the cpu count). */
+    bool PinThread(int index);
+
+}
+
+#endif
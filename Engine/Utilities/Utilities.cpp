@@ -3,6 +3,10 @@
 
 #include "../MoveGeneration/SlidingPieces.h"
 #include "../MoveGeneration/MoveTables.h"
+#include "../Hashing/Zobrist.h"
+#include "../Evaluation/Material.h"
+#include "../Evaluation/PieceSquare.h"
+#include "../Evaluation/Bitbase.h"
 
 namespace ChessEngine {
 
@@ -101,6 +105,10 @@ namespace ChessEngine {
     void Init() {
         MoveGeneration::SlidingPieces::InitBlockerMasks();
         MoveGeneration::MoveTables::InitMoveTables();
+        Zobrist::InitZobristKeys();
+        Evaluation::InitMaterialTable();
+        Evaluation::InitPieceSquareTables();
+        Evaluation::InitKPKBitbase();
     }
 
 }
\ No newline at end of file
@@ -1,9 +1,15 @@
 #include "Game.h"
 
+#include <iostream>
+#include <chrono>
+
 #include <SFML/Window/Event.hpp>
 
 #include <Engine/MoveGeneration/MoveGeneration.h>
 #include <Engine/MoveGeneration/Draw.h>
+#include <Engine/Search/Search.h>
+#include <Engine/Evaluation/Nnue.h>
+#include <Engine/Tablebase/Tablebase.h>
 
 #include "./RenderingUtil.h"
 #include "ResourceManager.h"
@@ -12,12 +18,33 @@
 
 namespace ChessFrontend {
 
+        constexpr size_t transpositionTableMB = 64;
+        // When set the table lives in this file and the next game picks up its entries , empty keeps it in memory.
+        constexpr const char* transpositionTableFile = "";
+        // When set the table is shared with the other engine processes of the machine through this
+        // shared memory segment (eg: "/chess-engine-table") , empty keeps it to this process.
+        constexpr const char* sharedTableName = "";
+        constexpr int monteCarloThreads = 2;
+        // A network file (see Tools/Bench --network) replaces the hand written evaluation , empty keeps it.
+        constexpr const char* networkFile = "";
+        // Directory of endgame tablebases (see Tools/Tablebases) the AI probes , empty for none.
+        constexpr const char* tablebaseDirectory = "";
+        // An opening book (see Tools/Book) the AI plays from without searching , empty for none.
+        constexpr const char* bookFile = "";
+        constexpr bool bookRandom = true; // Weighted random book moves , otherwise always the heaviest.
+        constexpr double bookExponent = 1.0; // Above 1 favors the heavy moves more , 0 picks uniformly.
+        constexpr int bookMaxPly = 30;
+        // In builds with ENGINE_SEARCH_TRACE the alpha beta searches are appended to "<file>.0" (see Tools/Trace) , empty for none.
+        constexpr const char* searchTraceFile = "";
+
         Game::Game(ChessEngine::BoardState state, const Options& options)
                 : window(sf::VideoMode(
                          options.windowSettings.width,
                          options.windowSettings.height),
                          options.windowSettings.title, sf::Style::None),
                          board(state), options(options),
+                         transpositionTable(transpositionTableMB),
+                         backgroundSearch(transpositionTable),
                          humanState(options.startingView)
         {
             playMoveAnimation = false;
@@ -26,6 +53,31 @@ namespace ChessFrontend {
 
             elapsedAnimTime = 0.0f;
 
+            clocks[ChessEngine::Color::White] = options.clockTime;
+            clocks[ChessEngine::Color::Black] = options.clockTime;
+            turnStarted = false;
+
+            ponderMove.flags = ChessEngine::MoveGeneration::MoveType::None;
+
+            bool reattached = false;
+            if (*transpositionTableFile && !transpositionTable.MapFile(transpositionTableFile, transpositionTableMB, reattached))
+                std::cout << "Could not map the transposition table to " << transpositionTableFile << std::endl;
+            if (*sharedTableName && !transpositionTable.AttachShared(sharedTableName, transpositionTableMB, reattached))
+                std::cout << "Could not attach the shared transposition table " << sharedTableName << std::endl;
+
+            if (*networkFile && !ChessEngine::Evaluation::Nnue::LoadNetwork(networkFile))
+                std::cout << "Could not load the network " << networkFile << std::endl;
+
+            if (*tablebaseDirectory && ChessEngine::Tablebase::LoadTables(tablebaseDirectory) == 0)
+                std::cout << "No tablebases in " << tablebaseDirectory << std::endl;
+
+            if (*bookFile && !ChessEngine::Book::LoadBook(bookFile))
+                std::cout << "Could not load the book " << bookFile << std::endl;
+            bookOptions.random = bookRandom;
+            bookOptions.exponent = bookExponent;
+            bookOptions.maxPly = bookMaxPly;
+            bookSeed = (uint64_t) std::chrono::steady_clock::now().time_since_epoch().count() | 1; // Xorshift needs a non zero seed.
+
             window.setFramerateLimit(options.windowSettings.frameLimit);
         }
 
@@ -152,33 +204,159 @@ namespace ChessFrontend {
             if(playMoveAnimation)
                 return;
 
+            // The clock only runs once the previous move animation is over.
+            if(!turnStarted){
+                turnClock.restart();
+                turnStarted = true;
+            }
+
             bool isAI = (board.GetState().turnOf == ChessEngine::Color::White) ? options.whiteAI : options.blackAI;
             boardHasChanged = (isAI) ? AiTurn() : HumanTurn();
+
+            UpdateClock(boardHasChanged);
+        }
+
+        void Game::UpdateClock(bool moved){
+            // After a move the turn has already passed to the opponent.
+            auto& state = board.GetState();
+            ChessEngine::Color color = moved ? ChessEngine::InvertColor(state.turnOf) : state.turnOf;
+            float remaining = clocks[color] - turnClock.getElapsedTime().asSeconds();
+
+            if(remaining < 0.0f){
+                if(state.gameState == ChessEngine::GameState::Playing)
+                    state.gameState = ChessEngine::GameState::Forfiet; // Lost on time.
+                return;
+            }
+
+            if(moved){
+                clocks[color] = remaining + options.clockIncrement;
+                turnStarted = false;
+            }
         }
 
         bool Game::AiTurn(){
             using namespace ChessEngine::MoveGeneration;
 
-            auto moves = GetValidMoves(board.GetState(), board.GetState().turnOf, board.GetOccupancies());
-
-            Move mv;
-            int rng = rand() % moves.size();
-            int i = 0;
-            for(auto m : moves){
-                if(i == rng){
-                    mv = m;
-                    break;
+            ChessEngine::Search::SearchResult result;
+            if(ChessEngine::Book::GetBookMove(board, bookOptions, bookSeed, result.bestMove)){
+                // Book moves are played right away , a search already running (or pondering) is dropped.
+                backgroundSearch.Stop();
+                result.hasMove = true;
+            }else{
+                // Start searching if the background search isn't on this position (eg: first move or a ponder miss).
+                float elapsed = turnClock.getElapsedTime().asSeconds();
+                if(!backgroundSearch.IsRunning() || backgroundSearch.GetPositionKey() != board.GetState().hashKey){
+                    StartSearch(board, history, false, elapsed);
+                }else if(backgroundSearch.IsPondering()){
+                    backgroundSearch.PonderHit(GetTimeControl(board.GetState().turnOf, elapsed));
                 }
 
-                i++;
+                // Keep rendering until the search is done.
+                if(!backgroundSearch.IsFinished())
+                    return false;
+
+                result = backgroundSearch.Wait();
+                if(!result.hasMove)
+                    return false;
             }
 
+            Move mv = result.bestMove;
+            history.Push(board.GetState().hashKey);
             MakeMove(mv, board.GetState().turnOf, board.GetState(), board.GetOccupancies());
 
             humanState.selectedMove = mv;
             playMoveAnimation = true;
 
-            return true; // Plays move instantly.
+            CheckGameOver();
+            StartNextSearch(result);
+
+            return true;
+        }
+
+        bool Game::IsAI(ChessEngine::Color color) const{
+            return (color == ChessEngine::Color::White) ? options.whiteAI : options.blackAI;
+        }
+
+        ChessEngine::Search::TimeControl Game::GetTimeControl(ChessEngine::Color color, float elapsed){
+            // Elapsed is the time already spent on the turn.
+            float remaining = clocks[color] - elapsed;
+
+            ChessEngine::Search::TimeControl time;
+            time.remainingMs = std::max<int64_t>((int64_t) (remaining * 1000.0f), 1); // 0 would mean untimed.
+            time.incrementMs = (int64_t) (options.clockIncrement * 1000.0f);
+            return time;
+        }
+
+        void Game::StartSearch(const ChessEngine::Board& position, const ChessEngine::KeyHistory& positionHistory, bool ponder, float elapsed){
+            ChessEngine::Search::SearchLimits limits;
+            limits.history = positionHistory;
+            limits.traceFile = searchTraceFile;
+            if(!ponder)
+                limits.time = GetTimeControl(position.GetState().turnOf, elapsed);
+
+            AIType type = (position.GetState().turnOf == ChessEngine::Color::White) ? options.whiteAIType : options.blackAIType;
+            if(type == AIType::MonteCarlo){
+                ChessEngine::Search::MonteCarloOptions monteCarloOptions;
+                monteCarloOptions.threads = monteCarloThreads;
+                backgroundSearch.Start(position, limits, monteCarloOptions, ponder);
+            }else{
+                backgroundSearch.Start(position, limits, ChessEngine::Search::PruningOptions(), ponder);
+            }
+        }
+
+        void Game::StartNextSearch(const ChessEngine::Search::SearchResult& result){
+            using namespace ChessEngine::MoveGeneration;
+
+            if(board.GetState().gameState != ChessEngine::GameState::Playing)
+                return;
+
+            // If the next side is an AI too it can start right away , while the move animation plays.
+            // The turn of the next side hasn't started yet so no time is spent.
+            if(IsAI(board.GetState().turnOf)){
+                StartSearch(board, history, false, 0.0f);
+                return;
+            }
+
+            // Otherwise ponder on the reply the search expects.
+            if(result.pv.size() >= 2){
+                ponderMove = result.pv[1];
+
+                ChessEngine::Board ponderBoard = board;
+                ChessEngine::KeyHistory ponderHistory = history;
+                ponderHistory.Push(board.GetState().hashKey);
+                MakeMove(ponderMove, ponderBoard.GetState().turnOf, ponderBoard.GetState(), ponderBoard.GetOccupancies());
+                StartSearch(ponderBoard, ponderHistory, true, 0.0f);
+            }
+        }
+
+        void Game::OnHumanMove(){
+            using namespace ChessEngine::MoveGeneration;
+
+            if(board.GetState().gameState != ChessEngine::GameState::Playing || !IsAI(board.GetState().turnOf)){
+                backgroundSearch.Stop();
+                return;
+            }
+
+            // Ponder hit , the search so far is kept and only the clock starts.
+            // The animation of the human move is also search time for the AI.
+            if(backgroundSearch.IsPondering() && PackMove(humanState.selectedMove) == PackMove(ponderMove)){
+                backgroundSearch.PonderHit(GetTimeControl(board.GetState().turnOf, 0.0f));
+            }else{
+                StartSearch(board, history, false, 0.0f); // Ponder miss , discards the old search.
+            }
+        }
+
+        void Game::CheckGameOver(){
+            using namespace ChessEngine::MoveGeneration;
+
+            // TODO: maybbe too slow.
+            auto moves = GetValidMoves(board.GetState(), board.GetState().turnOf, board.GetOccupancies());
+            if(Draw::IsDraw(board, moves, history)){
+                board.GetState().gameState = ChessEngine::GameState::Draw;
+            }
+            if(Draw::IsCheckmate(board, moves)){
+                board.GetState().gameState = ChessEngine::GameState::Win;
+            }
         }
 
         bool Game::HumanTurn(){
@@ -204,6 +382,7 @@ namespace ChessFrontend {
             }
 
             if(shouldMove){
+                history.Push(board.GetState().hashKey);
                 MakeMove(humanState.selectedMove, board.GetState().turnOf, board.GetState(), board.GetOccupancies());
                 playMoveAnimation = shouldMoveAnimation;
 
@@ -211,14 +390,8 @@ namespace ChessFrontend {
                 if(!shouldMoveAnimation)
                     SwapSides();
 
-                // TODO: maybbe too slow.
-                auto moves = GetValidMoves(board.GetState(), board.GetState().turnOf, board.GetOccupancies());
-                if(Draw::IsDraw(board, moves)){
-                    board.GetState().gameState = ChessEngine::GameState::Draw;
-                }
-                if(Draw::IsCheckmate(board, moves)){
-                    board.GetState().gameState = ChessEngine::GameState::Win;
-                }
+                CheckGameOver();
+                OnHumanMove();
 
                 return true;
             }else{
@@ -3,9 +3,14 @@
 
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <Engine/Board/Board.h>
+#include <Engine/Board/KeyHistory.h>
 #include <SFML/Graphics/Sprite.hpp>
+#include <SFML/System/Clock.hpp>
 
 #include <Engine/MoveGeneration/Move.h>
+#include <Engine/Search/TranspositionTable.h>
+#include <Engine/Search/BackgroundSearch.h>
+#include <Engine/Book/Book.h>
 
 #include "Options.h"
 #include "HumanState.h"
@@ -27,8 +32,21 @@ namespace ChessFrontend {
     private:
         sf::RenderWindow window;
         ChessEngine::Board board;
+        ChessEngine::KeyHistory history; // Positions before the current one.
         Options options;
 
+        // Kept between moves so the AI reuses previous searches.
+        ChessEngine::Search::TranspositionTable transpositionTable;
+
+        // The AI searches in the background so the window keeps rendering.
+        // During the opponent's turn it ponders on the expected reply.
+        ChessEngine::Search::BackgroundSearch backgroundSearch;
+        ChessEngine::MoveGeneration::Move ponderMove;
+
+        // Opening book moves are picked before searching.
+        ChessEngine::Book::BookOptions bookOptions;
+        uint64_t bookSeed;
+
         // Used for human move selection.
         // Describes current active player.
         // Not used for AIs.
@@ -42,6 +60,11 @@ namespace ChessFrontend {
 
         float elapsedAnimTime;
 
+        // Remaining clock time in seconds. Index via color.
+        float clocks[2];
+        sf::Clock turnClock; // Time spent on the current turn.
+        bool turnStarted;
+
         // Used for handling single clicks.
         bool singleClick;
         bool clickRelease;
@@ -55,10 +78,18 @@ namespace ChessFrontend {
         bool HumanTurn();
         bool AiTurn(); // Handles AI moves.
 
+        bool IsAI(ChessEngine::Color color) const;
+        ChessEngine::Search::TimeControl GetTimeControl(ChessEngine::Color color, float elapsed);
+        void StartSearch(const ChessEngine::Board& position, const ChessEngine::KeyHistory& positionHistory, bool ponder, float elapsed);
+        void StartNextSearch(const ChessEngine::Search::SearchResult& result); // After an AI move.
+        void OnHumanMove(); // Converts or discards the ponder search.
+
         std::vector<sf::Vector2i> GetIgnoreList();
         void SwapSides();
 
         void PlayMove();
+        void UpdateClock(bool moved);
+        void CheckGameOver(); // Updates the game state after a move.
 
 
     };
@@ -4,20 +4,32 @@
 #include "WindowSettings.h"
 
 namespace ChessFrontend {
+
+    /* Search used by an AI player. */
+    enum class AIType {
+        AlphaBeta, MonteCarlo
+    };
+
     /* Options used inside the game class */
     struct Options {
         const bool whiteAI;
         const bool blackAI;
+        const AIType whiteAIType;
+        const AIType blackAIType;
         const bool sideSwap;
 
         ChessEngine::Color startingView;
 
         const float secPerMove;
 
+        // Chess clock , each side starts with clockTime seconds and gains clockIncrement after every move.
+        const float clockTime;
+        const float clockIncrement;
+
         const WindowSettings windowSettings;
 
-        Options(bool whiteAI, bool blackAI, float secPerMove, bool sideSwap, ChessEngine::Color startingView, const WindowSettings& windowSettings)
-        : whiteAI(whiteAI), blackAI(blackAI), secPerMove(secPerMove), windowSettings(windowSettings), startingView(startingView), sideSwap(sideSwap)
+        Options(bool whiteAI, bool blackAI, AIType whiteAIType, AIType blackAIType, float secPerMove, float clockTime, float clockIncrement, bool sideSwap, ChessEngine::Color startingView, const WindowSettings& windowSettings)
+        : whiteAI(whiteAI), blackAI(blackAI), whiteAIType(whiteAIType), blackAIType(blackAIType), secPerMove(secPerMove), clockTime(clockTime), clockIncrement(clockIncrement), windowSettings(windowSettings), startingView(startingView), sideSwap(sideSwap)
         {}
     };
 
@@ -0,0 +1,473 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <cstring>
+#include <cctype>
+
+#include <Engine/FenParser/FenParser.h>
+#include <Engine/Search/Search.h>
+#include <Engine/Search/ParallelSearch.h>
+#include <Engine/Search/MonteCarlo.h>
+#include <Engine/MoveGeneration/MoveTables.h>
+#include <Engine/MoveGeneration/RandomMove.h>
+#include <Engine/MoveGeneration/MoveGeneration.h>
+#include <Engine/Utilities/Memory.h>
+#include <Engine/Evaluation/Nnue.h>
+
+using namespace ChessEngine;
+
+/* Fixed set of positions so node counts can be compared between builds. */
+static const std::vector<std::string> benchPositions = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP2BPPP/R2QKB1R w KQ - 0 8",
+        "2r3k1/pp3ppp/2n1b3/3p4/3P4/2PB1N2/P4PPP/4R1K1 w - - 0 20",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "8/8/4k3/3p4/3P4/4K3/8/8 w - - 0 1",
+};
+
+struct BenchConfig {
+    std::string name;
+    Search::PruningOptions pruning;
+};
+
+static std::vector<BenchConfig> GetConfigs() {
+    Search::PruningOptions none;
+    none.nullMove = false;
+    none.nullMoveVerification = false;
+    none.lateMoveReductions = false;
+    none.reverseFutility = false;
+    none.futility = false;
+    none.lateMovePruning = false;
+    none.razoring = false;
+
+    std::vector<BenchConfig> configs = {{"all", {}}, {"none", none}};
+
+    // Disable one technique at a time.
+    Search::PruningOptions options;
+    options = {}; options.nullMove = false; configs.push_back({"no null move", options});
+    options = {}; options.nullMoveVerification = false; configs.push_back({"no verification", options});
+    options = {}; options.lateMoveReductions = false; configs.push_back({"no lmr", options});
+    options = {}; options.reverseFutility = false; configs.push_back({"no reverse futility", options});
+    options = {}; options.futility = false; configs.push_back({"no futility", options});
+    options = {}; options.lateMovePruning = false; configs.push_back({"no lmp", options});
+    options = {}; options.razoring = false; configs.push_back({"no razoring", options});
+
+    return configs;
+}
+
+struct BenchTotals {
+    uint64_t nodes = 0;
+    int64_t ms = 0;
+
+    Search::SearchStats stats;
+    std::vector<Search::IterationStats> iterations; // Summed by depth over all positions.
+};
+
+/* Search every bench position , each one starts from an empty transposition table. */
+static BenchTotals RunPositions(const std::vector<BoardState>& positions, const Search::SearchLimits& limits,
+                                const Search::PruningOptions& pruning, Search::TranspositionTable& transpositionTable) {
+    BenchTotals totals;
+    auto start = std::chrono::steady_clock::now();
+
+    for (auto& state : positions) {
+        transpositionTable.Clear();
+        auto result = Search::Search(Board(state), limits, pruning, transpositionTable);
+        totals.nodes += result.nodes;
+        totals.stats.Add(result.stats);
+
+        for (auto& iteration : result.iterations) {
+            if (totals.iterations.size() < (size_t) iteration.depth)
+                totals.iterations.resize(iteration.depth);
+
+            auto& sum = totals.iterations[iteration.depth - 1];
+            sum.depth = iteration.depth;
+            sum.nodes += iteration.nodes;
+            sum.timeMs += iteration.timeMs;
+        }
+    }
+
+    for (size_t i = 1; i < totals.iterations.size(); i++) {
+        uint64_t previousNodes = totals.iterations[i - 1].nodes;
+        if (previousNodes != 0)
+            totals.iterations[i].branchingFactor = (double) totals.iterations[i].nodes / (double) previousNodes;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    totals.ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    return totals;
+}
+
+static void PrintHeader(const std::string& title) {
+    std::cout << std::endl << title << std::endl;
+    std::cout << std::left << std::setw(22) << "config"
+              << std::setw(14) << "nodes"
+              << std::setw(10) << "ms"
+              << std::setw(12) << "nps"
+              << "overhead" << std::endl;
+}
+
+static void PrintRow(const std::string& name, const BenchTotals& totals, const BenchTotals& baseline) {
+    uint64_t nps = totals.nodes * 1000 / (totals.ms + 1);
+    double overhead = (double) totals.nodes / (double) std::max<uint64_t>(baseline.nodes, 1);
+
+    std::cout << std::left << std::setw(22) << name
+              << std::setw(14) << totals.nodes
+              << std::setw(10) << totals.ms
+              << std::setw(12) << nps
+              << std::fixed << std::setprecision(2) << overhead << "x" << std::endl;
+}
+
+static void PrintMapping(const std::string& name, const Memory::Mapping& mapping) {
+    std::cout << std::left << std::setw(22) << name
+              << std::setw(12) << std::to_string(mapping.size / 1024) + " KB"
+              << std::setw(20) << Memory::PageSizeToString(mapping.pages)
+              << Memory::GetHugePageBytes(mapping) / 1024 << " KB" << std::endl;
+}
+
+/* What the memory options actually got , and the speed of random probes into the large tables. */
+static void PrintMemoryReport() {
+    const auto& options = Memory::GetOptions();
+    std::cout << "Memory" << std::endl;
+    std::cout << std::left << std::setw(22) << "table"
+              << std::setw(12) << "size"
+              << std::setw(20) << "pages"
+              << "in huge pages" << std::endl;
+
+    constexpr size_t largeTableMB = 256;
+    Search::TranspositionTable largeTable(largeTableMB);
+    PrintMapping("sliding moves", MoveGeneration::MoveTables::GetSlidingMovesMapping());
+    PrintMapping("transposition table", largeTable.GetMapping());
+
+    // Random keys , the access pattern of a search without its locality.
+    constexpr int probes = 10000000;
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    Search::TTData data;
+    int hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < probes; i++) {
+        uint64_t key = MoveGeneration::NextRandom(seed);
+        if (largeTable.Probe(key, data))
+            hits++;
+        else if (i % 2 == 0)
+            largeTable.Store(key, data);
+    }
+    auto end = std::chrono::steady_clock::now();
+    int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "tt probes/sec " << (int64_t) probes * 1000 / (ms + 1) << " (" << hits << " hits)" << std::endl;
+
+    uint64_t occupancies = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < probes; i++) {
+        uint64_t random = MoveGeneration::NextRandom(seed);
+        occupancies ^= MoveGeneration::MoveTables::GetQueenMoves(random & 63, random & (random >> 8));
+    }
+    end = std::chrono::steady_clock::now();
+    ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "sliding lookups/sec " << (int64_t) probes * 1000 / (ms + 1) << " (checksum " << (occupancies & 0xFF) << ")" << std::endl;
+
+    std::cout << "numa nodes " << Memory::GetNumaNodeCount()
+              << " , first touch " << (options.numaFirstTouch ? "on" : "off") << std::endl;
+
+    bool pinned = false;
+    if (options.pinThreads)
+        std::thread([&pinned]() { pinned = Memory::PinThread(1); }).join();
+    std::cout << "thread pinning " << (options.pinThreads ? (pinned ? "on" : "on , failed") : "off") << std::endl;
+}
+
+/* Random weights , only the speed of the network is measured. */
+static Evaluation::Nnue::Network GetRandomNetwork() {
+    using namespace Evaluation::Nnue;
+
+    uint64_t seed = 0x2545F4914F6CDD1DULL;
+    auto next = [&seed](int range) { return (int) (MoveGeneration::NextRandom(seed) % (2 * range + 1)) - range; };
+
+    Network network;
+    network.featureBiases.resize(hiddenSize);
+    network.featureWeights.resize((size_t) featureCount * hiddenSize);
+    network.outputWeights.resize(2 * hiddenSize);
+    for (auto& weight : network.featureBiases)
+        weight = (int16_t) next(32);
+    for (auto& weight : network.featureWeights)
+        weight = (int16_t) next(8);
+    for (auto& weight : network.outputWeights)
+        weight = (int8_t) next(127);
+    return network;
+}
+
+template<typename Function>
+static int64_t TimeNanoseconds(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+/* Evaluations per second and the cost of a full accumulator refresh against an incremental update ,
+ * measured on positions reached by random moves from the bench positions. Ends with the network unloaded. */
+static void PrintNetworkReport(const std::vector<BoardState>& positions, const std::string& networkPath,
+                               const Search::SearchLimits& limits, Search::TranspositionTable& transpositionTable) {
+    using namespace Evaluation::Nnue;
+
+    // The search without the network first , the same positions with it after. Random weights
+    // order the moves badly , the node limit keeps the search short.
+    Search::SearchLimits searchLimits = limits;
+    searchLimits.nodes = 200000;
+    Search::ClearEvalCache(); // Both searches start cold.
+    BenchTotals classical = RunPositions(positions, searchLimits, {}, transpositionTable);
+
+    std::cout << std::endl << "Network , kernels " << GetKernelName() << std::endl;
+    if (networkPath.empty()) {
+        std::cout << "random weights (pass --network <file> for a trained one)" << std::endl;
+        SetNetwork(GetRandomNetwork());
+    } else if (!LoadNetwork(networkPath)) {
+        std::cout << "Could not load " << networkPath << std::endl;
+        return;
+    }
+    // Nothing cached by the classical searches may be reused. RunPositions clears the table per position.
+    Search::ClearEvalCache();
+
+    // Each child keeps the accumulator of its parent , so updating it repeats the update MakeMove did.
+    struct Sample {
+        BoardState child;
+        BitboardUtil::Bitboard previous[2][6];
+    };
+    std::vector<Sample> samples;
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    constexpr int samplesPerPosition = 2000;
+    constexpr int walkLength = 30; // Restart before the random moves trade everything off.
+    for (auto& position : positions) {
+        Board board(position);
+        RefreshAccumulator(board.GetState());
+        for (int i = 0; i < samplesPerPosition; i++) {
+            const BoardState& state = board.GetState();
+            MoveGeneration::Move move;
+            if (i % walkLength == walkLength - 1 || !MoveGeneration::GetRandomMove(state, state.turnOf, board.GetOccupancies(), seed, move)) {
+                board = Board(position);
+                RefreshAccumulator(board.GetState());
+                continue;
+            }
+
+            Sample sample;
+            std::memcpy(sample.previous, state.pieceBoards, sizeof(sample.previous));
+            Accumulator parentAccumulator = state.accumulator;
+            MoveGeneration::MakeMove(move, state.turnOf, board.GetState(), board.GetOccupancies());
+            sample.child = board.GetState();
+            sample.child.accumulator = parentAccumulator;
+            samples.push_back(sample);
+        }
+    }
+
+    constexpr int rounds = 20;
+    BoardState scratch = {};
+    int64_t checksum = 0;
+    int64_t updateNs = TimeNanoseconds([&]() {
+        for (int round = 0; round < rounds; round++) {
+            for (auto& sample : samples) {
+                scratch = sample.child;
+                UpdateAccumulator(scratch, sample.previous);
+                checksum += scratch.accumulator.values[0][0];
+            }
+        }
+    });
+    int64_t refreshNs = TimeNanoseconds([&]() {
+        for (int round = 0; round < rounds; round++) {
+            for (auto& sample : samples) {
+                scratch = sample.child;
+                RefreshAccumulator(scratch);
+                checksum += scratch.accumulator.values[0][0];
+            }
+        }
+    });
+
+    // Evaluations of up to date accumulators.
+    for (auto& sample : samples)
+        UpdateAccumulator(sample.child, sample.previous);
+    int64_t evaluateNs = TimeNanoseconds([&]() {
+        for (int round = 0; round < rounds; round++)
+            for (auto& sample : samples)
+                checksum += Evaluate(sample.child);
+    });
+
+    int64_t count = (int64_t) samples.size() * rounds;
+    std::cout << "evaluations/sec " << count * 1000000000 / (evaluateNs + 1) << std::endl;
+    std::cout << "incremental updates/sec " << count * 1000000000 / (updateNs + 1) << std::endl;
+    std::cout << "full refreshes/sec " << count * 1000000000 / (refreshNs + 1) << std::endl;
+    std::cout << "refresh / incremental cost " << std::fixed << std::setprecision(2)
+              << (double) refreshNs / (double) (updateNs + 1) << "x (checksum " << (checksum & 0xFF) << ")" << std::endl;
+
+    // Positions parsed before the network was set are refreshed by their first move.
+    BenchTotals network = RunPositions(positions, searchLimits, {}, transpositionTable);
+    std::cout << "search nps " << classical.nodes * 1000 / (classical.ms + 1) << " without the network , "
+              << network.nodes * 1000 / (network.ms + 1) << " with it" << std::endl;
+
+    ClearNetwork();
+    Search::ClearEvalCache();
+    transpositionTable.Clear();
+}
+
+int main(int argc, char* argv[]) {
+    int depth = 5;
+    std::string networkPath;
+    Memory::MemoryOptions memoryOptions;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--network" && i + 1 < argc)
+            networkPath = argv[++i];
+        else if (argument == "--no-huge-pages")
+            memoryOptions.hugePages = false;
+        else if (argument == "--first-touch")
+            memoryOptions.numaFirstTouch = true;
+        else if (argument == "--pin-threads")
+            memoryOptions.pinThreads = true;
+        else if (!argument.empty() && argument.size() <= 3 && std::all_of(argument.begin(), argument.end(), ::isdigit))
+            depth = std::stoi(argument);
+        else {
+            std::cout << "Usage : Bench [depth] [--no-huge-pages] [--first-touch] [--pin-threads] [--network <file>]" << std::endl;
+            return -1;
+        }
+    }
+
+    Memory::SetOptions(memoryOptions);
+    ChessEngine::Init();
+
+    PrintMemoryReport();
+
+    std::vector<BoardState> positions;
+    for (auto& fen : benchPositions) {
+        BoardState state = {};
+        if (!ParseFenString(fen, state)) {
+            std::cout << "Incorrect fen string " << fen << std::endl;
+            return -1;
+        }
+        positions.push_back(state);
+    }
+
+    Search::TranspositionTable transpositionTable(16);
+    Search::SearchLimits limits;
+    limits.depth = depth;
+
+    // Node counts relative to all pruning enabled.
+    PrintHeader("Pruning , depth " + std::to_string(depth));
+    BenchTotals baseline;
+    for (auto& config : GetConfigs()) {
+        auto totals = RunPositions(positions, limits, config.pruning, transpositionTable);
+        if (baseline.nodes == 0)
+            baseline = totals;
+        PrintRow(config.name, totals, baseline);
+    }
+
+    // Search counters of the default configuration.
+    std::cout << std::endl << "Statistics" << std::endl;
+#ifdef ENGINE_SEARCH_STATS
+    std::cout << baseline.stats << std::endl;
+    std::cout << std::left << std::setw(8) << "depth"
+              << std::setw(14) << "nodes"
+              << std::setw(10) << "ms"
+              << "ebf" << std::endl;
+    for (auto& iteration : baseline.iterations) {
+        std::cout << std::left << std::setw(8) << iteration.depth
+                  << std::setw(14) << iteration.nodes
+                  << std::setw(10) << iteration.timeMs
+                  << std::fixed << std::setprecision(2) << iteration.branchingFactor << std::endl;
+    }
+#else
+    std::cout << "not available , built without ENGINE_SEARCH_STATS" << std::endl;
+#endif
+
+    // Cost of every extra line relative to a single PV search.
+    PrintHeader("Multi-PV , depth " + std::to_string(depth));
+    constexpr int maxMultiPV = 4;
+    BenchTotals totals;
+    for (int multiPV = 1; multiPV <= maxMultiPV; multiPV++) {
+        Search::SearchLimits multiPVLimits = limits;
+        multiPVLimits.multiPV = multiPV;
+
+        totals = RunPositions(positions, multiPVLimits, {}, transpositionTable);
+        if (multiPV == 1)
+            baseline = totals;
+        PrintRow(std::to_string(multiPV) + " pv", totals, baseline);
+    }
+
+    double extraNodes = (double) totals.nodes / (double) std::max<uint64_t>(baseline.nodes, 1) - 1.0;
+    std::cout << "overhead per extra pv: " << std::fixed << std::setprecision(2)
+              << extraNodes / (maxMultiPV - 1) << "x nodes" << std::endl;
+
+    // Parallel search scaling , every thread count has to find the same moves and scores.
+    std::cout << std::endl << "Parallel , depth " << depth << std::endl;
+    std::cout << std::left << std::setw(10) << "threads"
+              << std::setw(14) << "nodes"
+              << std::setw(10) << "ms"
+              << std::setw(10) << "speedup"
+              << "identical" << std::endl;
+
+    int maxThreads = std::clamp((int) std::thread::hardware_concurrency(), 2, 8);
+    std::vector<Search::SearchResult> singleThreadResults;
+    int64_t singleThreadMs = 0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        Search::ParallelOptions parallelOptions;
+        parallelOptions.threads = threads;
+
+        uint64_t nodes = 0;
+        bool identical = true;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < positions.size(); i++) {
+            auto result = Search::ParallelSearch(Board(positions[i]), limits, {}, parallelOptions);
+            nodes += result.nodes;
+
+            if (threads == 1) {
+                singleThreadResults.push_back(result);
+            } else {
+                auto& expected = singleThreadResults[i];
+                identical &= MoveGeneration::PackMove(result.bestMove) == MoveGeneration::PackMove(expected.bestMove) &&
+                             result.score == expected.score && result.nodes == expected.nodes;
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        if (threads == 1)
+            singleThreadMs = ms;
+
+        std::cout << std::left << std::setw(10) << threads
+                  << std::setw(14) << nodes
+                  << std::setw(10) << ms
+                  << std::setw(10) << std::fixed << std::setprecision(2) << (double) (singleThreadMs + 1) / (double) (ms + 1)
+                  << (identical ? "yes" : "no") << std::endl;
+    }
+
+    // Monte Carlo playout throughput , strength against alpha beta is measured by the Match tool.
+    constexpr uint64_t playoutsPerPosition = 10000;
+    std::cout << std::endl << "Monte Carlo , " << playoutsPerPosition << " playouts per position" << std::endl;
+    std::cout << std::left << std::setw(10) << "threads"
+              << std::setw(14) << "playouts"
+              << std::setw(10) << "ms"
+              << "playouts/sec" << std::endl;
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        Search::MonteCarloOptions monteCarloOptions;
+        monteCarloOptions.threads = threads;
+
+        Search::SearchLimits monteCarloLimits;
+        monteCarloLimits.nodes = playoutsPerPosition;
+
+        uint64_t playouts = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (auto& state : positions)
+            playouts += Search::MonteCarloSearch(Board(state), monteCarloLimits, monteCarloOptions).nodes;
+        auto end = std::chrono::steady_clock::now();
+        int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+        std::cout << std::left << std::setw(10) << threads
+                  << std::setw(14) << playouts
+                  << std::setw(10) << ms
+                  << playouts * 1000 / (ms + 1) << std::endl;
+    }
+
+    PrintNetworkReport(positions, networkPath, limits, transpositionTable);
+
+    return 0;
+}
@@ -0,0 +1,378 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <unordered_map>
+
+#include <Engine/FenParser/FenParser.h>
+#include <Engine/MoveGeneration/MoveGeneration.h>
+#include <Engine/Book/Book.h>
+
+using namespace ChessEngine;
+
+/* Builds an opening book (see Engine/Book) from PGN files. Games are read in batches and replayed
+ * by the threads , each counting the results of the (position , move) pairs of the first plies in
+ * its own map. The maps are merged at the end and written sorted. A move's weight is 2 per win and
+ * 1 per draw for the side that played it , scaled down to 16 bits when needed. */
+
+const std::string startingFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Games handed to the threads at a time.
+constexpr size_t batchSize = 1 << 14;
+
+struct Game {
+    std::string fen;
+    std::string result;
+    std::string moveText;
+};
+
+struct EntryKey {
+    uint64_t key;
+    uint16_t move;
+
+    bool operator==(const EntryKey& other) const { return key == other.key && move == other.move; }
+};
+
+struct EntryKeyHash {
+    size_t operator()(const EntryKey& entry) const { return entry.key ^ (entry.move * 0x9E3779B97F4A7C15ull); }
+};
+
+struct Results {
+    uint32_t wins = 0;
+    uint32_t draws = 0;
+    uint32_t losses = 0;
+};
+
+using ResultMap = std::unordered_map<EntryKey, Results, EntryKeyHash>;
+
+/*******************************************************/
+/* PGN                                                 */
+/*******************************************************/
+
+/* The value of a tag line like [Result "1-0"]. */
+static std::string GetTagValue(const std::string& line) {
+    size_t first = line.find('"');
+    size_t last = line.rfind('"');
+    if (first == std::string::npos || last <= first)
+        return "";
+    return line.substr(first + 1, last - first - 1);
+}
+
+/* Calls onGame for every game of the file. */
+template<typename Function>
+static bool ReadGames(const std::string& path, Function onGame) {
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    Game game;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        if (!line.empty() && line[0] == '[') {
+            // A tag after some moves starts the next game.
+            if (!game.moveText.empty()) {
+                onGame(game);
+                game = {};
+            }
+
+            if (line.rfind("[Result ", 0) == 0)
+                game.result = GetTagValue(line);
+            else if (line.rfind("[FEN ", 0) == 0)
+                game.fen = GetTagValue(line);
+            continue;
+        }
+
+        game.moveText += line;
+        game.moveText += ' ';
+    }
+
+    if (!game.moveText.empty())
+        onGame(game);
+    return true;
+}
+
+/* The moves of the move text without comments , variations , annotations and move numbers. */
+static std::vector<std::string> GetMoveTokens(const std::string& moveText) {
+    std::vector<std::string> tokens;
+    std::string token;
+    int variationDepth = 0;
+    bool inComment = false, inLineComment = false;
+
+    auto endToken = [&]() {
+        // Move numbers can be glued to the move (1.e4) , the results start with digits too.
+        bool isResult = token == "1-0" || token == "0-1" || token == "1/2-1/2";
+        size_t start = isResult ? 0 : token.find_first_not_of("0123456789.");
+        if (start != std::string::npos && token[0] != '$' && variationDepth == 0)
+            tokens.push_back(token.substr(start));
+        token.clear();
+    };
+
+    for (char c : moveText) {
+        if (inComment) {
+            inComment = c != '}';
+            continue;
+        }
+        if (inLineComment) {
+            inLineComment = c != '\n';
+            continue;
+        }
+
+        if (c == '{' || c == ';' || c == '(' || c == ')' || std::isspace((unsigned char) c)) {
+            endToken();
+            inComment = c == '{';
+            inLineComment = c == ';';
+            if (c == '(')
+                variationDepth++;
+            else if (c == ')')
+                variationDepth = std::max(variationDepth - 1, 0);
+            continue;
+        }
+        token += c;
+    }
+    endToken();
+
+    return tokens;
+}
+
+static PieceType CharToPieceType(char c) {
+    switch (c) {
+        case 'K': return PieceType::King;
+        case 'Q': return PieceType::Queen;
+        case 'R': return PieceType::Rook;
+        case 'B': return PieceType::Bishop;
+        case 'N': return PieceType::Knight;
+        default: return PieceType::None;
+    }
+}
+
+/* Finds the valid move written in standard algebraic notation , false when none or several match. */
+static bool ParseSan(std::string san, const std::list<MoveGeneration::Move>& validMoves, MoveGeneration::Move& move) {
+    using namespace MoveGeneration;
+
+    while (!san.empty() && std::string("+#!?").find(san.back()) != std::string::npos)
+        san.pop_back();
+
+    MoveType castling = MoveType::None;
+    if (san == "O-O" || san == "0-0")
+        castling = MoveType::KingSideCastling;
+    else if (san == "O-O-O" || san == "0-0-0")
+        castling = MoveType::QueenSideCastling;
+
+    PieceType promotion = PieceType::None;
+    if (castling == MoveType::None && san.size() >= 3 && CharToPieceType(san.back()) != PieceType::None &&
+        (san[san.size() - 2] == '=' || std::isdigit((unsigned char) san[san.size() - 2]))) {
+        promotion = CharToPieceType(san.back());
+        san.pop_back();
+        if (san.back() == '=')
+            san.pop_back();
+    }
+
+    PieceType type = PieceType::Pawn;
+    if (!san.empty() && CharToPieceType(san[0]) != PieceType::None) {
+        type = CharToPieceType(san[0]);
+        san.erase(0, 1);
+    }
+    san.erase(std::remove(san.begin(), san.end(), 'x'), san.end());
+
+    int toFile = -1, toRank = -1, fromFile = -1, fromRank = -1;
+    if (castling == MoveType::None) {
+        if (san.size() < 2 || san.size() > 4)
+            return false;
+        toFile = san[san.size() - 2] - 'a';
+        toRank = san[san.size() - 1] - '1';
+        if (toFile < 0 || toFile > 7 || toRank < 0 || toRank > 7)
+            return false;
+
+        for (size_t i = 0; i + 2 < san.size(); i++) {
+            if (san[i] >= 'a' && san[i] <= 'h')
+                fromFile = san[i] - 'a';
+            else if (san[i] >= '1' && san[i] <= '8')
+                fromRank = san[i] - '1';
+            else
+                return false;
+        }
+    }
+
+    int matches = 0;
+    for (auto& valid : validMoves) {
+        bool isCastling = IsMoveType(valid.flags, MoveType::KingSideCastling) ||
+                          IsMoveType(valid.flags, MoveType::QueenSideCastling);
+        if (castling != MoveType::None) {
+            if (!IsMoveType(valid.flags, castling))
+                continue;
+        } else {
+            PieceType validPromotion = IsMoveType(valid.flags, MoveType::Promotion) ? valid.promotionType : PieceType::None;
+            if (isCastling || valid.selfType != type || validPromotion != promotion ||
+                valid.toSquareIndex != toRank * 8 + toFile ||
+                (fromFile != -1 && valid.fromSquareIndex % 8 != fromFile) ||
+                (fromRank != -1 && valid.fromSquareIndex / 8 != fromRank))
+                continue;
+        }
+
+        move = valid;
+        matches++;
+    }
+
+    return matches == 1;
+}
+
+/*******************************************************/
+/* Building                                            */
+/*******************************************************/
+
+/* Counts the first plies of the game , false when it can't be replayed. */
+static bool AddGame(const Game& game, int plies, ResultMap& results) {
+    int whiteScore;
+    if (game.result == "1-0")
+        whiteScore = 1;
+    else if (game.result == "1/2-1/2")
+        whiteScore = 0;
+    else if (game.result == "0-1")
+        whiteScore = -1;
+    else
+        return false; // Unfinished.
+
+    BoardState initialState;
+    if (!ParseFenString(game.fen.empty() ? startingFen : game.fen, initialState))
+        return false;
+
+    Board board(initialState);
+    BoardState& state = board.GetState();
+
+    auto tokens = GetMoveTokens(game.moveText);
+    for (int ply = 0; ply < plies && ply < (int) tokens.size(); ply++) {
+        const std::string& token = tokens[ply];
+        if (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*")
+            break;
+
+        auto validMoves = MoveGeneration::GetValidMoves(state, state.turnOf, board.GetOccupancies());
+        MoveGeneration::Move move{};
+        if (!ParseSan(token, validMoves, move))
+            return ply > 0; // Keep what was counted before the bad move.
+
+        Results& entry = results[{state.hashKey, MoveGeneration::PackMove(move)}];
+        int score = state.turnOf == Color::White ? whiteScore : -whiteScore;
+        if (score > 0)
+            entry.wins++;
+        else if (score == 0)
+            entry.draws++;
+        else
+            entry.losses++;
+
+        MoveGeneration::MakeMove(move, state.turnOf, state, board.GetOccupancies());
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cout << "Usage : Book <book file> <pgn file>... [--plies n] [--min-games n] [--threads n]" << std::endl;
+        return -1;
+    }
+
+    std::string bookPath = argv[1];
+    int plies = 30;
+    uint32_t minimumGames = 1;
+    int threads = (int) std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<std::string> pgnPaths;
+    for (int i = 2; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--plies" && i + 1 < argc)
+            plies = std::max(std::stoi(argv[++i]), 1);
+        else if (argument == "--min-games" && i + 1 < argc)
+            minimumGames = (uint32_t) std::max(std::stoi(argv[++i]), 1);
+        else if (argument == "--threads" && i + 1 < argc)
+            threads = std::max(std::stoi(argv[++i]), 1);
+        else
+            pgnPaths.push_back(argument);
+    }
+
+    ChessEngine::Init();
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<ResultMap> threadResults(threads);
+    std::atomic<uint64_t> gamesAdded = 0, gamesSkipped = 0;
+    std::vector<Game> batch;
+
+    auto runBatch = [&]() {
+        std::atomic<size_t> next = 0;
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threads; i++) {
+            workers.emplace_back([&, i]() {
+                for (size_t game = next.fetch_add(1); game < batch.size(); game = next.fetch_add(1)) {
+                    if (AddGame(batch[game], plies, threadResults[i]))
+                        gamesAdded++;
+                    else
+                        gamesSkipped++;
+                }
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+        batch.clear();
+    };
+
+    for (auto& path : pgnPaths) {
+        bool read = ReadGames(path, [&](const Game& game) {
+            batch.push_back(game);
+            if (batch.size() == batchSize)
+                runBatch();
+        });
+        if (!read)
+            std::cout << "Could not read " << path << std::endl;
+    }
+    runBatch();
+
+    // Merge the threads' counts.
+    ResultMap& results = threadResults[0];
+    for (int i = 1; i < threads; i++) {
+        for (auto& [key, counts] : threadResults[i]) {
+            Results& entry = results[key];
+            entry.wins += counts.wins;
+            entry.draws += counts.draws;
+            entry.losses += counts.losses;
+        }
+        ResultMap().swap(threadResults[i]);
+    }
+
+    std::vector<Book::BookEntry> entries;
+    uint64_t maxWeight = 0;
+    for (auto& [key, counts] : results) {
+        if (counts.wins + counts.draws + counts.losses < minimumGames)
+            continue;
+        entries.push_back({key.key, key.move, 0, counts.wins, counts.draws, counts.losses});
+        maxWeight = std::max<uint64_t>(maxWeight, 2ull * counts.wins + counts.draws);
+    }
+
+    for (auto& entry : entries) {
+        uint64_t weight = 2ull * entry.wins + entry.draws;
+        if (maxWeight > UINT16_MAX && weight > 0)
+            weight = std::max<uint64_t>(weight * UINT16_MAX / maxWeight, 1);
+        entry.weight = (uint16_t) weight;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Book::BookEntry& a, const Book::BookEntry& b) {
+        return a.key != b.key ? a.key < b.key : a.move < b.move;
+    });
+
+    if (!Book::SaveBook(bookPath, entries)) {
+        std::cout << "Could not write " << bookPath << std::endl;
+        return -1;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Games : " << gamesAdded << " (skipped " << gamesSkipped << ")" << std::endl;
+    std::cout << "Entries : " << entries.size() << std::endl;
+    std::cout << "Time : " << elapsed << " ms" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,38 @@
+#include "SelfPlay.h"
+
+#include <Engine/MoveGeneration/MoveGeneration.h>
+#include <Engine/MoveGeneration/Draw.h>
+
+namespace ChessEngine::SelfPlay {
+
+    const std::vector<std::string> openings = {
+            "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+            "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+            "rnbqkb1r/pp2pppp/3p1n2/8/3NP3/8/PPP2PPP/RNBQKB1R w KQkq - 1 5",
+            "rnbqkbnr/ppp2ppp/4p3/3p4/3PP3/8/PPP2PPP/RNBQKBNR w KQkq - 0 3",
+            "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP2BPPP/R2QKB1R w KQ - 0 8",
+    };
+
+    Result PlayGame(const BoardState& start, const MovePicker& pickMove) {
+        using namespace MoveGeneration;
+
+        Board board(start);
+        KeyHistory history;
+        for (int ply = 0; ply < maxPlies; ply++) {
+            auto& state = board.GetState();
+            auto moves = GetValidMoves(state, state.turnOf, board.GetOccupancies());
+            if (Draw::IsCheckmate(board, moves))
+                return state.turnOf == Color::White ? Result::BlackWins : Result::WhiteWins;
+            if (Draw::IsDraw(board, moves, history) || Draw::TablebaseDraw(state))
+                return Result::Draw;
+
+            Move move = pickMove(board, history);
+
+            history.Push(state.hashKey);
+            MakeMove(move, state.turnOf, state, board.GetOccupancies());
+        }
+
+        return Result::Draw;
+    }
+
+}
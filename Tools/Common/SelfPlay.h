@@ -0,0 +1,32 @@
+#ifndef SELF_PLAY_H
+#define SELF_PLAY_H
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <Engine/Board/Board.h>
+#include <Engine/Board/KeyHistory.h>
+#include <Engine/MoveGeneration/Move.h>
+
+/* Games between engines , shared by the Match and Spsa tools. */
+namespace ChessEngine::SelfPlay {
+
+    extern const std::vector<std::string> openings;
+
+    // Games without a result by then are adjudicated as draws.
+    constexpr int maxPlies = 200;
+
+    enum class Result {
+        WhiteWins, BlackWins, Draw
+    };
+
+    /* Picks the move of the side to move , history holds the positions before the board's one. */
+    using MovePicker = std::function<MoveGeneration::Move(const Board& board, const KeyHistory& history)>;
+
+    /* Plays from start until a mate , a draw (tablebase draws included) or maxPlies. */
+    Result PlayGame(const BoardState& start, const MovePicker& pickMove);
+
+}
+
+#endif
@@ -0,0 +1,97 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include <Engine/FenParser/FenParser.h>
+#include <Engine/Search/Search.h>
+#include <Engine/Search/MonteCarlo.h>
+#include <Engine/Tablebase/Tablebase.h>
+#include <Tools/Common/SelfPlay.h>
+
+using namespace ChessEngine;
+
+struct EngineTotals {
+    uint64_t nodes = 0; // Playouts for Monte Carlo.
+    int64_t ms = 0;
+};
+
+static SelfPlay::Result PlayGame(const BoardState& opening, bool monteCarloWhite, int64_t msPerMove, int threads,
+                                 EngineTotals& alphaBetaTotals, EngineTotals& monteCarloTotals) {
+    Search::TranspositionTable transpositionTable(16);
+
+    Search::SearchLimits limits;
+    limits.time.remainingMs = msPerMove;
+    limits.time.movesToGo = 1; // The whole budget can go to this move.
+
+    Search::MonteCarloOptions monteCarloOptions;
+    monteCarloOptions.threads = threads;
+
+    return SelfPlay::PlayGame(opening, [&](const Board& board, const KeyHistory& history) {
+        limits.history = history;
+
+        bool monteCarloTurn = (board.GetState().turnOf == Color::White) == monteCarloWhite;
+        Search::SearchResult result;
+        if (monteCarloTurn) {
+            result = Search::MonteCarloSearch(board, limits, monteCarloOptions);
+            monteCarloTotals.nodes += result.nodes;
+            monteCarloTotals.ms += result.timeMs;
+        } else {
+            result = Search::Search(board, limits, {}, transpositionTable);
+            alphaBetaTotals.nodes += result.nodes;
+            alphaBetaTotals.ms += result.timeMs;
+        }
+        return result.bestMove;
+    });
+}
+
+int main(int argc, char* argv[]) {
+    int64_t msPerMove = (argc > 1) ? std::stoll(argv[1]) : 100;
+    int threads = (argc > 2) ? std::stoi(argv[2]) : 1;
+
+    ChessEngine::Init();
+
+    // Both engines probe them , drawn positions end the game.
+    if (argc > 3)
+        std::cout << Tablebase::LoadTables(argv[3]) << " tablebases loaded" << std::endl;
+
+    std::cout << "Monte Carlo (" << threads << " threads) against alpha beta , "
+              << msPerMove << " ms per move" << std::endl;
+
+    int wins = 0, draws = 0, losses = 0;
+    EngineTotals alphaBetaTotals, monteCarloTotals;
+    // Every opening is played twice , once with each engine as white.
+    for (auto& fen : SelfPlay::openings) {
+        BoardState opening = {};
+        if (!ParseFenString(fen, opening)) {
+            std::cout << "Incorrect fen string " << fen << std::endl;
+            return -1;
+        }
+
+        for (bool monteCarloWhite : {true, false}) {
+            SelfPlay::Result result = PlayGame(opening, monteCarloWhite, msPerMove, threads, alphaBetaTotals, monteCarloTotals);
+            if (result == SelfPlay::Result::Draw) {
+                draws++;
+            } else if ((result == SelfPlay::Result::WhiteWins) == monteCarloWhite) {
+                wins++;
+            } else {
+                losses++;
+            }
+
+            std::cout << "game " << wins + draws + losses << " : " << wins << " wins , "
+                      << draws << " draws , " << losses << " losses" << std::endl;
+        }
+    }
+
+    std::cout << std::endl << std::left << std::setw(14) << "engine"
+              << std::setw(16) << "nodes/sec" << std::endl;
+    std::cout << std::left << std::setw(14) << "alpha beta"
+              << std::setw(16) << alphaBetaTotals.nodes * 1000 / (alphaBetaTotals.ms + 1) << std::endl;
+    std::cout << std::left << std::setw(14) << "monte carlo"
+              << std::setw(16) << monteCarloTotals.nodes * 1000 / (monteCarloTotals.ms + 1) << "(playouts)" << std::endl;
+
+    double score = (wins + draws * 0.5) / std::max(wins + draws + losses, 1);
+    std::cout << "monte carlo score : " << std::fixed << std::setprecision(2) << score * 100.0 << "%" << std::endl;
+
+    return 0;
+}
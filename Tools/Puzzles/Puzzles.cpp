@@ -0,0 +1,140 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#include <Engine/FenParser/FenParser.h>
+#include <Engine/Search/MateSolver.h>
+
+using namespace ChessEngine;
+
+/* One puzzle per line : a fen , optionally followed by ";" and the expected mate length (0 for no mate). */
+struct Puzzle {
+    std::string fen;
+    int expectedMate = -1; // -1 when not given.
+
+    Search::MateSolution solution;
+    bool valid = true;
+};
+
+static bool ReadPuzzles(const std::string& path, std::vector<Puzzle>& puzzles) {
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        Puzzle puzzle;
+        size_t separator = line.find(';');
+        puzzle.fen = line.substr(0, separator);
+        if (separator != std::string::npos)
+            puzzle.expectedMate = std::stoi(line.substr(separator + 1));
+
+        puzzles.push_back(puzzle);
+    }
+
+    return true;
+}
+
+static std::string ResultToString(Search::MateResult result) {
+    switch (result) {
+        case Search::MateResult::Mate:
+            return "mate";
+        case Search::MateResult::NoMate:
+            return "no mate";
+        default:
+            return "unknown";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage : Puzzles <file> [threads] [max nodes per puzzle]" << std::endl;
+        return -1;
+    }
+
+    int threads = (argc > 2) ? std::stoi(argv[2]) : (int) std::max(std::thread::hardware_concurrency(), 1u);
+    Search::MateSolverOptions options;
+    if (argc > 3)
+        options.maxNodes = std::stoull(argv[3]);
+
+    std::vector<Puzzle> puzzles;
+    if (!ReadPuzzles(argv[1], puzzles)) {
+        std::cout << "Could not read " << argv[1] << std::endl;
+        return -1;
+    }
+
+    ChessEngine::Init();
+
+    // Each puzzle is solved by a single thread with its own table , the threads take the next unsolved one.
+    std::atomic<size_t> nextPuzzle = 0;
+    auto worker = [&]() {
+        for (size_t i = nextPuzzle++; i < puzzles.size(); i = nextPuzzle++) {
+            BoardState state = {};
+            if (!ParseFenString(puzzles[i].fen, state)) {
+                puzzles[i].valid = false;
+                continue;
+            }
+
+            Board board(state);
+            puzzles[i].solution = Search::SolveMate(board, options);
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++)
+        workers.emplace_back(worker);
+    for (auto& thread : workers)
+        thread.join();
+    auto end = std::chrono::steady_clock::now();
+    int64_t totalMs = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    std::cout << std::left << std::setw(6) << "#" << std::setw(10) << "result" << std::setw(8) << "mate"
+              << std::setw(10) << "expected" << std::setw(12) << "nodes" << std::setw(8) << "ms" << "line" << std::endl;
+
+    int solved = 0, matching = 0, checked = 0;
+    uint64_t totalNodes = 0;
+    for (size_t i = 0; i < puzzles.size(); i++) {
+        const Puzzle& puzzle = puzzles[i];
+        if (!puzzle.valid) {
+            std::cout << std::left << std::setw(6) << i + 1 << "incorrect fen string " << puzzle.fen << std::endl;
+            continue;
+        }
+
+        const auto& solution = puzzle.solution;
+        totalNodes += solution.nodes;
+        if (solution.result != Search::MateResult::Unknown)
+            solved++;
+
+        std::string expected = "-";
+        if (puzzle.expectedMate >= 0 && solution.result != Search::MateResult::Unknown) {
+            bool match = solution.mateLength == puzzle.expectedMate;
+            expected = match ? "ok" : "MISMATCH";
+            matching += match;
+            checked++;
+        }
+
+        std::string line;
+        for (auto& move : solution.line)
+            line += MoveGeneration::MoveToString(move) + " ";
+
+        std::cout << std::left << std::setw(6) << i + 1 << std::setw(10) << ResultToString(solution.result)
+                  << std::setw(8) << solution.mateLength << std::setw(10) << expected
+                  << std::setw(12) << solution.nodes << std::setw(8) << solution.timeMs << line << std::endl;
+    }
+
+    std::cout << std::endl << solved << " / " << puzzles.size() << " solved , "
+              << matching << " / " << checked << " match the expected length" << std::endl;
+    std::cout << threads << " threads , " << totalMs << " ms , "
+              << totalNodes * 1000 / (totalMs + 1) << " nodes/sec" << std::endl;
+
+    return 0;
+}
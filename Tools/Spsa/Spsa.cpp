@@ -0,0 +1,327 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include <stdexcept>
+
+#include <Engine/FenParser/FenParser.h>
+#include <Engine/MoveGeneration/MoveGeneration.h>
+#include <Engine/MoveGeneration/RandomMove.h>
+#include <Engine/Search/Search.h>
+#include <Engine/Search/TunableOptions.h>
+#include <Engine/Tablebase/Tablebase.h>
+#include <Tools/Common/SelfPlay.h>
+
+using namespace ChessEngine;
+
+/* SPSA tuning of the search parameters (TunableOptions.h) by self play. Every iteration perturbs all the
+ * parameters at once in a random direction , plays game pairs between the two sides of the perturbation on
+ * all threads and moves the parameters toward the side that scored better. The state is written to the
+ * checkpoint file after every iteration and a run started with an existing checkpoint resumes from it. */
+
+// Random moves played after the opening so pairs with the same parameters don't repeat games.
+constexpr int randomPlies = 6;
+constexpr size_t tableMegabytes = 8;
+
+struct SpsaOptions {
+    int iterations = 1000;
+    int pairs = 1; // Game pairs per iteration.
+    int threads = 1;
+    uint64_t nodesPerMove = 5000;
+    int64_t msPerMove = 0; // Used instead of the node limit when set.
+    std::string tablebases; // Directory of tablebases both sides probe.
+
+    // Usual SPSA schedule , the step of a parameter shrinks to its TunableOption::step at the last iteration
+    // (from iterations^gamma times it , about twice for 1000 iterations).
+    double alpha = 0.602;
+    double gamma = 0.101;
+    double learningRate = 0.002; // Of the last iteration , in steps squared per game pair result.
+};
+
+/* The tuned values and how far the run got , what the checkpoint holds. */
+struct SpsaState {
+    int iteration = 0; // Completed iterations.
+    std::vector<double> values;
+};
+
+/*******************************************************/
+/* Checkpoint                                          */
+/*******************************************************/
+
+static bool LoadCheckpoint(const std::string& path, SpsaState& state) {
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        std::string name;
+        double value;
+        if (!(stream >> name >> value))
+            continue;
+
+        if (name == "iteration") {
+            state.iteration = (int) value;
+            continue;
+        }
+
+        auto& options = Search::GetTunableOptions();
+        const Search::TunableOption* option = Search::FindTunableOption(name);
+        if (option)
+            state.values[option - options.data()] = value;
+        else
+            std::cout << "Unknown option " << name << " in " << path << std::endl;
+    }
+    return true;
+}
+
+/* Written next to the checkpoint and renamed over it , an interrupted write leaves the old one. */
+static bool SaveCheckpoint(const std::string& path, const SpsaState& state) {
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file)
+            return false;
+
+        file << "iteration " << state.iteration << std::endl;
+        auto& options = Search::GetTunableOptions();
+        for (size_t i = 0; i < options.size(); i++)
+            file << options[i].name << " " << std::setprecision(10) << state.values[i] << std::endl;
+        if (!file)
+            return false;
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+/*******************************************************/
+/* Games                                               */
+/*******************************************************/
+
+static Search::PruningOptions ToPruningOptions(const std::vector<double>& values) {
+    Search::PruningOptions pruning;
+    auto& options = Search::GetTunableOptions();
+    for (size_t i = 0; i < options.size(); i++)
+        Search::SetTunableOption(pruning, options[i].name, (int) std::lround(values[i]));
+    return pruning;
+}
+
+/* An opening followed by a few random moves , false when they end the game. */
+static bool GetStartPosition(uint64_t seed, BoardState& start) {
+    BoardState opening = {};
+    ParseFenString(SelfPlay::openings[seed % SelfPlay::openings.size()], opening);
+
+    Board board(opening);
+    for (int ply = 0; ply < randomPlies; ply++) {
+        auto& state = board.GetState();
+        MoveGeneration::Move move;
+        if (!MoveGeneration::GetRandomMove(state, state.turnOf, board.GetOccupancies(), seed, move))
+            return false;
+        MoveGeneration::MakeMove(move, state.turnOf, state, board.GetOccupancies());
+    }
+
+    start = board.GetState();
+    return true;
+}
+
+/* 1 when white wins , 0 for a draw and -1 when black wins. */
+static int PlayGame(const BoardState& start, const Search::PruningOptions& white, const Search::PruningOptions& black,
+                    const SpsaOptions& options) {
+    Search::TranspositionTable tables[2] = {Search::TranspositionTable(tableMegabytes), Search::TranspositionTable(tableMegabytes)};
+
+    Search::SearchLimits limits;
+    if (options.msPerMove > 0) {
+        limits.time.remainingMs = options.msPerMove;
+        limits.time.movesToGo = 1;
+    } else {
+        limits.nodes = options.nodesPerMove;
+    }
+
+    SelfPlay::Result result = SelfPlay::PlayGame(start, [&](const Board& board, const KeyHistory& history) {
+        limits.history = history;
+        Color turnOf = board.GetState().turnOf;
+        const Search::PruningOptions& pruning = (turnOf == Color::White) ? white : black;
+        return Search::Search(board, limits, pruning, tables[turnOf]).bestMove;
+    });
+
+    if (result == SelfPlay::Result::Draw)
+        return 0;
+    return result == SelfPlay::Result::WhiteWins ? 1 : -1;
+}
+
+/* Games won minus games lost by the plus side over a pair , it plays both colors from the same start. */
+static int PlayPair(uint64_t seed, const Search::PruningOptions& plus, const Search::PruningOptions& minus, const SpsaOptions& options) {
+    BoardState start = {};
+    while (!GetStartPosition(seed, start))
+        seed = MoveGeneration::NextRandom(seed);
+
+    return PlayGame(start, plus, minus, options) - PlayGame(start, minus, plus, options);
+}
+
+/*******************************************************/
+/* SPSA                                                */
+/*******************************************************/
+
+/* Plays the iteration's pairs and updates the values. Returns the summed result of the plus side. */
+static int RunIteration(SpsaState& state, const SpsaOptions& options) {
+    auto& tunable = Search::GetTunableOptions();
+    int k = state.iteration + 1;
+    double stabilizer = 0.1 * options.iterations;
+
+    // Everything random in an iteration comes from its number , a resumed run plays the same games.
+    uint64_t seed = 0x9E3779B97F4A7C15ULL * (uint64_t) k;
+    std::vector<double> plusValues(tunable.size()), minusValues(tunable.size());
+    std::vector<int> directions(tunable.size());
+    std::vector<double> steps(tunable.size());
+    for (size_t i = 0; i < tunable.size(); i++) {
+        directions[i] = (MoveGeneration::NextRandom(seed) & 1) ? 1 : -1;
+        steps[i] = tunable[i].step * std::pow((double) options.iterations / k, options.gamma);
+        plusValues[i] = state.values[i] + steps[i] * directions[i];
+        minusValues[i] = state.values[i] - steps[i] * directions[i];
+    }
+
+    Search::PruningOptions plus = ToPruningOptions(plusValues);
+    Search::PruningOptions minus = ToPruningOptions(minusValues);
+
+    std::vector<int> results(options.pairs);
+    std::atomic<int> nextPair = 0;
+    auto worker = [&]() {
+        for (int pair = nextPair++; pair < options.pairs; pair = nextPair++)
+            results[pair] = PlayPair(seed + 0x632BE59BD9B4E019ULL * (uint64_t) (pair + 1), plus, minus, options);
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < std::min(options.threads, options.pairs); i++)
+        workers.emplace_back(worker);
+    for (auto& thread : workers)
+        thread.join();
+
+    int result = 0;
+    for (int pairResult : results)
+        result += pairResult;
+
+    // a_k / c_k^2 , scaled so the last iteration moves learningRate * step^2 per unit of result.
+    double rate = options.learningRate * std::pow((stabilizer + options.iterations) / (stabilizer + k), options.alpha);
+    for (size_t i = 0; i < tunable.size(); i++) {
+        double lastStep = tunable[i].step;
+        double value = state.values[i] + rate * lastStep * lastStep / steps[i] * result * directions[i];
+        state.values[i] = std::clamp(value, (double) tunable[i].min, (double) tunable[i].max);
+    }
+
+    state.iteration = k;
+    return result;
+}
+
+static void PrintValues(const SpsaState& state) {
+    auto& tunable = Search::GetTunableOptions();
+    for (size_t i = 0; i < tunable.size(); i++)
+        std::cout << "    " << std::left << std::setw(28) << tunable[i].name << std::fixed << std::setprecision(2)
+                  << state.values[i] << std::endl;
+}
+
+/* The whole of value as a number , throws std::invalid_argument otherwise. */
+template<typename T>
+static T ParseValue(const std::string& value) {
+    std::istringstream stream(value);
+    T number;
+    if (!(stream >> number) || !stream.eof())
+        throw std::invalid_argument(value);
+    return number;
+}
+
+static void PrintUsage() {
+    std::cout << "Usage : Spsa <checkpoint file> [--iterations n] [--pairs n] [--threads n] [--nodes n] [--ms n] [--rate r] [--tablebases directory]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        PrintUsage();
+        return -1;
+    }
+
+    std::string checkpointPath = argv[1];
+    SpsaOptions options;
+    options.threads = (int) std::max(std::thread::hardware_concurrency(), 1u);
+    options.pairs = options.threads;
+    for (int i = 2; i < argc; i += 2) {
+        std::string argument = argv[i];
+        if (i + 1 >= argc) {
+            std::cout << "Missing the value of " << argument << std::endl;
+            PrintUsage();
+            return -1;
+        }
+
+        std::string value = argv[i + 1];
+        try {
+            if (argument == "--iterations")
+                options.iterations = std::max(ParseValue<int>(value), 1);
+            else if (argument == "--pairs")
+                options.pairs = std::max(ParseValue<int>(value), 1);
+            else if (argument == "--threads")
+                options.threads = std::max(ParseValue<int>(value), 1);
+            else if (argument == "--nodes")
+                options.nodesPerMove = ParseValue<uint64_t>(value);
+            else if (argument == "--ms")
+                options.msPerMove = ParseValue<int64_t>(value);
+            else if (argument == "--rate")
+                options.learningRate = ParseValue<double>(value);
+            else if (argument == "--tablebases")
+                options.tablebases = value;
+            else
+                std::cout << "Unknown argument " << argument << std::endl;
+        } catch (const std::invalid_argument&) {
+            std::cout << "Incorrect value " << value << " for " << argument << std::endl;
+            PrintUsage();
+            return -1;
+        }
+    }
+
+    ChessEngine::Init();
+    if (!options.tablebases.empty())
+        std::cout << Tablebase::LoadTables(options.tablebases) << " tablebases loaded" << std::endl;
+
+    // Start from the engine's defaults , or from the checkpoint.
+    SpsaState state;
+    Search::PruningOptions defaults;
+    for (auto& option : Search::GetTunableOptions())
+        state.values.push_back(defaults.*(option.field));
+
+    if (LoadCheckpoint(checkpointPath, state))
+        std::cout << "Resuming from " << checkpointPath << " after iteration " << state.iteration << std::endl;
+
+    std::cout << options.pairs << " game pairs per iteration on " << options.threads << " threads , ";
+    if (options.msPerMove > 0)
+        std::cout << options.msPerMove << " ms per move" << std::endl;
+    else
+        std::cout << options.nodesPerMove << " nodes per move" << std::endl;
+    PrintValues(state);
+
+    auto start = std::chrono::steady_clock::now();
+    int games = 0;
+    while (state.iteration < options.iterations) {
+        int result = RunIteration(state, options);
+        games += 2 * options.pairs;
+
+        if (!SaveCheckpoint(checkpointPath, state)) {
+            std::cout << "Could not write " << checkpointPath << std::endl;
+            return -1;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
+        std::cout << "iteration " << state.iteration << " : " << std::showpos << result << std::noshowpos
+                  << " , " << std::fixed << std::setprecision(2) << games * 1000.0 / (double) (ms + 1) << " games/sec" << std::endl;
+        if (state.iteration % 10 == 0 || state.iteration == options.iterations)
+            PrintValues(state);
+    }
+
+    return 0;
+}
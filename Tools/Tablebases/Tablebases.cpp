@@ -0,0 +1,578 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+
+#include <Engine/MoveGeneration/MoveGeneration.h>
+#include <Engine/MoveGeneration/MoveTables.h>
+#include <Engine/MoveGeneration/Draw.h>
+#include <Engine/Evaluation/Material.h>
+#include <Engine/Tablebase/Tablebase.h>
+
+using namespace ChessEngine;
+using namespace ChessEngine::BitboardUtil;
+
+/* Generates the distance to mate tablebases of material signatures (see Engine/Tablebase). Every
+ * position is first classified from its moves : mates , stalemates and the moves that capture or
+ * promote , whose results come from the smaller tables. Then results spread backwards one ply per
+ * pass by un-making moves , a loss makes its predecessors wins and a predecessor whose every move
+ * reaches a win for the opponent is lost. The smaller tables are generated first when missing.
+ *
+ * En passant isn't part of the tables , a position right after a double push the opponent can take en
+ * passant is solved alongside them (see Generator) but isn't stored. */
+
+constexpr uint8_t unknownResult = 255;
+constexpr uint8_t invalidResult = 254;
+
+// Indices handed out to a thread at a time.
+constexpr uint64_t chunkSize = 1 << 14;
+
+template<typename Function>
+static void RunChunks(uint64_t size, int threads, Function function) {
+    std::atomic<uint64_t> next = 0;
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back([&]() {
+            for (uint64_t begin = next.fetch_add(chunkSize); begin < size; begin = next.fetch_add(chunkSize))
+                function(begin, std::min(begin + chunkSize, size));
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+}
+
+/*******************************************************/
+/* Signatures                                          */
+/*******************************************************/
+
+/* The side with more pieces (or the stronger ones) first , the order the files are named in. */
+static Tablebase::Signature Normalize(const Tablebase::Signature& signature) {
+    std::string name = Tablebase::SignatureToString(signature);
+    size_t separator = name.find('v');
+    std::string first = name.substr(0, separator);
+    std::string second = name.substr(separator + 1);
+
+    static const std::string strength = "KQRBNP";
+    auto stronger = [](const std::string& a, const std::string& b) {
+        if (a.size() != b.size())
+            return a.size() > b.size();
+        for (size_t i = 0; i < a.size(); i++)
+            if (a[i] != b[i])
+                return strength.find(a[i]) < strength.find(b[i]);
+        return false;
+    };
+
+    if (stronger(second, first))
+        return {{signature.pieces[1], signature.pieces[0]}};
+    return signature;
+}
+
+/* Neither side can mate , no table needed. */
+static bool IsTrivial(const Tablebase::Signature& signature) {
+    int pieces = (int) (signature.pieces[0].size() + signature.pieces[1].size()) - 2;
+    if (pieces == 0)
+        return true;
+    if (pieces > 1)
+        return false;
+
+    auto& side = signature.pieces[0].size() > 1 ? signature.pieces[0] : signature.pieces[1];
+    return side[1] == PieceType::Bishop || side[1] == PieceType::Knight;
+}
+
+/* The materials a capture or a promotion of this one leads to. */
+static std::vector<Tablebase::Signature> GetDependencies(const Tablebase::Signature& signature) {
+    std::vector<Tablebase::Signature> dependencies;
+    auto add = [&](Tablebase::Signature dependency) {
+        // Parsed again to put a promoted piece in its place.
+        Tablebase::ParseSignature(Tablebase::SignatureToString(dependency), dependency);
+        dependency = Normalize(dependency);
+        if (IsTrivial(dependency))
+            return;
+        for (auto& known : dependencies)
+            if (Tablebase::SignatureToString(known) == Tablebase::SignatureToString(dependency))
+                return;
+        dependencies.push_back(dependency);
+    };
+
+    for (int side = 0; side < 2; side++) {
+        auto& own = signature.pieces[side];
+        auto& other = signature.pieces[1 - side];
+
+        for (size_t i = 1; i < own.size(); i++) {
+            // Captured.
+            Tablebase::Signature captured = signature;
+            captured.pieces[side].erase(captured.pieces[side].begin() + (long) i);
+            add(captured);
+
+            if (own[i] != PieceType::Pawn)
+                continue;
+
+            // Promoted , with or without a capture.
+            for (PieceType promotion : {PieceType::Queen, PieceType::Rook, PieceType::Bishop, PieceType::Knight}) {
+                Tablebase::Signature promoted = signature;
+                promoted.pieces[side][i] = promotion;
+                add(promoted);
+
+                for (size_t j = 1; j < other.size(); j++) {
+                    Tablebase::Signature both = promoted;
+                    both.pieces[1 - side].erase(both.pieces[1 - side].begin() + (long) j);
+                    add(both);
+                }
+            }
+        }
+    }
+
+    return dependencies;
+}
+
+/*******************************************************/
+/* Positions                                           */
+/*******************************************************/
+
+static BoardState MakeState(const Tablebase::TableIndex& index, const uint8_t* squares, Color turnOf) {
+    BoardState state = {};
+    for (int i = 0; i < index.GetPieceCount(); i++) {
+        Bitboard& board = state.pieceBoards[index.GetColor(i)][index.GetType(i)];
+        board = SetBit(board, squares[i]);
+    }
+    state.turnOf = turnOf;
+    state.materialKey = Evaluation::GetMaterialKey(state);
+    return state;
+}
+
+static bool IsAttacked(const Tablebase::TableIndex& index, const uint8_t* squares, uint8_t target, Color by) {
+    using namespace MoveGeneration::MoveTables;
+
+    Bitboard occupied = BITBOARD_EMPTY;
+    for (int i = 0; i < index.GetPieceCount(); i++)
+        occupied = SetBit(occupied, squares[i]);
+
+    for (int i = 0; i < index.GetPieceCount(); i++) {
+        if (index.GetColor(i) != by)
+            continue;
+
+        Bitboard attacks = BITBOARD_EMPTY;
+        switch (index.GetType(i)) {
+            case PieceType::King: attacks = GetKingMoves(squares[i]); break;
+            case PieceType::Queen: attacks = GetQueenMoves(squares[i], occupied); break;
+            case PieceType::Rook: attacks = GetRookMoves(squares[i], occupied); break;
+            case PieceType::Bishop: attacks = GetBishopMoves(squares[i], occupied); break;
+            case PieceType::Knight: attacks = GetKnightMoves(squares[i]); break;
+            case PieceType::Pawn: attacks = GetPawnAttacks(by, squares[i]); break;
+            default: break;
+        }
+        if (GetBit(attacks, target))
+            return true;
+    }
+    return false;
+}
+
+/* Squares the piece could have come from without a capture or a promotion. */
+static Bitboard GetOrigins(const Tablebase::TableIndex& index, const uint8_t* squares, int piece) {
+    using namespace MoveGeneration::MoveTables;
+
+    Bitboard occupied = BITBOARD_EMPTY;
+    for (int i = 0; i < index.GetPieceCount(); i++)
+        occupied = SetBit(occupied, squares[i]);
+
+    uint8_t square = squares[piece];
+    Color color = index.GetColor(piece);
+    switch (index.GetType(piece)) {
+        case PieceType::King: return GetKingMoves(square) & ~occupied;
+        case PieceType::Queen: return GetQueenMoves(square, occupied) & ~occupied;
+        case PieceType::Rook: return GetRookMoves(square, occupied) & ~occupied;
+        case PieceType::Bishop: return GetBishopMoves(square, occupied) & ~occupied;
+        case PieceType::Knight: return GetKnightMoves(square) & ~occupied;
+        default: break;
+    }
+
+    // Pawns come from behind , a step or a double step from their first rank.
+    int back = (color == Color::White) ? -8 : 8;
+    int from = square + back;
+    Rank doubleRank = (color == Color::White) ? Rank::R4 : Rank::R5;
+    if (GetBit(occupied, from))
+        return BITBOARD_EMPTY;
+
+    Bitboard origins = BITBOARD_EMPTY;
+    int fromRank = from / 8;
+    if ((color == Color::White) ? fromRank >= Rank::R2 : fromRank <= Rank::R7)
+        origins = SetBit(origins, from);
+    if (square / 8 == doubleRank && !GetBit(occupied, from + back))
+        origins = SetBit(origins, from + back);
+    return origins;
+}
+
+/* The en passant square of a position whose last move was a double push , if its pawn could have made one.
+ * Pawns on both sides leave no room for a second pawn (4 pieces at most) , the pushed pawn is the only one. */
+static Bitboard GetEnPassantBoard(const Tablebase::TableIndex& index, const uint8_t* squares, Color turnOf) {
+    Color mover = InvertColor(turnOf);
+    int back = (mover == Color::White) ? -8 : 8;
+    Rank doubleRank = (mover == Color::White) ? Rank::R4 : Rank::R5;
+
+    Bitboard occupied = BITBOARD_EMPTY;
+    for (int i = 0; i < index.GetPieceCount(); i++)
+        occupied = SetBit(occupied, squares[i]);
+
+    for (int i = 0; i < index.GetPieceCount(); i++) {
+        if (index.GetType(i) != PieceType::Pawn || index.GetColor(i) != mover || squares[i] / 8 != doubleRank)
+            continue;
+        if (!GetBit(occupied, squares[i] + back) && !GetBit(occupied, squares[i] + 2 * back))
+            return SetBit(BITBOARD_EMPTY, squares[i] + back);
+    }
+    return BITBOARD_EMPTY;
+}
+
+static bool HasEnPassantCapture(const std::list<MoveGeneration::Move>& moves) {
+    using namespace MoveGeneration;
+
+    return std::any_of(moves.begin(), moves.end(), [](const Move& move) {
+        return IsMoveType(move.flags, MoveType::EnPassant) && IsMoveType(move.flags, MoveType::Capture);
+    });
+}
+
+/*******************************************************/
+/* Generation                                          */
+/*******************************************************/
+
+struct GeneratorStats {
+    uint64_t wins = 0;
+    uint64_t losses = 0;
+    uint64_t draws = 0;
+    int longestMate = 0;
+};
+
+/* Nodes from the table's size on are its positions with an en passant capture available , reached by the double
+ * pushes that allow one. They take part in the passes like the others but only the table's own are saved. */
+class Generator {
+public:
+    Generator(const Tablebase::Signature& signature, int threads)
+        : index(signature), threads(threads), size(index.GetSize()), results(2 * size), counters(2 * size),
+          exitWins(2 * size), exitLosses(2 * size), drawExits(2 * size) {}
+
+    bool Run(std::vector<uint8_t>& entries, GeneratorStats& stats) {
+        std::atomic<bool> failed = false;
+        RunChunks(2 * size, threads, [&](uint64_t begin, uint64_t end) {
+            for (uint64_t i = begin; i < end; i++)
+                if (!Classify(i))
+                    failed = true;
+        });
+        if (failed)
+            return false;
+
+        // Pass n settles the positions n plies from mate and sets up the ones n + 1 plies away.
+        for (int distance = 0; distance <= maxPending && distance < Tablebase::maxDistance; distance++) {
+            // Wins come in odd plies , the ones through captures and promotions settle first.
+            uint8_t entry = Tablebase::EncodeEntry({Tablebase::Outcome::Win, distance});
+            if (distance % 2 == 1) {
+                RunChunks(2 * size, threads, [&](uint64_t begin, uint64_t end) {
+                    for (uint64_t i = begin; i < end; i++) {
+                        if (results[i].load(std::memory_order_relaxed) == unknownResult && exitWins[i] == distance)
+                            results[i].store(entry, std::memory_order_relaxed);
+                    }
+                });
+            }
+
+            RunChunks(2 * size, threads, [&](uint64_t begin, uint64_t end) {
+                for (uint64_t i = begin; i < end; i++)
+                    if (results[i].load(std::memory_order_relaxed) == entry)
+                        Propagate(i, distance);
+            });
+        }
+
+        if (maxPending >= Tablebase::maxDistance) {
+            std::cout << "A mate is longer than " << Tablebase::maxDistance << " plies" << std::endl;
+            return false;
+        }
+
+        // Nothing forced a result , a draw.
+        entries.assign(size, Tablebase::drawEntry);
+        for (uint64_t i = 0; i < size; i++) {
+            uint8_t result = results[i].load(std::memory_order_relaxed);
+            if (result == invalidResult)
+                continue;
+
+            if (result != unknownResult)
+                entries[i] = result;
+
+            Tablebase::ProbeResult decoded = Tablebase::DecodeEntry(entries[i]);
+            if (decoded.outcome == Tablebase::Outcome::Win)
+                stats.wins++;
+            else if (decoded.outcome == Tablebase::Outcome::Loss)
+                stats.losses++;
+            else
+                stats.draws++;
+            stats.longestMate = std::max(stats.longestMate, decoded.distance);
+        }
+        return true;
+    }
+
+private:
+    void RaisePending(int distance) {
+        int pending = maxPending.load(std::memory_order_relaxed);
+        while (distance > pending && !maxPending.compare_exchange_weak(pending, distance, std::memory_order_relaxed)) {}
+    }
+
+    /* The result from the position alone , or what its captures and promotions lead to. */
+    bool Classify(uint64_t i) {
+        using namespace MoveGeneration;
+
+        results[i].store(invalidResult, std::memory_order_relaxed);
+
+        bool enPassant = i >= size;
+        uint8_t squares[Tablebase::maxPieces];
+        Color turnOf;
+        if (!index.GetPosition(enPassant ? i - size : i, squares, turnOf))
+            return true;
+
+        BoardState state = MakeState(index, squares, turnOf);
+        if (enPassant) {
+            state.enPassantBoard = GetEnPassantBoard(index, squares, turnOf);
+            if (state.enPassantBoard == BITBOARD_EMPTY)
+                return true;
+        }
+
+        BoardOccupancies occupancies(state);
+        if (NumberOfChecks(InvertColor(turnOf), state, occupancies) > 0)
+            return true; // The side that just moved is in check.
+
+        auto moves = GetValidMoves(state, turnOf, occupancies);
+        if (enPassant && !HasEnPassantCapture(moves))
+            return true; // The double push leads to the table's position.
+
+        if (moves.empty()) {
+            bool mated = NumberOfChecks(turnOf, state, occupancies) > 0;
+            results[i].store(mated ? Tablebase::EncodeEntry({Tablebase::Outcome::Loss, 0}) : Tablebase::drawEntry,
+                             std::memory_order_relaxed);
+            return true;
+        }
+
+        uint64_t children[256];
+        int childCount = 0;
+        int bestWin = 0;
+        int worstLoss = 0;
+        bool drawExit = false;
+        for (auto& move : moves) {
+            if (!IsMoveType(move.flags, MoveType::Capture) && !IsMoveType(move.flags, MoveType::Promotion)) {
+                uint8_t childSquares[Tablebase::maxPieces];
+                for (int piece = 0; piece < index.GetPieceCount(); piece++)
+                    childSquares[piece] = (squares[piece] == move.fromSquareIndex) ? move.toSquareIndex : squares[piece];
+                uint64_t child = index.GetIndex(childSquares, InvertColor(turnOf));
+
+                // A double push the opponent can take en passant.
+                if (IsMoveType(move.flags, MoveType::EnPassant)) {
+                    BoardState pushed = state;
+                    BoardOccupancies pushedOccupancies = occupancies;
+                    MakeMove(move, turnOf, pushed, pushedOccupancies);
+                    if (HasEnPassantCapture(GetValidMoves(pushed, pushed.turnOf, pushedOccupancies)))
+                        child += size;
+                }
+
+                children[childCount++] = child;
+                continue;
+            }
+
+            BoardState child = state;
+            BoardOccupancies childOccupancies = occupancies;
+            MakeMove(move, turnOf, child, childOccupancies);
+
+            Tablebase::ProbeResult result;
+            if (!Draw::InsufficientMaterial(child) && !Tablebase::Probe(child, result)) {
+                std::cout << "Missing the table of a capture or promotion" << std::endl;
+                return false;
+            }
+
+            if (result.outcome == Tablebase::Outcome::Loss)
+                bestWin = (bestWin == 0) ? result.distance + 1 : std::min(bestWin, result.distance + 1);
+            else if (result.outcome == Tablebase::Outcome::Win)
+                worstLoss = std::max(worstLoss, result.distance + 1);
+            else
+                drawExit = true;
+        }
+
+        std::sort(children, children + childCount);
+        childCount = (int) (std::unique(children, children + childCount) - children);
+
+        exitWins[i] = (uint8_t) bestWin;
+        exitLosses[i] = (uint8_t) worstLoss;
+        drawExits[i] = drawExit;
+        counters[i].store((uint8_t) childCount, std::memory_order_relaxed);
+        results[i].store(unknownResult, std::memory_order_relaxed);
+        RaisePending(std::max(bestWin, worstLoss));
+
+        if (childCount == 0 && bestWin == 0)
+            Resolve(i, 0);
+        return true;
+    }
+
+    /* Every move of an unresolved position reaches a win for the opponent (or leaves the table). */
+    void Resolve(uint64_t i, int distance) {
+        if (exitWins[i] != 0)
+            return; // Settled when its pass comes.
+
+        if (drawExits[i]) {
+            results[i].store(Tablebase::drawEntry, std::memory_order_relaxed);
+            return;
+        }
+
+        int lossDistance = std::max(distance, (int) exitLosses[i]);
+        results[i].store(Tablebase::EncodeEntry({Tablebase::Outcome::Loss, lossDistance}), std::memory_order_relaxed);
+        RaisePending(lossDistance);
+    }
+
+    /* Un-makes the moves leading to position i , distance plies from mate. */
+    void Propagate(uint64_t i, int distance) {
+        bool enPassant = i >= size;
+        uint64_t position = enPassant ? i - size : i;
+        uint8_t squares[Tablebase::maxPieces];
+        Color turnOf;
+        index.GetPosition(position, squares, turnOf);
+        Color mover = InvertColor(turnOf);
+        bool lost = distance % 2 == 0;
+
+        // Only the double pushes reach the en passant node , and then they don't reach the table's position.
+        bool hasEnPassantNode = results[position + size].load(std::memory_order_relaxed) != invalidResult;
+
+        uint8_t ourKing = squares[0];
+        for (int piece = 0; piece < index.GetPieceCount(); piece++) {
+            if (index.GetType(piece) == PieceType::King && index.GetColor(piece) == turnOf)
+                ourKing = squares[piece];
+        }
+
+        uint64_t parents[256];
+        int parentCount = 0;
+        for (int piece = 0; piece < index.GetPieceCount(); piece++) {
+            if (index.GetColor(piece) != mover)
+                continue;
+
+            for (Bitboard origins = GetOrigins(index, squares, piece); origins != 0; origins &= origins - 1) {
+                uint8_t origin = GetLSBIndex(origins);
+                bool doublePush = index.GetType(piece) == PieceType::Pawn && std::abs(origin - squares[piece]) == 16;
+                if (enPassant ? !doublePush : (doublePush && hasEnPassantNode))
+                    continue;
+
+                uint8_t parentSquares[Tablebase::maxPieces];
+                std::copy(squares, squares + index.GetPieceCount(), parentSquares);
+                parentSquares[piece] = origin;
+
+                // The side to move here can't have been in check before the move.
+                if (IsAttacked(index, parentSquares, ourKing, mover))
+                    continue;
+
+                // The parent with an en passant capture available has the same move.
+                uint64_t parent = index.GetIndex(parentSquares, mover);
+                parents[parentCount++] = parent;
+                if (results[parent + size].load(std::memory_order_relaxed) != invalidResult)
+                    parents[parentCount++] = parent + size;
+            }
+        }
+
+        std::sort(parents, parents + parentCount);
+        parentCount = (int) (std::unique(parents, parents + parentCount) - parents);
+
+        for (int p = 0; p < parentCount; p++) {
+            uint64_t parent = parents[p];
+            if (lost) {
+                uint8_t expected = unknownResult;
+                uint8_t win = Tablebase::EncodeEntry({Tablebase::Outcome::Win, distance + 1});
+                if (results[parent].compare_exchange_strong(expected, win, std::memory_order_relaxed))
+                    RaisePending(distance + 1);
+            } else if (results[parent].load(std::memory_order_relaxed) == unknownResult &&
+                       counters[parent].fetch_sub(1, std::memory_order_relaxed) == 1) {
+                Resolve(parent, distance + 1);
+            }
+        }
+    }
+
+    Tablebase::TableIndex index;
+    int threads;
+    uint64_t size; // Positions in the table , the en passant nodes follow.
+
+    std::vector<std::atomic<uint8_t>> results;
+    std::vector<std::atomic<uint8_t>> counters; // Moves staying in the table not yet known to lose.
+    std::vector<uint8_t> exitWins; // Shortest win through a capture or promotion , 0 without one.
+    std::vector<uint8_t> exitLosses; // Longest loss through one.
+    std::vector<uint8_t> drawExits; // Not a vector of bool , threads write neighbouring entries.
+    std::atomic<int> maxPending = 0; // Largest distance assigned so far.
+};
+
+static bool Generate(const std::string& directory, const Tablebase::Signature& signature, int threads) {
+    std::string name = Tablebase::SignatureToString(signature);
+    std::string path = Tablebase::GetTablePath(directory, signature);
+    if (std::filesystem::exists(path))
+        return true;
+
+    for (auto& dependency : GetDependencies(signature)) {
+        if (!Generate(directory, dependency, threads))
+            return false;
+    }
+
+    // The tables generated so far , for the captures and promotions.
+    Tablebase::UnloadTables();
+    Tablebase::LoadTables(directory);
+
+    auto start = std::chrono::steady_clock::now();
+    Generator generator(signature, threads);
+    std::vector<uint8_t> entries;
+    GeneratorStats stats;
+    if (!generator.Run(entries, stats)) {
+        std::cout << "Could not generate " << name << std::endl;
+        return false;
+    }
+
+    if (!Tablebase::SaveTable(path, signature, entries)) {
+        std::cout << "Could not write " << path << std::endl;
+        return false;
+    }
+
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << " : " << entries.size() << " positions , " << stats.wins << " wins , " << stats.losses
+              << " losses , " << stats.draws << " draws , longest mate " << stats.longestMate << " plies , "
+              << ms << " ms" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cout << "Usage : Tablebases <directory> <signature , eg: KRvK>... [--threads n]" << std::endl;
+        return -1;
+    }
+
+    std::string directory = argv[1];
+    int threads = (int) std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<Tablebase::Signature> signatures;
+    for (int i = 2; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--threads" && i + 1 < argc) {
+            threads = std::max(std::stoi(argv[++i]), 1);
+            continue;
+        }
+
+        Tablebase::Signature signature;
+        if (!Tablebase::ParseSignature(argument, signature)) {
+            std::cout << "Incorrect signature " << argument << " , at most " << Tablebase::maxPieces << " pieces" << std::endl;
+            return -1;
+        }
+        signatures.push_back(Normalize(signature));
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    ChessEngine::Init();
+
+    for (auto& signature : signatures) {
+        if (IsTrivial(signature)) {
+            std::cout << Tablebase::SignatureToString(signature) << " is always a draw" << std::endl;
+            continue;
+        }
+        if (!Generate(directory, signature, threads))
+            return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,312 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+#include <Engine/FenParser/FenParser.h>
+#include <Engine/Search/Search.h>
+#include <Engine/Search/ParallelSearch.h>
+#include <Engine/Search/SearchTrace.h>
+
+using namespace ChessEngine;
+using namespace ChessEngine::Search;
+
+/* Reads the search traces of Engine/Search/SearchTrace.h. Records come in post order , so a node
+ * arriving takes the records on the stack one level deeper as its children. Only the completed
+ * roots keep their children , the rest of the tree is summed up as it is read.
+ *
+ * With --search the tool first searches a position with tracing on , which needs an engine built
+ * with ENGINE_SEARCH_TRACE. */
+
+struct TraceNode {
+    TraceRecord record;
+    uint64_t size = 1; // Nodes of the subtree , split tasks apart.
+};
+
+struct TraceRoot {
+    TraceNode node;
+    std::vector<TraceNode> children;
+};
+
+struct PlyCounts {
+    uint64_t nodes = 0;
+    uint64_t types[3] = {};
+    uint64_t quiescence = 0;
+    uint64_t reduced = 0;
+};
+
+struct TraceSummary {
+    uint32_t threadIndex = 0;
+    uint64_t records = 0;
+
+    std::vector<TraceRoot> roots;
+    std::vector<PlyCounts> plies = std::vector<PlyCounts>(256);
+
+    uint64_t nullMoves = 0;
+    uint64_t stopped = 0;
+    uint64_t tasks = 0; // Split task subtrees (ParallelSearch).
+    uint64_t taskNodes = 0;
+};
+
+static std::string PackedMoveToString(uint16_t move) {
+    if (move == 0)
+        return "-";
+
+    int from = move & 63, to = (move >> 6) & 63, promotion = move >> 12;
+    std::string text = {(char) ('a' + from % 8), (char) ('1' + from / 8), (char) ('a' + to % 8), (char) ('1' + to / 8)};
+    if (promotion != 0)
+        text += PieceTypeToChar((PieceType) promotion, Color::Black); // Lower case.
+    return text;
+}
+
+/* flip for the parent's point of view , a child failing high fails low for its parent. */
+static std::string TypeToString(uint8_t flags, bool flip = false) {
+    switch ((TraceNodeType) (flags & TraceFlags::TypeMask)) {
+        case TraceNodeType::Pv: return "pv";
+        case TraceNodeType::Cut: return flip ? "all" : "cut";
+        default: return flip ? "cut" : "all";
+    }
+}
+
+static bool ReadTrace(const std::string& path, TraceSummary& summary) {
+    std::ifstream file(path, std::ios::binary);
+    char header[traceHeaderSize] = {};
+    uint32_t version = 0;
+    if (!file.read(header, traceHeaderSize) || std::memcmp(header, traceMagic, sizeof(traceMagic)) != 0)
+        return false;
+    std::memcpy(&version, header + 8, sizeof(version));
+    std::memcpy(&summary.threadIndex, header + 12, sizeof(summary.threadIndex));
+    if (version != traceVersion)
+        return false;
+
+    std::vector<TraceNode> stack;
+    std::vector<TraceRecord> records(1 << 16);
+    while (file) {
+        file.read((char*) records.data(), (std::streamsize) (records.size() * sizeof(TraceRecord)));
+        size_t count = (size_t) file.gcount() / sizeof(TraceRecord);
+
+        for (size_t i = 0; i < count; i++) {
+            const TraceRecord& record = records[i];
+            TraceNode node{record};
+            bool isRoot = record.level == 0 && !(record.flags & TraceFlags::Task);
+            TraceRoot root;
+
+            // The children are on top of the stack , in the order they were searched.
+            size_t first = stack.size();
+            while (first > 0 && stack[first - 1].record.level > record.level)
+                first--;
+            for (size_t child = first; child < stack.size(); child++) {
+                if (stack[child].record.level != record.level + 1)
+                    continue; // Left by an unfinished search.
+
+                if (stack[child].record.flags & TraceFlags::Task) {
+                    summary.tasks++;
+                    summary.taskNodes += stack[child].size;
+                    continue;
+                }
+                node.size += stack[child].size;
+                if (isRoot)
+                    root.children.push_back(stack[child]);
+            }
+            stack.resize(first);
+
+            summary.records++;
+            PlyCounts& ply = summary.plies[record.ply];
+            ply.nodes++;
+            ply.types[record.flags & TraceFlags::TypeMask]++;
+            if (record.flags & TraceFlags::Quiescence)
+                ply.quiescence++;
+            if (record.reduction > 0 && !(record.flags & TraceFlags::NullMove))
+                ply.reduced++;
+            if (record.flags & TraceFlags::NullMove)
+                summary.nullMoves++;
+            if (record.flags & TraceFlags::Stopped)
+                summary.stopped++;
+
+            if (isRoot) {
+                root.node = node;
+                summary.roots.push_back(std::move(root));
+            } else if (record.level == 0) {
+                summary.tasks++; // A task a helper took , its split node is in another file.
+                summary.taskNodes += node.size;
+            } else {
+                stack.push_back(node);
+            }
+        }
+    }
+
+    return true;
+}
+
+static void PrintSummary(const std::string& path, const TraceSummary& summary, int rootIndex, int top) {
+    std::cout << std::endl << path << " , thread " << summary.threadIndex << " , " << summary.records << " nodes" << std::endl;
+    std::cout << "null moves " << summary.nullMoves << " , stopped " << summary.stopped
+              << " , split tasks " << summary.tasks << " (" << summary.taskNodes << " nodes)" << std::endl;
+
+    std::cout << std::endl << std::left << std::setw(6) << "ply"
+              << std::setw(12) << "nodes"
+              << std::setw(12) << "pv"
+              << std::setw(12) << "cut"
+              << std::setw(12) << "all"
+              << std::setw(12) << "quiescence"
+              << "reduced" << std::endl;
+    for (size_t ply = 0; ply < summary.plies.size(); ply++) {
+        const PlyCounts& counts = summary.plies[ply];
+        if (counts.nodes == 0)
+            continue;
+        std::cout << std::left << std::setw(6) << ply
+                  << std::setw(12) << counts.nodes
+                  << std::setw(12) << counts.types[(int) TraceNodeType::Pv]
+                  << std::setw(12) << counts.types[(int) TraceNodeType::Cut]
+                  << std::setw(12) << counts.types[(int) TraceNodeType::All]
+                  << std::setw(12) << counts.quiescence
+                  << counts.reduced << std::endl;
+    }
+
+    if (summary.roots.empty())
+        return;
+
+    // Every root search , an iteration (or a Multi-PV line) each.
+    std::cout << std::endl << std::left << std::setw(8) << "root"
+              << std::setw(8) << "depth"
+              << std::setw(20) << "window"
+              << std::setw(8) << "score"
+              << std::setw(8) << "type"
+              << "nodes" << std::endl;
+    for (size_t i = 0; i < summary.roots.size(); i++) {
+        const TraceRecord& record = summary.roots[i].node.record;
+        std::string window = "[" + std::to_string(record.alpha) + " , " + std::to_string(record.beta) + "]";
+        std::cout << std::left << std::setw(8) << i
+                  << std::setw(8) << (int) record.depth
+                  << std::setw(20) << window
+                  << std::setw(8) << record.score
+                  << std::setw(8) << TypeToString(record.flags)
+                  << summary.roots[i].node.size
+                  << ((record.flags & TraceFlags::Stopped) ? " (stopped)" : "") << std::endl;
+    }
+
+    // The root's moves by the size of their subtrees , re-searches of a move are separate rows.
+    if (rootIndex < 0 || rootIndex >= (int) summary.roots.size())
+        rootIndex = (int) summary.roots.size() - 1;
+    const TraceRoot& root = summary.roots[rootIndex];
+    auto children = root.children;
+    std::stable_sort(children.begin(), children.end(), [](const TraceNode& a, const TraceNode& b) {
+        return a.size > b.size;
+    });
+
+    std::cout << std::endl << "Root " << rootIndex << " , largest subtrees" << std::endl;
+    std::cout << std::left << std::setw(8) << "move"
+              << std::setw(8) << "depth"
+              << std::setw(8) << "red"
+              << std::setw(20) << "window"
+              << std::setw(8) << "score"
+              << std::setw(8) << "type"
+              << std::setw(12) << "nodes"
+              << "share" << std::endl;
+    for (int i = 0; i < (int) children.size() && i < top; i++) {
+        const TraceRecord& record = children[i].record;
+        // Scores from the root side's point of view.
+        std::string window = "[" + std::to_string(-record.beta) + " , " + std::to_string(-record.alpha) + "]";
+        double share = 100.0 * (double) children[i].size / (double) root.node.size;
+        std::cout << std::left << std::setw(8) << PackedMoveToString(record.move)
+                  << std::setw(8) << (int) record.depth
+                  << std::setw(8) << (int) record.reduction
+                  << std::setw(20) << window
+                  << std::setw(8) << -record.score
+                  << std::setw(8) << TypeToString(record.flags, true)
+                  << std::setw(12) << children[i].size
+                  << std::fixed << std::setprecision(1) << share << "%" << std::endl;
+    }
+}
+
+/* Searches the position with every node written to "<path>.<thread>" , false without tracing. */
+static bool RecordTrace(const std::string& fen, int depth, const std::string& path, int threads, std::vector<std::string>& files) {
+#ifdef ENGINE_SEARCH_TRACE
+    BoardState state = {};
+    if (!ParseFenString(fen, state)) {
+        std::cout << "Incorrect fen string " << fen << std::endl;
+        return false;
+    }
+
+    // Searches append to the files , start from empty ones.
+    for (int i = 0; i < threads; i++) {
+        files.push_back(GetTracePath(path, i));
+        std::ofstream(files.back(), std::ios::trunc);
+    }
+
+    SearchLimits limits;
+    limits.depth = depth;
+    limits.traceFile = path;
+
+    SearchResult result;
+    if (threads > 1) {
+        ParallelOptions options;
+        options.threads = threads;
+        result = ParallelSearch(Board(state), limits, {}, options);
+    } else {
+        TranspositionTable transpositionTable(16);
+        result = Search::Search(Board(state), limits, {}, transpositionTable);
+    }
+
+    std::cout << "best move " << MoveGeneration::MoveToString(result.bestMove) << " , score " << result.score
+              << " , depth " << result.depth << " , " << result.nodes << " nodes" << std::endl;
+    return true;
+#else
+    (void) fen;
+    (void) depth;
+    (void) path;
+    (void) threads;
+    (void) files;
+    std::cout << "Searching needs an engine built with ENGINE_SEARCH_TRACE" << std::endl;
+    return false;
+#endif
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage : Trace <trace file>... [--root n] [--top n]" << std::endl;
+        std::cout << "        Trace --search <fen> <depth> <trace path> [--threads n] [--root n] [--top n]" << std::endl;
+        return -1;
+    }
+
+    int rootIndex = -1; // The last one.
+    int top = 10;
+    int threads = 1;
+    std::string fen, searchPath;
+    int depth = 0;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--root" && i + 1 < argc)
+            rootIndex = std::stoi(argv[++i]);
+        else if (argument == "--top" && i + 1 < argc)
+            top = std::max(std::stoi(argv[++i]), 1);
+        else if (argument == "--threads" && i + 1 < argc)
+            threads = std::max(std::stoi(argv[++i]), 1);
+        else if (argument == "--search" && i + 3 < argc) {
+            fen = argv[++i];
+            depth = std::stoi(argv[++i]);
+            searchPath = argv[++i];
+        } else
+            files.push_back(argument);
+    }
+
+    ChessEngine::Init();
+
+    if (!searchPath.empty() && !RecordTrace(fen, depth, searchPath, threads, files))
+        return -1;
+
+    for (auto& path : files) {
+        TraceSummary summary;
+        if (!ReadTrace(path, summary)) {
+            std::cout << "Could not read the trace " << path << std::endl;
+            continue;
+        }
+        PrintSummary(path, summary, rootIndex, top);
+    }
+
+    return 0;
+}
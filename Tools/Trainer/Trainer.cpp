@@ -0,0 +1,539 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+#include <Engine/FenParser/FenParser.h>
+#include <Engine/Evaluation/Nnue.h>
+
+#if defined(__AVX2__)
+#define TRAINER_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#define TRAINER_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace ChessEngine;
+using namespace ChessEngine::Evaluation::Nnue;
+
+/* Trains the evaluation network on labeled positions , one per line : a fen followed by ";" and the score
+ * in centipawns from the side to move's point of view. The file is read in chunks so it doesn't have to fit
+ * in memory. The network is trained in floats and saved quantized after every epoch. */
+
+constexpr size_t chunkPositions = 1 << 20;
+
+// Limits that keep the quantized network inside its integer types. An accumulator is the bias
+// plus up to maxActiveFeatures rows , in int16 after scaling by activationScale.
+constexpr float maxFeatureWeight = 32767.0f / (activationScale * (maxActiveFeatures + 1));
+constexpr float maxOutputWeight = 127.0f / weightScale;
+
+struct TrainingOptions {
+    int epochs = 10;
+    int threads = 1;
+    size_t batchSize = 16384;
+    float learningRate = 0.001f;
+};
+
+/* A position as the active features of both sides , side to move first. */
+struct Sample {
+    uint16_t features[2][maxActiveFeatures];
+    uint8_t count = 0; // The same for both sides.
+    float target = 0; // Expected score of the side to move , in [0 , 1].
+};
+
+/*******************************************************/
+/* Vectors                                             */
+/*******************************************************/
+
+#if defined(TRAINER_AVX2)
+using Vector = __m256;
+constexpr int width = 8;
+static Vector Load(const float* values) { return _mm256_loadu_ps(values); }
+static void Store(float* values, Vector vector) { _mm256_storeu_ps(values, vector); }
+static Vector Set(float value) { return _mm256_set1_ps(value); }
+static Vector Add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+static Vector Sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+static Vector Mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+static Vector Div(Vector a, Vector b) { return _mm256_div_ps(a, b); }
+static Vector Min(Vector a, Vector b) { return _mm256_min_ps(a, b); }
+static Vector Max(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+static Vector Sqrt(Vector a) { return _mm256_sqrt_ps(a); }
+/* value where 0 < x < 1 (the clipped relu passes the gradient) , 0 elsewhere. */
+static Vector KeepInside(Vector x, Vector value) {
+    Vector inside = _mm256_and_ps(_mm256_cmp_ps(x, Set(0), _CMP_GT_OQ), _mm256_cmp_ps(x, Set(1), _CMP_LT_OQ));
+    return _mm256_and_ps(value, inside);
+}
+#elif defined(TRAINER_SSE2)
+using Vector = __m128;
+constexpr int width = 4;
+static Vector Load(const float* values) { return _mm_loadu_ps(values); }
+static void Store(float* values, Vector vector) { _mm_storeu_ps(values, vector); }
+static Vector Set(float value) { return _mm_set1_ps(value); }
+static Vector Add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+static Vector Sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+static Vector Mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+static Vector Div(Vector a, Vector b) { return _mm_div_ps(a, b); }
+static Vector Min(Vector a, Vector b) { return _mm_min_ps(a, b); }
+static Vector Max(Vector a, Vector b) { return _mm_max_ps(a, b); }
+static Vector Sqrt(Vector a) { return _mm_sqrt_ps(a); }
+static Vector KeepInside(Vector x, Vector value) {
+    return _mm_and_ps(value, _mm_and_ps(_mm_cmpgt_ps(x, Set(0)), _mm_cmplt_ps(x, Set(1))));
+}
+#else
+using Vector = float;
+constexpr int width = 1;
+static Vector Load(const float* values) { return *values; }
+static void Store(float* values, Vector vector) { *values = vector; }
+static Vector Set(float value) { return value; }
+static Vector Add(Vector a, Vector b) { return a + b; }
+static Vector Sub(Vector a, Vector b) { return a - b; }
+static Vector Mul(Vector a, Vector b) { return a * b; }
+static Vector Div(Vector a, Vector b) { return a / b; }
+static Vector Min(Vector a, Vector b) { return std::min(a, b); }
+static Vector Max(Vector a, Vector b) { return std::max(a, b); }
+static Vector Sqrt(Vector a) { return std::sqrt(a); }
+static Vector KeepInside(Vector x, Vector value) { return (x > 0 && x < 1) ? value : 0; }
+#endif
+
+static_assert(hiddenSize % width == 0);
+
+static float Sum(Vector vector) {
+    float lanes[width];
+    Store(lanes, vector);
+    float sum = 0;
+    for (float lane : lanes)
+        sum += lane;
+    return sum;
+}
+
+/*******************************************************/
+/* Layers                                              */
+/*******************************************************/
+
+/* The weights with their Adam moments , gradients are summed into them during a batch. */
+struct Tensor {
+    std::vector<float> values, gradients, m, v;
+
+    explicit Tensor(size_t size) : values(size), gradients(size), m(size), v(size) {}
+};
+
+struct Model {
+    Tensor featureWeights{(size_t) featureCount * hiddenSize};
+    Tensor featureBiases{hiddenSize};
+    Tensor outputWeights{2 * hiddenSize};
+    Tensor outputBias{width}; // Padded to a full vector , only the first one is used.
+};
+
+/* accumulator = biases + the rows of the active features , each block of the accumulator stays in a register. */
+static void SparseForward(const float* weights, const float* biases, const uint16_t* features, int count, float* accumulator) {
+    for (int i = 0; i < hiddenSize; i += width) {
+        Vector sum = Load(biases + i);
+        for (int j = 0; j < count; j++)
+            sum = Add(sum, Load(weights + (size_t) features[j] * hiddenSize + i));
+        Store(accumulator + i, sum);
+    }
+}
+
+static void AddRow(float* destination, const float* row) {
+    for (int i = 0; i < hiddenSize; i += width)
+        Store(destination + i, Add(Load(destination + i), Load(row + i)));
+}
+
+/* Dot product of the clipped accumulator with half of the output weights. */
+static float OutputForward(const float* accumulator, const float* weights) {
+    const Vector zero = Set(0), one = Set(1);
+    Vector sum = Set(0);
+    for (int i = 0; i < hiddenSize; i += width) {
+        Vector activations = Min(Max(Load(accumulator + i), zero), one);
+        sum = Add(sum, Mul(activations, Load(weights + i)));
+    }
+    return Sum(sum);
+}
+
+/* Given the gradient of the output , adds the gradients of half of the output weights and
+ * writes the gradient of the accumulator. */
+static void OutputBackward(const float* accumulator, const float* weights, float gradient,
+                           float* accumulatorGradients, float* weightGradients) {
+    const Vector zero = Set(0), one = Set(1), scale = Set(gradient);
+    for (int i = 0; i < hiddenSize; i += width) {
+        Vector values = Load(accumulator + i);
+        Vector activations = Min(Max(values, zero), one);
+        Store(weightGradients + i, Add(Load(weightGradients + i), Mul(scale, activations)));
+        Store(accumulatorGradients + i, KeepInside(values, Mul(scale, Load(weights + i))));
+    }
+}
+
+constexpr float beta1 = 0.9f;
+constexpr float beta2 = 0.999f;
+constexpr float epsilon = 1e-8f;
+
+/* One Adam step over size values (a multiple of width) , the step size includes the bias correction.
+ * The gradients are cleared for the next batch. */
+static void AdamUpdate(Tensor& tensor, size_t offset, size_t size, float stepSize, float limit) {
+    float* values = tensor.values.data() + offset;
+    float* gradients = tensor.gradients.data() + offset;
+    float* m = tensor.m.data() + offset;
+    float* v = tensor.v.data() + offset;
+
+    const Vector b1 = Set(beta1), b2 = Set(beta2), oneMinusB1 = Set(1 - beta1), oneMinusB2 = Set(1 - beta2);
+    const Vector step = Set(stepSize), eps = Set(epsilon), low = Set(-limit), high = Set(limit), zero = Set(0);
+    for (size_t i = 0; i < size; i += width) {
+        Vector gradient = Load(gradients + i);
+        Vector first = Add(Mul(b1, Load(m + i)), Mul(oneMinusB1, gradient));
+        Vector second = Add(Mul(b2, Load(v + i)), Mul(oneMinusB2, Mul(gradient, gradient)));
+        Vector value = Sub(Load(values + i), Div(Mul(step, first), Add(Sqrt(second), eps)));
+
+        Store(m + i, first);
+        Store(v + i, second);
+        Store(values + i, Min(Max(value, low), high));
+        Store(gradients + i, zero);
+    }
+}
+
+static float Sigmoid(float x) {
+    return 1.0f / (1.0f + std::exp(-x));
+}
+
+/* The float network's output , 1.0 is evalScale centipawns. */
+static float Forward(const Model& model, const Sample& sample, float (&accumulators)[2][hiddenSize]) {
+    for (int side = 0; side < 2; side++)
+        SparseForward(model.featureWeights.values.data(), model.featureBiases.values.data(),
+                      sample.features[side], sample.count, accumulators[side]);
+
+    const float* outputWeights = model.outputWeights.values.data();
+    return OutputForward(accumulators[0], outputWeights) + OutputForward(accumulators[1], outputWeights + hiddenSize) +
+           model.outputBias.values[0];
+}
+
+/*******************************************************/
+/* Training                                            */
+/*******************************************************/
+
+template<typename Function>
+static void RunThreads(int threads, Function function) {
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++)
+        workers.emplace_back(function, i);
+    for (auto& worker : workers)
+        worker.join();
+}
+
+/* Gradients of the small layers , summed by each thread on its own and added up after. */
+struct ThreadGradients {
+    std::vector<float> outputWeights = std::vector<float>(2 * hiddenSize);
+    std::vector<float> featureBiases = std::vector<float>(hiddenSize);
+    float outputBias = 0;
+    double loss = 0;
+};
+
+class Trainer {
+public:
+    explicit Trainer(const TrainingOptions& options)
+            : options(options), threadGradients(options.threads), touchedRows(options.threads),
+              touched(featureCount), accumulatorGradients(options.batchSize * 2 * hiddenSize)
+    {
+        std::mt19937 random(12345);
+        std::uniform_real_distribution<float> featureDistribution(-0.1f, 0.1f);
+        for (auto& weight : model.featureWeights.values)
+            weight = featureDistribution(random);
+        std::uniform_real_distribution<float> outputDistribution(-0.5f, 0.5f);
+        for (auto& weight : model.outputWeights.values)
+            weight = outputDistribution(random);
+    }
+
+    /* One Adam step on a minibatch , returns the summed squared error. */
+    double TrainBatch(const Sample* samples, size_t count) {
+        step++;
+        float stepSize = options.learningRate * std::sqrt(1 - std::pow(beta2, (float) step)) / (1 - std::pow(beta1, (float) step));
+
+        // Forward and backward pass , each thread takes a slice of the batch.
+        RunThreads(options.threads, [&](int thread) {
+            ThreadGradients& gradients = threadGradients[thread];
+            std::fill(gradients.outputWeights.begin(), gradients.outputWeights.end(), 0.0f);
+            std::fill(gradients.featureBiases.begin(), gradients.featureBiases.end(), 0.0f);
+            gradients.outputBias = 0;
+            gradients.loss = 0;
+
+            size_t first = count * thread / options.threads;
+            size_t last = count * (thread + 1) / options.threads;
+            float accumulators[2][hiddenSize];
+            for (size_t i = first; i < last; i++) {
+                float prediction = Sigmoid(Forward(model, samples[i], accumulators));
+                float error = prediction - samples[i].target;
+                gradients.loss += error * error;
+
+                // Mean squared error , through the sigmoid.
+                float gradient = 2 * error * prediction * (1 - prediction) / (float) count;
+                for (int side = 0; side < 2; side++) {
+                    float* accumulatorGradient = GetAccumulatorGradient(i, side);
+                    OutputBackward(accumulators[side], model.outputWeights.values.data() + side * hiddenSize, gradient,
+                                   accumulatorGradient, gradients.outputWeights.data() + side * hiddenSize);
+                    AddRow(gradients.featureBiases.data(), accumulatorGradient);
+                }
+                gradients.outputBias += gradient;
+            }
+        });
+
+        // The feature rows , each thread owns the rows with index % threads == thread. Only rows of
+        // features seen in the batch get a step (sparse Adam).
+        RunThreads(options.threads, [&](int thread) {
+            std::vector<int>& rows = touchedRows[thread];
+            for (size_t i = 0; i < count; i++) {
+                for (int side = 0; side < 2; side++) {
+                    for (int j = 0; j < samples[i].count; j++) {
+                        int feature = samples[i].features[side][j];
+                        if (feature % options.threads != thread)
+                            continue;
+
+                        if (!touched[feature]) {
+                            touched[feature] = true;
+                            rows.push_back(feature);
+                        }
+                        AddRow(model.featureWeights.gradients.data() + (size_t) feature * hiddenSize, GetAccumulatorGradient(i, side));
+                    }
+                }
+            }
+
+            for (int feature : rows) {
+                AdamUpdate(model.featureWeights, (size_t) feature * hiddenSize, hiddenSize, stepSize, maxFeatureWeight);
+                touched[feature] = false;
+            }
+            rows.clear();
+        });
+
+        double loss = 0;
+        for (auto& gradients : threadGradients) {
+            for (int i = 0; i < 2 * hiddenSize; i++)
+                model.outputWeights.gradients[i] += gradients.outputWeights[i];
+            for (int i = 0; i < hiddenSize; i++)
+                model.featureBiases.gradients[i] += gradients.featureBiases[i];
+            model.outputBias.gradients[0] += gradients.outputBias;
+            loss += gradients.loss;
+        }
+
+        AdamUpdate(model.featureBiases, 0, hiddenSize, stepSize, maxFeatureWeight);
+        AdamUpdate(model.outputWeights, 0, 2 * hiddenSize, stepSize, maxOutputWeight);
+        AdamUpdate(model.outputBias, 0, width, stepSize, 1e6f);
+        return loss;
+    }
+
+    /* In centipawns , from the side to move's point of view. */
+    float Predict(const Sample& sample) const {
+        float accumulators[2][hiddenSize];
+        return Forward(model, sample, accumulators) * evalScale;
+    }
+
+    /* The weights in the format the engine loads. */
+    Network Quantize() const {
+        auto round = [](float value, float scale, float limit) { return std::clamp(std::round(value * scale), -limit, limit); };
+
+        Network network;
+        for (float weight : model.featureBiases.values)
+            network.featureBiases.push_back((int16_t) round(weight, activationScale, 32767));
+        for (float weight : model.featureWeights.values)
+            network.featureWeights.push_back((int16_t) round(weight, activationScale, 32767));
+        for (float weight : model.outputWeights.values)
+            network.outputWeights.push_back((int8_t) round(weight, weightScale, 127));
+        network.outputBias = (int32_t) std::round(model.outputBias.values[0] * activationScale * weightScale);
+        return network;
+    }
+
+private:
+    float* GetAccumulatorGradient(size_t sample, int side) {
+        return accumulatorGradients.data() + (sample * 2 + side) * hiddenSize;
+    }
+
+    TrainingOptions options;
+    Model model;
+    int step = 0;
+
+    std::vector<ThreadGradients> threadGradients;
+    std::vector<std::vector<int>> touchedRows;
+    std::vector<uint8_t> touched; // Rows of different threads are different bytes , no races.
+    std::vector<float> accumulatorGradients; // [sample][side][hiddenSize] of the current batch.
+};
+
+/*******************************************************/
+/* Positions                                           */
+/*******************************************************/
+
+static bool ParseLine(const std::string& line, BoardState& state, int& score) {
+    size_t separator = line.find(';');
+    if (separator == std::string::npos || !ParseFenString(line.substr(0, separator), state))
+        return false;
+
+    try {
+        score = std::stoi(line.substr(separator + 1));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+static Sample ToSample(const BoardState& state, int score) {
+    Sample sample;
+    int features[2][maxActiveFeatures];
+    sample.count = (uint8_t) GetActiveFeatures(state, state.turnOf, features[0]);
+    GetActiveFeatures(state, InvertColor(state.turnOf), features[1]);
+    for (int side = 0; side < 2; side++)
+        for (int i = 0; i < sample.count; i++)
+            sample.features[side][i] = (uint16_t) features[side][i];
+
+    sample.target = Sigmoid((float) score / evalScale);
+    return sample;
+}
+
+/* Reads the next chunkPositions lines and parses them on every thread , bad lines are counted and dropped.
+ * Returns false when there is nothing left. */
+static bool ReadChunk(std::ifstream& file, int threads, std::vector<Sample>& samples, size_t& skipped) {
+    std::vector<std::string> lines;
+    std::string line;
+    while (lines.size() < chunkPositions && std::getline(file, line)) {
+        if (!line.empty() && line[0] != '#')
+            lines.push_back(line);
+    }
+    if (lines.empty())
+        return false;
+
+    std::vector<Sample> parsed(lines.size());
+    std::vector<uint8_t> valid(lines.size());
+    RunThreads(threads, [&](int thread) {
+        for (size_t i = thread; i < lines.size(); i += threads) {
+            BoardState state = {};
+            int score = 0;
+            valid[i] = ParseLine(lines[i], state, score);
+            if (valid[i])
+                parsed[i] = ToSample(state, score);
+        }
+    });
+
+    samples.clear();
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (valid[i])
+            samples.push_back(parsed[i]);
+        else
+            skipped++;
+    }
+    return true;
+}
+
+/* Loads the saved network into the engine and compares its evaluations with the float network
+ * on the first positions of the file. */
+static void PrintQuantizationError(const Trainer& trainer, const std::string& positionsPath, const std::string& networkPath) {
+    if (!LoadNetwork(networkPath)) {
+        std::cout << "Could not load " << networkPath << std::endl;
+        return;
+    }
+
+    std::ifstream file(positionsPath);
+    std::string line;
+    double totalError = 0;
+    int count = 0;
+    while (count < 1000 && std::getline(file, line)) {
+        BoardState state = {};
+        int score = 0;
+        if (line.empty() || line[0] == '#' || !ParseLine(line, state, score))
+            continue;
+
+        totalError += std::abs(trainer.Predict(ToSample(state, score)) - (float) Evaluate(state));
+        count++;
+    }
+    ClearNetwork();
+
+    std::cout << "quantization error " << std::fixed << std::setprecision(2) << totalError / std::max(count, 1)
+              << " cp on average over " << count << " positions" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cout << "Usage : Trainer <positions file> <network file> [epochs] [threads] [batch size] [learning rate]" << std::endl;
+        return -1;
+    }
+
+    std::string positionsPath = argv[1];
+    std::string networkPath = argv[2];
+    TrainingOptions options;
+    options.threads = (int) std::max(std::thread::hardware_concurrency(), 1u);
+    if (argc > 3)
+        options.epochs = std::stoi(argv[3]);
+    if (argc > 4)
+        options.threads = std::max(std::stoi(argv[4]), 1);
+    if (argc > 5)
+        options.batchSize = std::max<size_t>(std::stoull(argv[5]), 1);
+    if (argc > 6)
+        options.learningRate = std::stof(argv[6]);
+
+    std::ifstream file(positionsPath);
+    if (!file) {
+        std::cout << "Could not read " << positionsPath << std::endl;
+        return -1;
+    }
+
+    ChessEngine::Init();
+
+    std::cout << options.threads << " threads , batch size " << options.batchSize << " , learning rate "
+              << options.learningRate << " , " << width << " floats per vector" << std::endl;
+    std::cout << std::left << std::setw(8) << "epoch" << std::setw(12) << "positions" << std::setw(12) << "loss"
+              << std::setw(10) << "ms" << "positions/sec" << std::endl;
+
+    Trainer trainer(options);
+    std::vector<Sample> samples;
+    bool singleChunk = false; // The whole file fits in one chunk , it is kept instead of read again.
+    std::mt19937_64 random(0);
+    for (int epoch = 1; epoch <= options.epochs; epoch++) {
+        auto start = std::chrono::steady_clock::now();
+        size_t positions = 0, skipped = 0, chunks = 0;
+        double loss = 0;
+
+        if (!singleChunk) {
+            file.clear();
+            file.seekg(0);
+        }
+
+        while (singleChunk || ReadChunk(file, options.threads, samples, skipped)) {
+            chunks++;
+            std::shuffle(samples.begin(), samples.end(), random);
+            for (size_t first = 0; first < samples.size(); first += options.batchSize) {
+                size_t count = std::min(options.batchSize, samples.size() - first);
+                loss += trainer.TrainBatch(samples.data() + first, count);
+            }
+            positions += samples.size();
+
+            if (singleChunk)
+                break;
+        }
+
+        if (epoch == 1) {
+            if (positions == 0) {
+                std::cout << "No positions in " << positionsPath << " (" << skipped << " lines skipped)" << std::endl;
+                return -1;
+            }
+            if (skipped != 0)
+                std::cout << skipped << " lines skipped" << std::endl;
+            singleChunk = chunks == 1;
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+        // A checkpoint after every epoch.
+        if (!SaveNetwork(networkPath, trainer.Quantize())) {
+            std::cout << "Could not write " << networkPath << std::endl;
+            return -1;
+        }
+
+        std::cout << std::left << std::setw(8) << epoch << std::setw(12) << positions << std::setw(12)
+                  << std::fixed << std::setprecision(6) << loss / (double) positions << std::setw(10) << ms
+                  << positions * 1000 / (ms + 1) << std::endl;
+    }
+
+    PrintQuantizationError(trainer, positionsPath, networkPath);
+    return 0;
+}
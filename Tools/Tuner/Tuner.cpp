@@ -0,0 +1,379 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+#include <Engine/FenParser/FenParser.h>
+#include <Engine/Evaluation/Evaluation.h>
+#include <Engine/Evaluation/PieceSquare.h>
+#include <Engine/Evaluation/Tuning.h>
+
+using namespace ChessEngine;
+using namespace ChessEngine::Evaluation::Tuning;
+
+/* Texel tuning of the hand written evaluation. Each line of the positions file is a fen followed by ";" and the
+ * game result from White's point of view (1-0 , 0-1 , 1/2-1/2 or 1 , 0 , 0.5). The positions are loaded once
+ * as the coefficients of the evaluation parameters , every pass computes the error and its exact gradient
+ * from them on all threads and takes an Adam step. */
+
+constexpr size_t chunkLines = 1 << 20;
+
+struct TuningOptions {
+    int passes = 500;
+    int threads = 1;
+    double learningRate = 1.0; // Centipawns.
+};
+
+/* A position as the range of its coefficients in the shared array. */
+struct Position {
+    uint32_t first = 0;
+    uint8_t count = 0;
+    uint8_t phase = 0;
+    float result = 0;
+};
+
+struct Dataset {
+    std::vector<Position> positions;
+    std::vector<Coefficient> coefficients;
+};
+
+template<typename Function>
+static void RunThreads(int threads, Function function) {
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++)
+        workers.emplace_back(function, i);
+    for (auto& worker : workers)
+        worker.join();
+}
+
+/*******************************************************/
+/* Loading                                             */
+/*******************************************************/
+
+static bool ParseResult(const std::string& text, float& result) {
+    if (text.find("1/2") != std::string::npos)
+        result = 0.5f;
+    else if (text.find("1-0") != std::string::npos)
+        result = 1.0f;
+    else if (text.find("0-1") != std::string::npos)
+        result = 0.0f;
+    else {
+        try {
+            result = std::stof(text);
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return result >= 0 && result <= 1;
+}
+
+/* Per thread results of parsing a chunk , merged in thread order. */
+struct ParsedChunk {
+    Dataset data;
+    size_t skipped = 0; // Bad lines , insufficient material and known endgames.
+    size_t mismatches = 0; // Positions where the coefficients don't give the evaluation.
+};
+
+static void ParseLines(const std::vector<std::string>& lines, size_t first, size_t last,
+                       const std::vector<Parameter>& parameters, ParsedChunk& chunk) {
+    for (size_t i = first; i < last; i++) {
+        const std::string& line = lines[i];
+        size_t separator = line.find(';');
+        BoardState state = {};
+        Position position;
+        if (separator == std::string::npos || !ParseFenString(line.substr(0, separator), state) ||
+            !ParseResult(line.substr(separator + 1), position.result)) {
+            chunk.skipped++;
+            continue;
+        }
+
+        position.first = (uint32_t) chunk.data.coefficients.size();
+        if (!GetCoefficients(state, chunk.data.coefficients)) {
+            chunk.skipped++;
+            continue;
+        }
+        position.count = (uint8_t) (chunk.data.coefficients.size() - position.first);
+        position.phase = (uint8_t) GetPhase(state);
+
+        // The coefficients with the current values should give back the evaluation , up to rounding.
+        double midgame = 0, endgame = 0;
+        for (size_t j = position.first; j < chunk.data.coefficients.size(); j++) {
+            const Coefficient& coefficient = chunk.data.coefficients[j];
+            midgame += coefficient.count * parameters[coefficient.index].midgame;
+            endgame += coefficient.count * parameters[coefficient.index].endgame;
+        }
+        double linear = (midgame * position.phase + endgame * (Evaluation::maxPhase - position.phase)) / Evaluation::maxPhase;
+        int evaluation = Evaluation::Evaluate(state);
+        if (state.turnOf == Color::Black)
+            evaluation = -evaluation;
+        if (std::abs(linear - evaluation) > 1.5)
+            chunk.mismatches++;
+
+        chunk.data.positions.push_back(position);
+    }
+}
+
+static bool LoadPositions(const std::string& path, int threads, const std::vector<Parameter>& parameters,
+                          Dataset& data, size_t& skipped, size_t& mismatches) {
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    std::vector<std::string> lines;
+    std::string line;
+    while (true) {
+        lines.clear();
+        while (lines.size() < chunkLines && std::getline(file, line)) {
+            if (!line.empty() && line[0] != '#')
+                lines.push_back(line);
+        }
+        if (lines.empty())
+            break;
+
+        std::vector<ParsedChunk> chunks(threads);
+        RunThreads(threads, [&](int thread) {
+            ParseLines(lines, lines.size() * thread / threads, lines.size() * (thread + 1) / threads, parameters, chunks[thread]);
+        });
+
+        for (auto& chunk : chunks) {
+            uint32_t offset = (uint32_t) data.coefficients.size();
+            for (auto position : chunk.data.positions) {
+                position.first += offset;
+                data.positions.push_back(position);
+            }
+            data.coefficients.insert(data.coefficients.end(), chunk.data.coefficients.begin(), chunk.data.coefficients.end());
+            skipped += chunk.skipped;
+            mismatches += chunk.mismatches;
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************/
+/* Error and gradient                                  */
+/*******************************************************/
+
+/* Midgame and endgame value of every parameter , an untapered one keeps both equal. */
+struct Weights {
+    std::vector<double> midgame, endgame;
+};
+
+static double Sigmoid(double k, double score) {
+    return 1.0 / (1.0 + std::exp(-k * score / 400.0));
+}
+
+static double GetScore(const Dataset& data, const Position& position, const Weights& weights) {
+    double midgame = 0, endgame = 0;
+    for (uint32_t i = position.first; i < position.first + position.count; i++) {
+        const Coefficient& coefficient = data.coefficients[i];
+        midgame += coefficient.count * weights.midgame[coefficient.index];
+        endgame += coefficient.count * weights.endgame[coefficient.index];
+    }
+    return (midgame * position.phase + endgame * (Evaluation::maxPhase - position.phase)) / Evaluation::maxPhase;
+}
+
+/* Mean squared error between the results and the win probabilities of the scores. When gradient
+ * isn't null it gets the gradient of the error for every midgame and endgame value. */
+static double ComputeError(const Dataset& data, const Weights& weights, double k, int threads, Weights* gradient) {
+    size_t parameterCount = weights.midgame.size();
+    std::vector<double> errors(threads);
+    std::vector<Weights> gradients(threads);
+
+    RunThreads(threads, [&](int thread) {
+        Weights& local = gradients[thread];
+        if (gradient) {
+            local.midgame.assign(parameterCount, 0.0);
+            local.endgame.assign(parameterCount, 0.0);
+        }
+
+        size_t first = data.positions.size() * thread / threads;
+        size_t last = data.positions.size() * (thread + 1) / threads;
+        double error = 0;
+        for (size_t i = first; i < last; i++) {
+            const Position& position = data.positions[i];
+            double probability = Sigmoid(k, GetScore(data, position, weights));
+            double difference = position.result - probability;
+            error += difference * difference;
+            if (!gradient)
+                continue;
+
+            // d error / d score , the score is linear in every value.
+            double scoreGradient = -2.0 * difference * probability * (1 - probability) * k / 400.0;
+            double midgameShare = scoreGradient * position.phase / Evaluation::maxPhase;
+            double endgameShare = scoreGradient - midgameShare;
+            for (uint32_t j = position.first; j < position.first + position.count; j++) {
+                const Coefficient& coefficient = data.coefficients[j];
+                local.midgame[coefficient.index] += coefficient.count * midgameShare;
+                local.endgame[coefficient.index] += coefficient.count * endgameShare;
+            }
+        }
+        errors[thread] = error;
+    });
+
+    double error = 0;
+    for (double threadError : errors)
+        error += threadError;
+
+    double count = (double) data.positions.size();
+    if (gradient) {
+        gradient->midgame.assign(parameterCount, 0.0);
+        gradient->endgame.assign(parameterCount, 0.0);
+        for (auto& local : gradients) {
+            for (size_t i = 0; i < parameterCount; i++) {
+                gradient->midgame[i] += local.midgame[i] / count;
+                gradient->endgame[i] += local.endgame[i] / count;
+            }
+        }
+    }
+    return error / count;
+}
+
+/* The scaling of scores to win probabilities that fits the data best with the current values ,
+ * the error is convex enough in k for a ternary search. */
+static double FitScaling(const Dataset& data, const Weights& weights, int threads) {
+    double low = 0.1, high = 4.0;
+    for (int i = 0; i < 40; i++) {
+        double first = low + (high - low) / 3, second = high - (high - low) / 3;
+        if (ComputeError(data, weights, first, threads, nullptr) < ComputeError(data, weights, second, threads, nullptr))
+            high = second;
+        else
+            low = first;
+    }
+    return (low + high) / 2;
+}
+
+/*******************************************************/
+/* Output                                              */
+/*******************************************************/
+
+static void PrintValues(const std::vector<double>& values, size_t first, size_t last) {
+    bool table = last - first == 64;
+    std::cout << (last - first > 1 ? "{" : "");
+    for (size_t i = first; i < last; i++) {
+        if (table && (i - first) % 8 == 0)
+            std::cout << std::endl << "    ";
+        else if (i != first)
+            std::cout << " ";
+        std::cout << std::lround(values[i]) << (i + 1 < last ? "," : "");
+    }
+    std::cout << (table ? "\n" : "") << (last - first > 1 ? "}" : "") << std::endl;
+}
+
+/* The tuned values grouped by the constants of the source. */
+static void PrintParameters(const std::vector<Parameter>& parameters, const Weights& weights) {
+    size_t first = 0;
+    while (first < parameters.size()) {
+        size_t last = first;
+        while (last < parameters.size() && parameters[last].group == parameters[first].group)
+            last++;
+
+        if (parameters[first].tapered) {
+            std::cout << parameters[first].group << " midgame = ";
+            PrintValues(weights.midgame, first, last);
+            std::cout << parameters[first].group << " endgame = ";
+            PrintValues(weights.endgame, first, last);
+        } else {
+            std::cout << parameters[first].group << " = ";
+            PrintValues(weights.midgame, first, last);
+        }
+        first = last;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage : Tuner <positions file> [passes] [threads] [learning rate]" << std::endl;
+        return -1;
+    }
+
+    TuningOptions options;
+    options.threads = (int) std::max(std::thread::hardware_concurrency(), 1u);
+    if (argc > 2)
+        options.passes = std::stoi(argv[2]);
+    if (argc > 3)
+        options.threads = std::max(std::stoi(argv[3]), 1);
+    if (argc > 4)
+        options.learningRate = std::stod(argv[4]);
+
+    ChessEngine::Init();
+
+    std::vector<Parameter> parameters = GetParameters();
+
+    Dataset data;
+    size_t skipped = 0, mismatches = 0;
+    auto loadStart = std::chrono::steady_clock::now();
+    if (!LoadPositions(argv[1], options.threads, parameters, data, skipped, mismatches)) {
+        std::cout << "Could not read " << argv[1] << std::endl;
+        return -1;
+    }
+    auto loadEnd = std::chrono::steady_clock::now();
+    if (data.positions.empty()) {
+        std::cout << "No positions to tune on (" << skipped << " skipped)" << std::endl;
+        return -1;
+    }
+
+    std::cout << data.positions.size() << " positions (" << skipped << " skipped) , "
+              << data.coefficients.size() * sizeof(Coefficient) / data.positions.size() + sizeof(Position)
+              << " bytes each , loaded in " << std::chrono::duration_cast<std::chrono::milliseconds>(loadEnd - loadStart).count()
+              << " ms" << std::endl;
+    std::cout << parameters.size() << " parameters , " << mismatches << " positions where they don't give the evaluation" << std::endl;
+
+    Weights weights;
+    for (auto& parameter : parameters) {
+        weights.midgame.push_back(parameter.midgame);
+        weights.endgame.push_back(parameter.endgame);
+    }
+
+    double k = FitScaling(data, weights, options.threads);
+    double startError = ComputeError(data, weights, k, options.threads, nullptr);
+    std::cout << "scaling " << std::fixed << std::setprecision(4) << k << " , error " << std::setprecision(6) << startError << std::endl;
+
+    // Adam , untapered parameters take the sum of both gradients and keep their values equal.
+    constexpr double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+    size_t count = parameters.size();
+    Weights m{std::vector<double>(count), std::vector<double>(count)};
+    Weights v{std::vector<double>(count), std::vector<double>(count)};
+    Weights gradient;
+
+    std::cout << std::left << std::setw(8) << "pass" << std::setw(12) << "error" << std::setw(10) << "ms/pass" << "positions/sec" << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    double error = startError;
+    for (int pass = 1; pass <= options.passes; pass++) {
+        error = ComputeError(data, weights, k, options.threads, &gradient);
+
+        double stepSize = options.learningRate * std::sqrt(1 - std::pow(beta2, pass)) / (1 - std::pow(beta1, pass));
+        for (size_t i = 0; i < count; i++) {
+            if (!parameters[i].tapered) {
+                gradient.midgame[i] += gradient.endgame[i];
+                gradient.endgame[i] = gradient.midgame[i];
+            }
+
+            for (int half = 0; half < 2; half++) {
+                double& value = half ? weights.endgame[i] : weights.midgame[i];
+                double g = half ? gradient.endgame[i] : gradient.midgame[i];
+                double& first = half ? m.endgame[i] : m.midgame[i];
+                double& second = half ? v.endgame[i] : v.midgame[i];
+                first = beta1 * first + (1 - beta1) * g;
+                second = beta2 * second + (1 - beta2) * g * g;
+                value -= stepSize * first / (std::sqrt(second) + epsilon);
+            }
+        }
+
+        if (pass % 10 == 0 || pass == options.passes) {
+            auto now = std::chrono::steady_clock::now();
+            int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
+            std::cout << std::left << std::setw(8) << pass << std::setw(12) << std::setprecision(6) << error
+                      << std::setw(10) << ms / pass << (int64_t) data.positions.size() * pass * 1000 / (ms + 1) << std::endl;
+        }
+    }
+
+    std::cout << std::endl << "error " << startError << " -> " << ComputeError(data, weights, k, options.threads, nullptr) << std::endl << std::endl;
+    PrintParameters(parameters, weights);
+    return 0;
+}
@@ -11,6 +11,12 @@ constexpr int frameLimit = 120;
 
 constexpr float moveTime = 0.025f;
 
+constexpr float clockTime = 300.0f;
+constexpr float clockIncrement = 2.0f;
+
+constexpr ChessFrontend::AIType whiteAIType = ChessFrontend::AIType::AlphaBeta;
+constexpr ChessFrontend::AIType blackAIType = ChessFrontend::AIType::AlphaBeta;
+
 std::string ArgumentToString(int argc, char* argv[]){
     std::string temp;
     for (int i = 1; i < argc; i++) {
@@ -34,7 +40,7 @@ int main(int argc, char* argv[]) {
     }
 
     ChessFrontend::WindowSettings windowSettings(height, width, frameLimit, "Chess");
-    ChessFrontend::Options options(false, false, moveTime, false, ChessEngine::Color::White, windowSettings);
+    ChessFrontend::Options options(false, false, whiteAIType, blackAIType, moveTime, clockTime, clockIncrement, false, ChessEngine::Color::White, windowSettings);
     ChessFrontend::Game game(state, options);
 
     sf::Clock deltaClock;